@@ -0,0 +1,23 @@
+# Fails the build when a firmware image does not fit its flash region, and
+# warns when it leaves less than RESERVE bytes free.
+#
+#   cmake -DIMAGE=<file.bin> -DLIMIT=<bytes> [-DRESERVE=<bytes>]
+#         [-DRESERVE_FOR=<what>] -P CheckImageSize.cmake
+
+# file(SIZE) needs CMake 3.14; the hex dump works on 3.7.
+file(READ ${IMAGE} image HEX)
+string(LENGTH "${image}" size)
+math(EXPR size "${size} / 2")
+math(EXPR free "${LIMIT} - ${size}")
+
+if(size GREATER LIMIT)
+  message(FATAL_ERROR
+    "${IMAGE}: ${size} bytes, ${LIMIT} byte flash budget exceeded")
+endif()
+
+message(STATUS "${IMAGE}: ${size} bytes, ${free} bytes of flash free")
+
+if(DEFINED RESERVE AND free LESS RESERVE)
+  message(WARNING
+    "${IMAGE}: only ${free} bytes free, ${RESERVE} needed for ${RESERVE_FOR}")
+endif()
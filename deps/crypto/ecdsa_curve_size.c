@@ -0,0 +1,25 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2024 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ecdsa.h"
+
+// lib/firmware/crypto.c checks the same size from the firmware side, so a
+// USE_PRECOMPUTED_CP that differs between the two fails to compile.
+_Static_assert(sizeof(ecdsa_curve) == KK_ECDSA_CURVE_SIZE,
+               "trezor-crypto built with a different USE_PRECOMPUTED_CP");
@@ -0,0 +1,33 @@
+extern "C" {
+#include "keepkey/firmware/psbt.h"
+}
+
+#include <stddef.h>
+#include <stdint.h>
+
+static bool on_value(void *ctx, const PsbtRecord *record, uint32_t offset,
+                     const uint8_t *data, size_t len) {
+  (void)ctx;
+  (void)record;
+  (void)offset;
+  asm volatile("" : : "g"(data), "g"(len) : "memory");
+  return true;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static const PsbtCallbacks callbacks = {on_value, nullptr, nullptr};
+  static PsbtParser parser;
+
+  // Feed the input in uneven chunks so that every state sees a boundary
+  psbt_init(&parser, &callbacks, nullptr);
+  size_t pos = 0, chunk = 1;
+  while (pos < size) {
+    size_t len = size - pos < chunk ? size - pos : chunk;
+    if (!psbt_update(&parser, data + pos, len)) break;
+    pos += len;
+    chunk = chunk * 3 % 17 + 1;
+  }
+  asm volatile("" : : "g"(&parser) : "memory");
+
+  return 0;
+}
@@ -0,0 +1,14 @@
+extern "C" {
+#include "keepkey/firmware/thorchain_memo.h"
+}
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  ThorchainMemo memo;
+  thorchain_memoParse((const char *)data, size, &memo);
+  asm volatile("" : : "g"(&memo) : "memory");
+
+  return 0;
+}
@@ -23,6 +23,7 @@
 
 #include "keepkey/transport/interface.h"
 #include "keepkey/board/layout.h"
+#include "keepkey/board/timer.h"
 
 #include <stdbool.h>
 
@@ -87,6 +88,16 @@ typedef struct {
 typedef void (*layout_notification_t)(const char *str1, const char *str2,
                                       NotificationType type);
 
+/// Runs \p work once while the next confirmation waits for the user, after
+/// its first screen is drawn. Dropped if that confirmation returns first.
+///
+/// \p work runs synchronously inside the confirmation loop: the screen does
+/// not animate and Cancel / Initialize are not read from USB until it
+/// returns. Button presses are latched by the button interrupt and handled
+/// right after. Keep it to a single bounded computation, such as the one
+/// ECDSA signature cryptoPresignDigest computes.
+void confirm_setIdleWork(callback_func_t work);
+
 /// User confirmation.
 /// \param type            The kind of button request to send to the host.
 /// \param request_title   Title of confirm message.
@@ -41,10 +41,33 @@ typedef struct {
   uint16_t width;
 } BoxDrawableParams;
 
+/// A single character of a TextLayout, positioned on the canvas.
+typedef struct {
+  char c;
+  uint8_t x;
+  uint8_t y;
+} PlacedGlyph;
+
+/// Word-wrapped string, laid out once by text_layout_build() and blitted
+/// any number of times by text_layout_draw(). The caller provides room for
+/// \p capacity glyphs, one per character drawn.
+typedef struct {
+  const Font *font;
+  uint16_t count;
+  uint16_t capacity;
+  PlacedGlyph *glyphs;
+} TextLayout;
+
 bool draw_char_with_shift(Canvas *canvas, DrawableParams *p, uint16_t *x_shift,
                           uint16_t *y_shift, const CharacterImage *img);
 void draw_string(Canvas *canvas, const Font *font, const char *c,
                  DrawableParams *p, uint16_t width, uint16_t line_height);
+bool text_layout_build(TextLayout *layout, const Canvas *canvas,
+                       const Font *font, const char *str,
+                       const DrawableParams *p, uint16_t width,
+                       uint16_t line_height);
+void text_layout_draw(Canvas *canvas, const TextLayout *layout,
+                      uint8_t color);
 void draw_char(Canvas *canvas, const Font *font, char c, DrawableParams *p);
 void draw_char_simple(Canvas *canvas, const Font *font, char c, uint8_t color,
                       uint16_t x, uint16_t y);
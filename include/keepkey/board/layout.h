@@ -109,6 +109,7 @@ void layout_standard_notification(const char *str1, const char *str2,
                                   NotificationType type);
 void layout_constant_power_notification(const char *str1, const char *str2, NotificationType type);
 void layout_notification_icon(NotificationType type, DrawableParams *sp);
+void layout_notification_cache_clear(void);
 void layout_add_icon(IconType type);
 void layout_warning(const char *prompt);
 void layout_warning_static(const char *str);
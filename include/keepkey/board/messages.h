@@ -60,6 +60,7 @@
 typedef void (*msg_handler_t)(void *ptr);
 typedef void (*msg_failure_t)(FailureType, const char *);
 typedef bool (*usb_tx_handler_t)(uint8_t *, uint32_t);
+typedef void (*msg_write_hook_t)(MessageType, const void *);
 
 #if DEBUG_LINK
 typedef void (*msg_debug_link_get_state_t)(DebugLinkGetState *);
@@ -104,12 +105,19 @@ const pb_field_t *message_fields(MessageMapType type, MessageType msg_id,
 
 bool msg_write(MessageType msg_id, const void *msg);
 
+#ifdef EMULATOR
+/// Sees every message before msg_write sends it, so that the unit tests can
+/// check what the firmware answers.
+void set_msg_write_hook(msg_write_hook_t hook);
+#endif
+
 #if DEBUG_LINK
 bool msg_debug_write(MessageType msg_id, const void *msg);
 #endif
 
 void msg_map_init(const void *map, const size_t size);
 void set_msg_failure_handler(msg_failure_t failure_func);
+void usb_rx_reset(void);
 void call_msg_failure_handler(FailureType code, const char *text);
 
 #if DEBUG_LINK
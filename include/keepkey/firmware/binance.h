@@ -12,10 +12,31 @@ typedef struct _BinanceTransferMsg BinanceTransferMsg;
 typedef struct _BinanceTransferMsg_BinanceInputOutput BinanceInputOutput;
 typedef struct _BinanceTransferMsg_BinanceCoin BinanceCoin;
 
+/// Distinct denoms a single transfer may move.
+#define BINANCE_TRANSFER_DENOMS 4
+
 bool binance_signTxInit(const HDNode *node, const BinanceSignTx *msg);
 bool binance_serializeCoin(const BinanceCoin *coin);
 bool binance_serializeInputOutput(const BinanceInputOutput *io);
 bool binance_signTxUpdateTransfer(const BinanceTransferMsg *msg);
+
+/// \returns the address of the signing key, or NULL on failure.
+const char *binance_signerAddress(void);
+
+/// Streams one transfer input into the signed JSON. The input must spend
+/// from binance_signerAddress(), and every input of a transfer must be added
+/// before its first output.
+bool binance_signTxTransferInput(const BinanceInputOutput *io);
+
+/// Streams one transfer output into the signed JSON.
+bool binance_signTxTransferOutput(const BinanceInputOutput *io);
+
+/// \returns true iff the outputs streamed so far spend exactly the inputs,
+/// per denom.
+bool binance_signTxTransferIsBalanced(void);
+
+/// Closes a balanced transfer and counts it against msg_count.
+bool binance_signTxTransferEnd(void);
 bool binance_signTxUpdateMsgSend(const uint64_t amount, const char *to_address);
 bool binance_signTxFinalize(uint8_t *public_key, uint8_t *signature);
 bool binance_signingIsInited(void);
@@ -0,0 +1,99 @@
+#ifndef KEEPKEY_FIRMWARE_COSMOSDIRECT_H
+#define KEEPKEY_FIRMWARE_COSMOSDIRECT_H
+
+#include "trezor/crypto/bip32.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Largest piece of a top level TxBody / AuthInfo field that is buffered for
+ * display. Longer fields are handed to the review callback in pieces.
+ */
+#define COSMOS_DIRECT_FIELD_MAX 1024
+
+/** Top level fields handed to the review callback. */
+typedef enum {
+  CosmosDirectField_Message,  // TxBody.messages (google.protobuf.Any)
+  CosmosDirectField_Memo,     // TxBody.memo
+  CosmosDirectField_Fee,      // AuthInfo.fee
+} CosmosDirectField;
+
+/**
+ * Called for each displayable field as its bytes are streamed in. Fields
+ * of up to COSMOS_DIRECT_FIELD_MAX bytes arrive in a single call, with
+ * \p offset 0 and \p len equal to \p total. Longer fields arrive as
+ * consecutive pieces of at most COSMOS_DIRECT_FIELD_MAX bytes, so they can
+ * be paged through on the display. \p data is only valid for the duration
+ * of the call.
+ *
+ * \returns false to abort signing
+ */
+typedef bool (*CosmosDirectReviewFn)(CosmosDirectField field, uint32_t offset,
+                                     uint32_t total, const uint8_t *data,
+                                     size_t len);
+
+typedef struct {
+  const char *type_url;
+  size_t type_url_len;
+  const uint8_t *value;
+  size_t value_len;
+} CosmosDirectAny;
+
+typedef struct {
+  const char *denom;
+  size_t denom_len;
+  const char *amount;
+  size_t amount_len;
+  uint32_t coin_count;
+  uint64_t gas_limit;
+} CosmosDirectFee;
+
+/**
+ * Starts a SIGN_MODE_DIRECT session. The SignDoc is hashed as it is
+ * received: body_bytes and auth_info_bytes are streamed in order through
+ * cosmos_directUpdateBody / cosmos_directUpdateAuthInfo and must add up to
+ * the declared lengths.
+ */
+bool cosmos_directInit(const HDNode *node, uint32_t body_len,
+                       uint32_t auth_info_len, const char *chain_id,
+                       uint64_t account_number, CosmosDirectReviewFn review);
+
+bool cosmos_directUpdateBody(const uint8_t *data, size_t len);
+
+bool cosmos_directUpdateAuthInfo(const uint8_t *data, size_t len);
+
+/**
+ * \returns true iff all of body_bytes and auth_info_bytes have been received
+ */
+bool cosmos_directIsComplete(void);
+
+/**
+ * Signs the SignDoc digest and ends the session.
+ */
+bool cosmos_directFinalize(uint8_t *public_key, uint8_t *signature);
+
+/**
+ * Completes the SignDoc and writes its digest without signing.
+ */
+bool cosmos_directDigest(uint8_t hash[32]);
+
+bool cosmos_directIsInited(void);
+
+void cosmos_directAbort(void);
+
+/**
+ * Splits an encoded google.protobuf.Any into views of its fields.
+ */
+bool cosmos_directDecodeAny(const uint8_t *data, size_t len,
+                            CosmosDirectAny *any);
+
+/**
+ * Decodes the parts of an encoded cosmos.tx.v1beta1.Fee that are shown to
+ * the user: the first coin of the amount, the coin count and the gas limit.
+ */
+bool cosmos_directDecodeFee(const uint8_t *data, size_t len,
+                            CosmosDirectFee *fee);
+
+#endif
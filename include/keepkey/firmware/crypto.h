@@ -45,6 +45,31 @@ int gpgMessageSign(HDNode *node, const uint8_t *message, size_t message_len,
 int cryptoGetECDHSessionKey(const HDNode *node, const uint8_t *peer_public_key,
                             uint8_t *session_key);
 
+/// A signed message hashed as it arrives, so that its size is not bounded by
+/// a single protobuf. The length is part of the preimage, so it has to be
+/// known up front.
+typedef struct {
+  Hasher hasher;
+  uint32_t remaining;
+} CryptoMessageHasher;
+
+bool cryptoMessageHashInit(CryptoMessageHasher *ctx, const CoinType *coin,
+                           uint32_t message_len);
+
+/// \returns false if this would exceed the declared message length
+bool cryptoMessageHashUpdate(CryptoMessageHasher *ctx, const uint8_t *data,
+                             size_t len);
+
+/// \returns false unless exactly the declared message length was hashed
+bool cryptoMessageHashFinal(CryptoMessageHasher *ctx,
+                            uint8_t hash[HASHER_DIGEST_LENGTH]);
+
+int cryptoMessageSignDigest(HDNode *node, InputScriptType script_type,
+                            const uint8_t *hash, uint8_t *signature);
+
+int cryptoMessageVerifyDigest(const CoinType *coin, const uint8_t *hash,
+                              const char *address, const uint8_t *signature);
+
 int cryptoMessageSign(const CoinType *coin, HDNode *node,
                       InputScriptType script_type, const uint8_t *message,
                       size_t message_len, uint8_t *signature);
@@ -64,8 +89,17 @@ hmac_len, const uint8_t *privkey, uint8_t *msg, size_t *msg_len, bool
 *display_only, bool *signing, uint8_t *address_raw);
 */
 
+/// Cosigner xpubs whose derivations are remembered between calls to
+/// cryptoHDNodePathToPubkey. One slot per pubkey of the largest multisig, so
+/// the cosigners of a wallet never evict each other while its inputs are
+/// signed; at roughly 300 bytes an entry that is about 4.5KB of .bss, against
+/// a full path derivation per cosigner per input without it.
+#define CRYPTO_COSIGNER_CACHE_SIZE 15
+
 uint8_t *cryptoHDNodePathToPubkey(const CoinType *coin,
                                   const HDNodePathType *hdnodepath);
+/// Forgets the cosigner derivations kept by cryptoHDNodePathToPubkey.
+void cryptoCosignerCacheClear(void);
 int cryptoMultisigPubkeyIndex(const CoinType *coin,
                               const MultisigRedeemScriptType *multisig,
                               const uint8_t *pubkey);
@@ -73,4 +107,19 @@ int cryptoMultisigFingerprint(const MultisigRedeemScriptType *multisig,
                               uint8_t *hash);
 int cryptoIdentityFingerprint(const IdentityType *identity, uint8_t *hash);
 
+/// Computes the signature of \p digest while the next confirmation waits for
+/// the user, so that cryptoSignDigest only has to release it once confirmed.
+void cryptoPresignDigest(const ecdsa_curve *curve, const uint8_t *priv_key,
+                         const uint8_t *digest,
+                         int (*is_canonical)(uint8_t by, uint8_t sig[64]));
+
+/// ecdsa_sign_digest, returning the signature precomputed by
+/// cryptoPresignDigest when it was for the same key and digest.
+int cryptoSignDigest(const ecdsa_curve *curve, const uint8_t *priv_key,
+                     const uint8_t *digest, uint8_t *sig, uint8_t *pby,
+                     int (*is_canonical)(uint8_t by, uint8_t sig[64]));
+
+/// Forgets the key, digest and signature kept by cryptoPresignDigest.
+void cryptoPresignClear(void);
+
 #endif
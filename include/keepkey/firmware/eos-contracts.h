@@ -22,5 +22,6 @@
 
 #include "keepkey/firmware/eos-contracts/eosio.token.h"
 #include "keepkey/firmware/eos-contracts/eosio.system.h"
+#include "keepkey/firmware/eos-contracts/abi.h"
 
 #endif
@@ -0,0 +1,65 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2018 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPKEY_FIRMWARE_EOS_CONTRACTS_ABI_H
+#define KEEPKEY_FIRMWARE_EOS_CONTRACTS_ABI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define EOS_ABI_FIELDS_MAX 5
+
+typedef enum _EosAbiType {
+  EosAbi_Name,
+  EosAbi_Asset,
+  EosAbi_String,
+  EosAbi_Bool,
+  EosAbi_Uint32,
+  EosAbi_Int64,
+  EosAbi_NameVector,  // unique and sorted, e.g. voteproducer producers
+} EosAbiType;
+
+typedef struct _EosAbiField {
+  EosAbiType type;
+  const char *label;
+} EosAbiField;
+
+/// Serialized layout of one contract action's data, as in its ABI.
+typedef struct _EosAbiAction {
+  uint64_t account;
+  uint64_t name;
+  const char *title;
+  size_t field_count;
+  EosAbiField fields[EOS_ABI_FIELDS_MAX];
+} EosAbiAction;
+
+/// \returns the descriptor for account::name, or NULL if there is none.
+const EosAbiAction *eos_abiFind(uint64_t account, uint64_t name);
+
+/// \returns true iff data is exactly one well formed instance of abi.
+bool eos_abiValidate(const EosAbiAction *abi, const uint8_t *data,
+                     size_t len);
+
+/// Shows each field of the action data. Must only be called on data that
+/// passed eos_abiValidate.
+/// \returns true iff the user confirmed every screen.
+bool eos_abiConfirm(const EosAbiAction *abi, const uint8_t *data, size_t len);
+
+#endif
@@ -47,9 +47,13 @@ typedef enum _EosActionName {
   EOS_LinkAuth = 0x8ba7036b2d000000L,
   EOS_UnlinkAuth = 0xd4e2e9c0dacb4000L,
   EOS_NewAccount = 0x9ab864229a9e4000L,
+  EOS_Packed = 0xa991052400000000L,
 } EosActionName;
 
 typedef enum _EosContractName {
+  // The empty name, which cannot hold a contract. Together with the action
+  // name EOS_Packed it marks packed actions, see eos_isPackedActions.
+  EOS_PackedActions = 0,
   EOS_eosio = 0x5530ea0000000000L,
   EOS_eosio_token = 0x5530ea033482a600L,
 } EosContractName;
@@ -90,12 +94,31 @@ bool eos_hasActionUnknownDataRemaining(void);
 bool eos_compileActionUnknown(const EosActionCommon *common,
                               const EosActionUnknown *action);
 
+/// \returns true iff common explicitly marks an EosActionUnknown as packed
+/// actions: account and name set to EOS_PackedActions and EOS_Packed, and no
+/// authorization, since each packed action carries its own.
+bool eos_isPackedActions(const EosActionCommon *common);
+
+/// \brief Compile several serialized eosio::action, streamed across as many
+/// EosActionUnknown chunks as needed.
+///
+/// Each action is hashed as-is into the preimage, and confirmed from its
+/// authorization list and ABI descriptor in eos-contracts/abi.c once all of
+/// its bytes have arrived. Only actions with a descriptor may be packed.
+/// \returns true iff successful.
+bool eos_compileActionsPacked(const EosActionUnknown *action);
+
 /// \brief Append a u64 to the hash, with variable length encoding.
 /// \param hasher   If nonnull, the hasher to append to.
 /// \param val      The value to append.
 /// \returns the number of bytes hashed.
 size_t eos_hashUInt(Hasher *hasher, uint64_t val);
 
+/// \brief Read a u64 written by eos_hashUInt.
+/// \param data     Advanced past the value on success.
+/// \returns true iff a complete value was read before end.
+bool eos_decodeUInt(const uint8_t **data, const uint8_t *end, uint64_t *val);
+
 /// \returns true iff successful.
 bool eos_compileAsset(const EosAsset *asset);
 
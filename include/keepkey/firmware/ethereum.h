@@ -22,7 +22,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "keepkey/firmware/crypto.h"
 #include "trezor/crypto/bip32.h"
+#include "trezor/crypto/sha3.h"
 #include "messages-ethereum.pb.h"
 
 typedef struct _EthereumSignTx EthereumSignTx;
@@ -37,6 +39,11 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
                            bool needs_confirm);
 void ethereum_signing_abort(void);
 void ethereum_signing_txack(EthereumTxAck *msg);
+#ifdef EMULATOR
+/// Computes the signing hash of a transaction whose data is all in the
+/// initial chunk, without asking for confirmation. For the unit tests.
+bool ethereum_signing_txHash(EthereumSignTx *msg, uint8_t hash[32]);
+#endif
 void format_ethereum_address(const uint8_t *to, char *destination_str,
                              uint32_t destination_str_len);
 bool ethereum_isStandardERC20Transfer(const EthereumSignTx *msg);
@@ -58,6 +65,26 @@ bool ethereum_getStandardERC20Coin(const EthereumSignTx *msg, CoinType *coin);
  */
 uint32_t ethereum_get_decimal(const char *token_shortcut);
 
+/// An EIP-191 personal message hashed as it arrives. Like
+/// CryptoMessageHasher, the length has to be known up front.
+typedef struct {
+  struct SHA3_CTX ctx;
+  uint32_t remaining;
+} EthereumMessageHasher;
+
+void ethereum_message_hashInit(EthereumMessageHasher *ctx,
+                               uint32_t message_len);
+
+/// \returns false if this would exceed the declared message length
+bool ethereum_message_hashUpdate(EthereumMessageHasher *ctx,
+                                 const uint8_t *data, size_t len);
+
+/// \returns false unless exactly the declared message length was hashed
+bool ethereum_message_hashFinal(EthereumMessageHasher *ctx, uint8_t hash[32]);
+
+/// Starts signing \p msg while it is shown for confirmation.
+void ethereum_message_presign(const EthereumSignMessage *msg,
+                              const HDNode *node);
 void ethereum_message_sign(const EthereumSignMessage *msg, const HDNode *node,
                            EthereumMessageSignature *resp);
 int ethereum_message_verify(const EthereumVerifyMessage *msg);
@@ -65,6 +92,12 @@ int ethereum_message_verify(const EthereumVerifyMessage *msg);
 void ethereumFormatAmount(const bignum256 *amnt, const TokenType *token,
                           uint32_t chain_id, char *buf, int buflen);
 
+/// Formats a fixed point amount with \p decimals decimal places, producing
+/// the same string as bn_format(amnt, NULL, suffix, decimals, 0, false, ...).
+/// \returns the length of the formatted string, or 0 if it does not fit.
+size_t ethereum_formatFixedPoint(const bignum256 *amnt, const char *suffix,
+                                 uint32_t decimals, char *buf, size_t buflen);
+
 void bn_from_bytes(const uint8_t *value, size_t value_len, bignum256 *val);
 
 
@@ -22,7 +22,7 @@ const MayachainSignTx *mayachain_getMayachainSignTx(void);
 // Mayachain swap data parse and confirm
 //      input: 
 //          swapStr - string in mayachain swap format
-//          size - size of input string (must be <= 256)
+//          size - size of input buffer; parsing stops at the first NUL
 //      output:
 //          true if mayachain data parsed and confirmed by user, false otherwise
 bool mayachain_parseConfirmMemo(const char *swapStr, size_t size);
@@ -0,0 +1,27 @@
+#ifndef KEEPKEY_FIRMWARE_MERKLE_H
+#define KEEPKEY_FIRMWARE_MERKLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Depth of the largest tree a MerkleTree can hold. */
+#define MERKLE_LEVELS 16
+
+/**
+ * Bitcoin style (double SHA-256, last node of odd levels duplicated) Merkle
+ * tree, built as leaves arrive. Only the path to the rightmost leaf is kept.
+ */
+typedef struct {
+  uint32_t count;
+  uint8_t inner[MERKLE_LEVELS][32];
+} MerkleTree;
+
+void merkle_init(MerkleTree *tree);
+
+/** \returns false if the tree already has 2^MERKLE_LEVELS - 1 leaves */
+bool merkle_add(MerkleTree *tree, const uint8_t leaf[32]);
+
+/** \returns false if the tree is empty */
+bool merkle_root(const MerkleTree *tree, uint8_t root[32]);
+
+#endif
@@ -33,4 +33,11 @@ bool nano_currentHash(const NanoSignTx *msg, const HDNode *recip);
 bool nano_sanityCheck(const NanoSignTx *nano);
 bool nano_signTx(const NanoSignTx *msg, HDNode *node, NanoSignedTx *resp);
 
+/// \returns true iff the link_recipient_n public key is known already, and
+/// nano_currentHash may be called without deriving it.
+bool nano_recipientIsCached(const NanoSignTx *msg);
+
+/// Forgets the last signed block and recipient.
+void nano_clearCache(void);
+
 #endif
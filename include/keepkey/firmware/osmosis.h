@@ -72,4 +72,9 @@ bool osmosis_signingIsFinished(void);
 void osmosis_signAbort(void);
 const OsmosisSignTx *osmosis_getOsmosisSignTx(void);
 
+/**
+ * \returns the signer's address for the session's network, or NULL
+ */
+const char *osmosis_signerAddress(void);
+
 #endif
@@ -0,0 +1,118 @@
+#ifndef KEEPKEY_FIRMWARE_PSBT_H
+#define KEEPKEY_FIRMWARE_PSBT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Longest key kept in a PsbtRecord. Longer keys are truncated. */
+#define PSBT_KEY_MAX 80
+
+/** Longest output script of the unsigned transaction. */
+#define PSBT_SCRIPT_MAX 520
+
+#define PSBT_GLOBAL_UNSIGNED_TX 0x00
+#define PSBT_IN_NON_WITNESS_UTXO 0x00
+#define PSBT_IN_WITNESS_UTXO 0x01
+#define PSBT_IN_SIGHASH_TYPE 0x03
+#define PSBT_IN_BIP32_DERIVATION 0x06
+#define PSBT_OUT_BIP32_DERIVATION 0x02
+
+typedef enum {
+  PsbtMap_Global,
+  PsbtMap_Input,
+  PsbtMap_Output,
+} PsbtMap;
+
+/** A key-value pair, as far as it has been received. */
+typedef struct {
+  PsbtMap map;
+  uint32_t index;  // input / output index, 0 for the global map
+  uint8_t key[PSBT_KEY_MAX];
+  uint32_t key_len;  // full length, key[0] is the type
+  uint32_t value_len;
+} PsbtRecord;
+
+typedef struct {
+  /**
+   * Called for each piece of a value, in order. A value of length 0 gets a
+   * single call with len == 0.
+   */
+  bool (*value)(void *ctx, const PsbtRecord *record, uint32_t offset,
+                const uint8_t *data, size_t len);
+
+  /** Called for each input of the global unsigned transaction. */
+  bool (*tx_input)(void *ctx, uint32_t index, const uint8_t *prev_hash,
+                   uint32_t prev_index, uint32_t sequence);
+
+  /** Called for each output of the global unsigned transaction. */
+  bool (*tx_output)(void *ctx, uint32_t index, uint64_t amount,
+                    const uint8_t *script, uint32_t script_len);
+} PsbtCallbacks;
+
+typedef struct {
+  uint8_t size;  // bytes still expected, 0 before the first byte
+  uint8_t shift;
+  uint64_t value;
+} PsbtVarInt;
+
+/**
+ * Parses a BIP174 (version 0) PSBT as it arrives, in chunks of any size,
+ * without holding more than one key in RAM.
+ */
+typedef struct {
+  int state;
+  const char *error;
+  const PsbtCallbacks *callbacks;
+  void *ctx;
+
+  uint32_t magic_pos;
+  PsbtVarInt varint;
+  PsbtRecord record;
+  uint32_t key_pos;
+  uint32_t value_pos;
+
+  bool has_tx;
+  uint32_t inputs_count;
+  uint32_t outputs_count;
+
+  // Scanner of the unsigned transaction
+  int tx_state;
+  uint32_t tx_pos;
+  uint32_t tx_index;
+  uint32_t tx_len;
+  uint8_t tx_buf[32];
+  uint64_t tx_amount;
+  uint32_t tx_prev_index;
+  uint8_t tx_script[PSBT_SCRIPT_MAX];
+  uint32_t version;
+  uint32_t lock_time;
+} PsbtParser;
+
+void psbt_init(PsbtParser *parser, const PsbtCallbacks *callbacks, void *ctx);
+
+/**
+ * Feeds the next chunk of the PSBT.
+ *
+ * \returns false on malformed input or when a callback fails. The parser
+ *          then stays failed and parser->error says why.
+ */
+bool psbt_update(PsbtParser *parser, const uint8_t *data, size_t len);
+
+/** \returns true iff the last output map has been received. */
+bool psbt_isComplete(const PsbtParser *parser);
+
+/**
+ * Decodes a BIP32 derivation value: a 4 byte master fingerprint followed by
+ * the path.
+ */
+bool psbt_decodeBip32Path(const uint8_t *value, size_t len,
+                          uint32_t *fingerprint, uint32_t *address_n,
+                          size_t max_count, size_t *address_n_count);
+
+/** Decodes a witness UTXO value: an amount and its script. */
+bool psbt_decodeWitnessUtxo(const uint8_t *value, size_t len,
+                            uint64_t *amount, const uint8_t **script,
+                            size_t *script_len);
+
+#endif
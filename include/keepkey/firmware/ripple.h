@@ -21,6 +21,7 @@
 #define KEEPKEY_FIRMWARE_RIPPLE_H
 
 #include "trezor/crypto/bip32.h"
+#include "trezor/crypto/sha2.h"
 
 #include "messages-ripple.pb.h"
 
@@ -61,32 +62,45 @@ bool ripple_getAddress(const uint8_t public_key[33],
 
 void ripple_formatAmount(char *buf, size_t len, uint64_t amount);
 
-void ripple_serializeType(bool *ok, uint8_t **buf, const uint8_t *end,
-                          const RippleFieldMapping *m);
+/// Destination of serialized fields: either a bounded buffer, or a SHA-512
+/// context that the fields are hashed into as they are produced.
+typedef struct _RippleSink {
+  bool ok;
+  uint8_t *buf;
+  const uint8_t *end;
+  SHA512_CTX *ctx;
+} RippleSink;
 
-void ripple_serializeInt16(bool *ok, uint8_t **buf, const uint8_t *end,
-                           const RippleFieldMapping *m, int16_t val);
+void ripple_sinkInitBuffer(RippleSink *sink, uint8_t *buf, size_t len);
 
-void ripple_serializeInt32(bool *ok, uint8_t **buf, const uint8_t *end,
-                           const RippleFieldMapping *m, int32_t val);
+void ripple_sinkInitHash(RippleSink *sink, SHA512_CTX *ctx);
 
-void ripple_serializeAmount(bool *ok, uint8_t **buf, const uint8_t *end,
-                            const RippleFieldMapping *m, int64_t amount);
+/// Appends bytes to the sink. Clears sink->ok if they do not fit.
+void ripple_sinkWrite(RippleSink *sink, const uint8_t *bytes, size_t len);
 
-void ripple_serializeVarint(bool *ok, uint8_t **buf, const uint8_t *end,
-                            int val);
+void ripple_serializeType(RippleSink *sink, const RippleFieldMapping *m);
 
-void ripple_serializeBytes(bool *ok, uint8_t **buf, const uint8_t *end,
-                           const uint8_t *bytes, size_t count);
+void ripple_serializeInt16(RippleSink *sink, const RippleFieldMapping *m,
+                           int16_t val);
 
-void ripple_serializeAddress(bool *ok, uint8_t **buf, const uint8_t *end,
-                             const RippleFieldMapping *m, const char *address);
+void ripple_serializeInt32(RippleSink *sink, const RippleFieldMapping *m,
+                           int32_t val);
 
-void ripple_serializeVL(bool *ok, uint8_t **buf, const uint8_t *end,
-                        const RippleFieldMapping *m, const uint8_t *bytes,
-                        size_t count);
+void ripple_serializeAmount(RippleSink *sink, const RippleFieldMapping *m,
+                            int64_t amount);
 
-bool ripple_serialize(uint8_t **buf, const uint8_t *end, const RippleSignTx *tx,
+void ripple_serializeVarint(RippleSink *sink, int val);
+
+void ripple_serializeBytes(RippleSink *sink, const uint8_t *bytes,
+                           size_t count);
+
+void ripple_serializeAddress(RippleSink *sink, const RippleFieldMapping *m,
+                             const char *address);
+
+void ripple_serializeVL(RippleSink *sink, const RippleFieldMapping *m,
+                        const uint8_t *bytes, size_t count);
+
+bool ripple_serialize(RippleSink *sink, const RippleSignTx *tx,
                       const char *source_address, const uint8_t *pubkey,
                       const uint8_t *sig, size_t sig_len);
 
@@ -29,6 +29,13 @@ void signing_init(const SignTx *msg, const CoinType *_coin,
                   const HDNode *_root);
 void signing_abort(void);
 void signing_txack(TransactionType *tx);
+
+/// Verified previous outputs kept across the transactions of a session; the
+/// oldest is forgotten first.
+#define SIGNING_UTXO_CACHE_SIZE 32
+
+/// Forgets the previous outputs verified during this session.
+void signing_utxoCacheClear(void);
 void send_fsm_co_error_message(int co_error);
 
 #endif
@@ -40,10 +40,14 @@ bool tendermint_signTxUpdateMsgIBCTransfer(
     const char *source_channel, const char *source_port,
     const char *revision_number, const char *revision_height,
     const char *chainstr, const char *denom, const char *msgTypePrefix);
+/// Closes the sign doc and starts signing it while the remaining
+/// confirmations are shown.
+void tendermint_signTxPresign(void);
 bool tendermint_signTxFinalize(uint8_t *public_key, uint8_t *signature);
 bool tendermint_signingIsInited(void);
 bool tendermint_signingIsFinished(void);
 void tendermint_signAbort(void);
 const void *tendermint_getSignTx(void);
+const char *tendermint_signerAddress(const char *prefix);
 
 #endif
\ No newline at end of file
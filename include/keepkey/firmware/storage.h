@@ -121,6 +121,10 @@ void storage_setPassphraseProtected(bool passphrase);
 void session_cachePassphrase(const char *passphrase);
 bool session_isPassphraseCached(void);
 
+/// \returns true iff the seed is cached, so that deriving a node will not
+/// prompt for a passphrase or spend time waking up.
+bool session_isSeedCached(void);
+
 /// \brief Set config mnemonic in shadow memory from words.
 void storage_setMnemonicFromWords(const char (*words)[12],
                                   unsigned int num_words);
@@ -0,0 +1,36 @@
+#ifndef KEEPKEY_FIRMWARE_TAPROOT_H
+#define KEEPKEY_FIRMWARE_TAPROOT_H
+
+#include "trezor/crypto/sha2.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Starts a BIP340 tagged hash: SHA256(SHA256(tag) || SHA256(tag) || ...).
+ */
+void taproot_taggedHashInit(SHA256_CTX *ctx, const char *tag);
+
+/**
+ * Computes the BIP86 output key of a key-path only output.
+ *
+ * \param public_key  33 byte compressed internal key
+ * \param output_key  32 byte x-only output key
+ */
+bool taproot_tweakPublicKey(const uint8_t *public_key, uint8_t *output_key);
+
+/**
+ * Tweaks an internal private key into the key for its BIP86 output key.
+ */
+bool taproot_tweakPrivateKey(const uint8_t *private_key, uint8_t *tweaked);
+
+/**
+ * Creates a BIP340 Schnorr signature of a 32 byte digest.
+ *
+ * \param aux  32 bytes of fresh randomness mixed into the nonce
+ * \param sig  64 byte signature
+ */
+bool taproot_schnorrSign(const uint8_t *private_key, const uint8_t *digest,
+                         const uint8_t *aux, uint8_t *sig);
+
+#endif
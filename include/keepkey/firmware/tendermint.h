@@ -2,13 +2,95 @@
 #define KEEPKEY_FIRMWARE_TENDERMINT_H
 
 #include "trezor/crypto/bip32.h"
+#include "trezor/crypto/sha2.h"
 
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stddef.h>
 
 typedef struct _CoinType CoinType;
-typedef struct _SHA256_CTX SHA256_CTX;
+
+/**
+ * Streams amino JSON into SHA-256. Output is staged in a block sized buffer
+ * so that the hash sees whole blocks instead of one call per fragment.
+ */
+typedef struct {
+  SHA256_CTX ctx;
+  size_t len;
+  uint8_t buf[SHA256_BLOCK_LENGTH];
+} TendermintJsonHasher;
+
+/** Longest bech32 string, plus the terminator. */
+#define TENDERMINT_ADDRESS_MAX 91
+#define TENDERMINT_VALIDATED_ADDRESSES 4
+
+/**
+ * Address work shared by the messages of one signing session: the signer's
+ * hash160 is computed once, its bech32 encoding is kept for the last prefix
+ * asked for, and the last few addresses that passed bech32 validation are
+ * remembered so that repeated recipients (e.g. validators) are not decoded
+ * again.
+ */
+typedef struct {
+  uint8_t hash160[20];
+  char prefix[16];
+  char address[TENDERMINT_ADDRESS_MAX];
+  bool has_address;
+  char validated[TENDERMINT_VALIDATED_ADDRESSES][TENDERMINT_ADDRESS_MAX];
+  uint8_t next_validated;
+} TendermintAddressCache;
+
+/** Transactions with at least this many messages offer a summary review. */
+#define TENDERMINT_SUMMARY_MIN_MSGS 4
+#define TENDERMINT_SUMMARY_TOTALS 6
+#define TENDERMINT_SUMMARY_VALIDATORS 6
+#define TENDERMINT_VALIDATOR_ADDRESS_MAX 54
+
+typedef struct {
+  const char *action;
+  char denom[24];
+  uint8_t decimals;
+  const char *symbol;  // display suffix, e.g. " ATOM"; NULL shows the denom
+  uint64_t amount;
+} TendermintSummaryTotal;
+
+/**
+ * Aggregate of the messages reviewed as a summary: a total per action and
+ * denom, and every distinct validator address involved, each of which is
+ * shown on its own screen.
+ */
+typedef struct {
+  uint32_t msg_count;
+  uint8_t total_count;
+  TendermintSummaryTotal totals[TENDERMINT_SUMMARY_TOTALS];
+  uint8_t validator_count;
+  char validators[TENDERMINT_SUMMARY_VALIDATORS]
+                 [TENDERMINT_VALIDATOR_ADDRESS_MAX];
+} TendermintSummary;
+
+/**
+ * Describes one message type that may appear in a MsgAck. Each callback takes
+ * the whole ack; the handler is chosen by the ack's has_<msg> flag.
+ */
+typedef struct {
+  size_t has_offset;  // offsetof(<Chain>MsgAck, has_<msg>)
+  bool (*validate)(const void *ack);
+  bool (*confirm)(const void *ack);
+  bool (*update)(const void *ack);
+  const char *update_failure;
+  // Optional. Adds the message to a summary review instead of confirming it
+  // on its own; returns false if the message must be shown individually.
+  bool (*summarize)(const void *ack, TendermintSummary *summary);
+} TendermintMsgHandler;
+
+/** The message types one chain accepts, and how it reports bad acks. */
+typedef struct {
+  const TendermintMsgHandler *handlers;
+  size_t handler_count;
+  void (*sign_abort)(void);
+  const char *invalid_type;
+  const char *missing_params;
+} TendermintMsgRegistry;
 
 /**
  * \returns false iff the provided bip32 derivation path matches the given coin.
@@ -28,10 +110,85 @@ bool tendermint_pathMismatched(const CoinType *coin, const uint32_t *address_n,
 bool tendermint_getAddress(const HDNode *node, const char *prefix,
                            char *address);
 
-void tendermint_sha256UpdateEscaped(SHA256_CTX *ctx, const char *s, size_t len);
+void tendermint_addressCacheInit(TendermintAddressCache *cache,
+                                 const HDNode *node);
 
-bool tendermint_snprintf(SHA256_CTX *ctx, char *temp, size_t len,
-                         const char *format, ...)
-    __attribute__((format(printf, 4, 5)));
+/**
+ * Gets the signer's address for the given bech32 prefix
+ *
+ * \returns the address, valid until the next call with a different prefix,
+ *          or NULL on failure
+ */
+const char *tendermint_cachedAddress(TendermintAddressCache *cache,
+                                     const char *prefix);
+
+/**
+ * \returns true iff address is valid bech32
+ */
+bool tendermint_cachedValidateAddress(TendermintAddressCache *cache,
+                                      const char *address);
+
+/**
+ * \returns the handler for the first message type present in \p ack, or NULL
+ */
+const TendermintMsgHandler *tendermint_findMsgHandler(
+    const TendermintMsgRegistry *registry, const void *ack);
+
+/**
+ * Parses a non-empty string of decimal digits that fits in 64 bits.
+ */
+bool tendermint_parseUint(const char *str, uint64_t *value);
+
+void tendermint_summaryInit(TendermintSummary *summary);
+
+/**
+ * Adds \p amount to the running total for \p action and \p denom. The total
+ * is shown with \p decimals and \p symbol, as on the per-message screens.
+ *
+ * \returns false if the total would overflow or there is no room for a new
+ *          action/denom pair, leaving the summary unchanged
+ */
+bool tendermint_summaryAddAmount(TendermintSummary *summary,
+                                 const char *action, const char *denom,
+                                 uint8_t decimals, const char *symbol,
+                                 uint64_t amount);
+
+/**
+ * Records a validator to show in the summary, once however many messages
+ * name it.
+ *
+ * \returns false if there is no room for another validator
+ */
+bool tendermint_summaryAddValidator(TendermintSummary *summary,
+                                    const char *address);
+
+void tendermint_jsonInit(TendermintJsonHasher *w);
+
+/**
+ * Appends \p len bytes verbatim.
+ */
+void tendermint_jsonWrite(TendermintJsonHasher *w, const char *s, size_t len);
+
+/**
+ * Appends a NUL terminated string verbatim.
+ */
+void tendermint_jsonWriteStr(TendermintJsonHasher *w, const char *s);
+
+/**
+ * Appends \p len bytes, escaping '"' and '\\'.
+ */
+void tendermint_jsonWriteEscaped(TendermintJsonHasher *w, const char *s,
+                                 size_t len);
+
+/**
+ * Appends the decimal representation of \p value.
+ */
+void tendermint_jsonWriteUint(TendermintJsonHasher *w, uint64_t value);
+
+/**
+ * Flushes any staged output, writes the digest and wipes \p w.
+ */
+void tendermint_jsonFinal(TendermintJsonHasher *w,
+                          uint8_t hash[SHA256_DIGEST_LENGTH]);
 
 #endif
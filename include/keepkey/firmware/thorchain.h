@@ -22,7 +22,7 @@ const ThorchainSignTx *thorchain_getThorchainSignTx(void);
 // Thorchain swap data parse and confirm
 //      input: 
 //          swapStr - string in thorchain swap format
-//          size - size of input string (must be <= 256)
+//          size - size of input buffer; parsing stops at the first NUL
 //      output:
 //          true if thorchain data parsed and confirmed by user, false otherwise
 bool thorchain_parseConfirmMemo(const char *swapStr, size_t size);
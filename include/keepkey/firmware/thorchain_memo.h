@@ -0,0 +1,55 @@
+#ifndef KEEPKEY_FIRMWARE_THORCHAIN_MEMO_H
+#define KEEPKEY_FIRMWARE_THORCHAIN_MEMO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/** A slice of the memo being parsed. Not NUL terminated. */
+typedef struct {
+  const char *ptr;
+  size_t len;
+} MemoView;
+
+typedef enum {
+  ThorchainMemo_Swap,      // SWAP:ASSET:DEST:LIM/INTERVAL/QUANTITY:AFF:FEE
+  ThorchainMemo_Add,       // ADD:POOL:PAIREDADDR:AFF:FEE
+  ThorchainMemo_Withdraw,  // WITHDRAW:POOL:BASISPOINTS:ASSET
+  ThorchainMemo_LoanOpen,  // LOAN+:ASSET:DEST:MINOUT:AFF:FEE
+  ThorchainMemo_LoanRepay, // LOAN-:ASSET:OWNER:MINOUT
+} ThorchainMemoAction;
+
+/**
+ * THORChain / MAYAChain memo, split into views of the caller's buffer.
+ * Fields the memo leaves out have len == 0.
+ */
+typedef struct {
+  ThorchainMemoAction action;
+  MemoView chain;   // "ETH" in ETH.USDT-0x...
+  MemoView asset;   // "USDT-0x..." in ETH.USDT-0x...
+  MemoView dest;    // destination, paired or owner address
+  MemoView limit;   // swap limit / loan minimum out / withdraw basis points
+  MemoView interval;  // streaming swap interval, in blocks
+  MemoView quantity;  // streaming swap sub-swap count
+  MemoView affiliate;
+  MemoView fee;     // affiliate fee, in basis points
+  MemoView withdraw_asset;  // asset a withdrawal is paid out in
+} ThorchainMemo;
+
+/**
+ * Parses a memo in a single pass, without copying or modifying it.
+ *
+ * \param memo  memo bytes, read up to \p size or the first NUL
+ * \returns true iff the memo is a recognized action with an asset, no
+ *          longer than 256 bytes, and thorchain_memoConfirm shows all of it
+ */
+bool thorchain_memoParse(const char *memo, size_t size, ThorchainMemo *out);
+
+/**
+ * Shows a parsed memo to the user.
+ *
+ * \param network  name used in the screen titles, e.g. "Thorchain"
+ * \returns true iff every screen was confirmed
+ */
+bool thorchain_memoConfirm(const ThorchainMemo *memo, const char *network);
+
+#endif
@@ -40,6 +40,7 @@ typedef struct {
 
   uint32_t version;
   uint32_t version_group_id;
+  uint32_t branch_id;  // consensus branch, in the Zcash v5 header
   uint32_t lock_time;
   uint32_t expiry;
   bool is_segwit;
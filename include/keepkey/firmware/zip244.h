@@ -0,0 +1,52 @@
+#ifndef KEEPKEY_FIRMWARE_ZIP244_H
+#define KEEPKEY_FIRMWARE_ZIP244_H
+
+#include "trezor/crypto/hasher.h"
+
+#include <stdint.h>
+
+/**
+ * Midstates of the ZIP-244 signature digest shared by every transparent
+ * input of a Zcash v5 transaction without shielded spends or outputs.
+ */
+typedef struct {
+  Hasher transparent;   // transparent_sig_digest, up to txin_sig_digest
+  Hasher sig;           // signature digest, up to transparent_sig_digest
+  uint8_t sapling[32];  // sapling_digest of an empty sapling bundle
+  uint8_t orchard[32];  // orchard_digest of an empty orchard bundle
+} Zip244;
+
+/**
+ * Starts the signature digest of a v5 transaction.
+ *
+ * \param version  transaction version, without the overwintered flag
+ */
+void zip244_init(Zip244 *zip244, uint32_t version, uint32_t version_group_id,
+                 uint32_t branch_id, uint32_t lock_time, uint32_t expiry);
+
+/**
+ * Adds the transparent bundle digests, which are the same for every input
+ * under SIGHASH_ALL.
+ */
+void zip244_transparent(Zip244 *zip244, uint8_t hash_type,
+                        const uint8_t prevouts[32], const uint8_t amounts[32],
+                        const uint8_t scriptpubkeys[32],
+                        const uint8_t sequences[32],
+                        const uint8_t outputs[32]);
+
+/**
+ * txin_sig_digest of the input being signed.
+ *
+ * \param prev_hash      previous txid, in serialized (internal) byte order
+ * \param script_pubkey  the spent scriptPubKey, with its length prefix
+ */
+void zip244_txin(const uint8_t prev_hash[32], uint32_t prev_index,
+                 uint64_t amount, const uint8_t *script_pubkey,
+                 uint32_t script_pubkey_len, uint32_t sequence,
+                 uint8_t hash[32]);
+
+/** Finishes the signature digest for the input with \p txin digest. */
+void zip244_sigDigest(const Zip244 *zip244, const uint8_t txin[32],
+                      uint8_t hash[32]);
+
+#endif
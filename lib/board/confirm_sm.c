@@ -41,6 +41,7 @@
 
 /* Button request ack */
 static bool button_request_acked = false;
+static callback_func_t idle_work = NULL;
 
 extern bool reset_msg_stack;
 
@@ -286,16 +287,28 @@ static bool confirm_helper(const char *request_title_param, const char *request_
 
         display_refresh();
         animate();
+
+        // Blocks the loop until it returns; see confirm_setIdleWork.
+        if (idle_work && cur_layout != LAYOUT_INVALID) {
+          callback_func_t work = idle_work;
+          idle_work = NULL;
+          work();
+        }
     }
 
 confirm_helper_exit:
 
+  idle_work = NULL;
+
   keepkey_button_set_on_press_handler(NULL, NULL);
   keepkey_button_set_on_release_handler(NULL, NULL);
+  layout_notification_cache_clear();
 
   return (ret_stat);
 }
 
+void confirm_setIdleWork(callback_func_t work) { idle_work = work; }
+
 bool confirm(ButtonRequestType type, const char *request_title, const char *request_body,
              ...)
 {
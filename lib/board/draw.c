@@ -173,6 +173,126 @@ void draw_string(Canvas *canvas, const Font *font, const char *str_write,
   canvas->dirty = true;
 }
 
+/*
+ * text_layout_build() - Word wrap a string into a reusable layout, placing
+ * each glyph exactly where draw_string() would draw it
+ *
+ * INPUT
+ *     - layout: layout to fill in
+ *     - canvas: canvas the layout will be drawn on
+ *     - font: pointer to font size
+ *     - str: pointer to string to lay out
+ *     - p: pointer to Margins (color is ignored)
+ *     - width: row width allocated for drawing
+ *     - line_height: offset from top of screen
+ * OUTPUT
+ *     true/false whether the string could be laid out; on false the caller
+ *     should draw it with draw_string() instead
+ */
+bool text_layout_build(TextLayout *layout, const Canvas *canvas,
+                       const Font *font, const char *str,
+                       const DrawableParams *p, uint16_t width,
+                       uint16_t line_height) {
+  uint16_t sepPixels = 0;
+
+  layout->font = font;
+  layout->count = 0;
+
+  if (!canvas) {
+    return false;
+  }
+
+  if (font == get_pin_font()) {
+    sepPixels = 2;
+  }
+
+  uint16_t x_offset = 0;
+  uint16_t y = p->y;
+
+  while (*str) {
+    const CharacterImage *img = font_get_char(font, *str);
+    uint16_t word_width = img->width;
+    const char *next_c = str + 1;
+
+    /* Allow line breaks */
+    if (*str == '\n') {
+      y += line_height;
+      x_offset = 0;
+      str++;
+      continue;
+    }
+
+    if (*str == ' ') {
+      while (*next_c && *next_c != ' ' && *next_c != '\n') {
+        word_width += font_get_char(font, *next_c)->width;
+        next_c++;
+      }
+    }
+
+    if ((width != 0) && (width <= canvas->width) &&
+        (x_offset + word_width > width)) {
+      y += line_height;
+      x_offset = 0;
+    }
+
+    if (x_offset == 0 && *str == ' ') {
+      str++;
+      continue;
+    }
+
+    x_offset += sepPixels;
+    uint16_t x = x_offset + p->x;
+
+    /* Stop where draw_char_with_shift() would run out of space */
+    if ((uint32_t)y * canvas->width + x >=
+            KEEPKEY_DISPLAY_HEIGHT * KEEPKEY_DISPLAY_WIDTH ||
+        img->width + x > canvas->width || img->height + y > canvas->height) {
+      break;
+    }
+
+    if (layout->count == layout->capacity || x > UINT8_MAX ||
+        y > UINT8_MAX) {
+      layout->count = 0;
+      return false;
+    }
+
+    PlacedGlyph *g = &layout->glyphs[layout->count++];
+    g->c = *str;
+    g->x = x;
+    g->y = y;
+    x_offset += img->width;
+    str++;
+  }
+
+  return true;
+}
+
+/*
+ * text_layout_draw() - Blit a layout built by text_layout_build()
+ *
+ * INPUT
+ *     - canvas: canvas
+ *     - layout: glyphs to draw
+ *     - color: text color
+ * OUTPUT
+ *     none
+ */
+void text_layout_draw(Canvas *canvas, const TextLayout *layout,
+                      uint8_t color) {
+  DrawableParams char_params;
+  char_params.color = color;
+
+  for (uint16_t i = 0; i < layout->count; i++) {
+    const PlacedGlyph *g = &layout->glyphs[i];
+    char_params.x = g->x;
+    char_params.y = g->y;
+    draw_char_with_shift(canvas, &char_params, NULL, NULL,
+                         font_get_char(layout->font, g->c));
+  }
+
+  canvas->dirty = true;
+}
+
 /*
  * draw_char() - Draw a single character to the display
  *
@@ -28,6 +28,7 @@
 #include "keepkey/board/variant.h"
 #include "keepkey/firmware/fsm.h"
 #include "keepkey/variant/keepkey.h"
+#include "trezor/crypto/memzero.h"
 
 #include <ctype.h>
 #include <stdarg.h>
@@ -45,6 +46,31 @@ static bool iconLayout = false;
 
 extern bool constant_power;
 
+/* Word-wrapped title and body of the last notification drawn. The confirm
+ * state machine redraws the same text for every state change, so only the
+ * first draw pays for wrapping. */
+typedef struct {
+  bool valid;
+  uint16_t left_margin;
+  uint16_t title_width;
+  uint16_t body_width;
+  uint32_t body_line_count;
+  TextLayout title_layout;
+  TextLayout body_layout;
+} NotificationTextCache;
+
+/* Notifications can show recovery words, so the text and its glyphs are
+ * CONFIDENTIAL. The geometry above is not. */
+typedef struct {
+  char title[TITLE_CHAR_MAX];
+  char body[BODY_CHAR_MAX];
+  PlacedGlyph title_glyphs[TITLE_CHAR_MAX];
+  PlacedGlyph body_glyphs[BODY_CHAR_MAX];
+} NotificationText;
+
+static NotificationTextCache notification_cache;
+static CONFIDENTIAL NotificationText notification_text;
+
 /*
  *  layout_home_helper() - Splash home screen helper
  *
@@ -252,6 +278,111 @@ void layout_has_icon(bool tf) {
   return;
 }
 
+/*
+ * layout_notification_text() - Draw the title and body of a notification,
+ * reusing the word wrapping from the previous call when the text and
+ * geometry have not changed
+ *
+ * INPUT
+ *     - str1: title string
+ *     - str2: body string
+ *     - left_margin: x position of title and body
+ *     - title_width: title row width
+ *     - body_width: body row width
+ *     - sp: receives the position after the body, for the icon
+ * OUTPUT
+ *     none
+ */
+static void layout_notification_text(const char *str1, const char *str2,
+                                     uint16_t left_margin,
+                                     uint16_t title_width, uint16_t body_width,
+                                     DrawableParams *sp) {
+  const Font *title_font = get_title_font();
+  const Font *body_font = get_body_font();
+  NotificationTextCache *c = &notification_cache;
+  NotificationText *t = &notification_text;
+
+  /* Format Title */
+  char upper_str1[TITLE_CHAR_MAX];
+  strlcpy(upper_str1, str1, TITLE_CHAR_MAX);
+  kk_strupr(upper_str1);
+
+  bool hit = c->valid && c->left_margin == left_margin &&
+             c->title_width == title_width && c->body_width == body_width &&
+             strcmp(t->title, upper_str1) == 0 &&
+             strncmp(t->body, str2, BODY_CHAR_MAX) == 0;
+
+  if (!hit) {
+    c->valid = false;
+    c->body_line_count = calc_str_line(body_font, str2, body_width);
+  }
+
+  /* Determine vertical alignment and body width */
+  sp->y = TOP_MARGIN;
+
+  if (c->body_line_count == ONE_LINE) {
+    sp->y = TOP_MARGIN_FOR_ONE_LINE;
+  } else if (c->body_line_count == TWO_LINES) {
+    sp->y = TOP_MARGIN_FOR_TWO_LINES;
+  }
+  sp->x = left_margin;
+
+  if (!hit && strlen(str2) < BODY_CHAR_MAX) {
+    DrawableParams body_sp = *sp;
+    body_sp.y += font_height(body_font) + BODY_TOP_MARGIN;
+
+    c->title_layout.glyphs = t->title_glyphs;
+    c->title_layout.capacity = TITLE_CHAR_MAX;
+    c->body_layout.glyphs = t->body_glyphs;
+    c->body_layout.capacity = BODY_CHAR_MAX;
+    if (text_layout_build(&c->title_layout, canvas, title_font, upper_str1, sp,
+                          title_width, font_height(title_font)) &&
+        text_layout_build(&c->body_layout, canvas, body_font, str2, &body_sp,
+                          body_width,
+                          font_height(body_font) + BODY_FONT_LINE_PADDING)) {
+      c->valid = true;
+      c->left_margin = left_margin;
+      c->title_width = title_width;
+      c->body_width = body_width;
+      strlcpy(t->title, upper_str1, sizeof(t->title));
+      strlcpy(t->body, str2, sizeof(t->body));
+    }
+  }
+
+  if (c->valid) {
+    text_layout_draw(canvas, &c->title_layout, TITLE_COLOR);
+    text_layout_draw(canvas, &c->body_layout, BODY_COLOR);
+    sp->y += font_height(body_font) + BODY_TOP_MARGIN;
+    sp->color = BODY_COLOR;
+  } else {
+    /* Too long to cache, draw directly */
+    sp->color = TITLE_COLOR;
+    draw_string(canvas, title_font, upper_str1, sp, title_width,
+                font_height(title_font));
+
+    sp->y += font_height(body_font) + BODY_TOP_MARGIN;
+    sp->x = left_margin;
+    sp->color = BODY_COLOR;
+    draw_string(canvas, body_font, str2, sp, body_width,
+                font_height(body_font) + BODY_FONT_LINE_PADDING);
+  }
+
+  memzero(upper_str1, sizeof(upper_str1));
+}
+
+/*
+ * layout_notification_cache_clear() - Forget the cached notification text
+ *
+ * INPUT
+ *     none
+ * OUTPUT
+ *     none
+ */
+void layout_notification_cache_clear(void) {
+  memzero(&notification_cache, sizeof(notification_cache));
+  memzero(&notification_text, sizeof(notification_text));
+}
+
 /*
  * layout_standard_notification() - Display standard notification
  *
@@ -268,10 +399,6 @@ void layout_standard_notification(const char *str1, const char *str2,
   layout_clear();
 
   DrawableParams sp;
-  const Font *title_font = get_title_font();
-
-  const Font *body_font = get_body_font();
-  uint32_t body_line_count;
   uint16_t left_margin, body_width, title_width;
 
   if (iconLayout) {
@@ -284,39 +411,12 @@ void layout_standard_notification(const char *str1, const char *str2,
     title_width = TITLE_WIDTH;
   }
 
-  body_line_count = calc_str_line(body_font, str2, body_width);
-
-  /* Determine vertical alignment and body width */
-  sp.y = TOP_MARGIN;
-
-  if (body_line_count == ONE_LINE) {
-    sp.y = TOP_MARGIN_FOR_ONE_LINE;
-  } else if (body_line_count == TWO_LINES) {
-    sp.y = TOP_MARGIN_FOR_TWO_LINES;
-  }
-
-  /* Format Title */
-  char upper_str1[TITLE_CHAR_MAX];
-  strlcpy(upper_str1, str1, TITLE_CHAR_MAX);
-  kk_strupr(upper_str1);
-
-  /* Title */
-  sp.x = left_margin;
-  sp.color = TITLE_COLOR;
-  draw_string(canvas, title_font, upper_str1, &sp, title_width,
-              font_height(title_font));
-
-  /* Body */
-  sp.y += font_height(body_font) + BODY_TOP_MARGIN;
-  sp.x = left_margin;
-  sp.color = BODY_COLOR;
-  draw_string(canvas, body_font, str2, &sp, body_width,
-              font_height(body_font) + BODY_FONT_LINE_PADDING);
+  layout_notification_text(str1, str2, left_margin, title_width, body_width,
+                           &sp);
 
   layout_notification_icon(type, &sp);
 }
 
-
 /*
  * layout_add_icon() - Display standard notification
  *
@@ -345,38 +445,8 @@ void layout_constant_power_notification(const char *str1, const char *str2,
     layout_clear();
 
     DrawableParams sp;
-    const Font *title_font = get_title_font();
-    const Font *body_font = get_body_font();
-    const uint32_t body_line_count = calc_str_line(body_font, str2, BODY_WIDTH);
-
-    /* Determine vertical alignment and body width */
-    sp.y = TOP_MARGIN;
-
-    if(body_line_count == ONE_LINE)
-    {
-        sp.y = TOP_MARGIN_FOR_ONE_LINE;
-    }
-    else if(body_line_count == TWO_LINES)
-    {
-        sp.y = TOP_MARGIN_FOR_TWO_LINES;
-    }
-
-    /* Format Title */
-    char upper_str1[TITLE_CHAR_MAX];
-    strlcpy(upper_str1, str1, TITLE_CHAR_MAX);
-    kk_strupr(upper_str1);
-
-    /* Title */
-    sp.x = 128 + LEFT_MARGIN;
-    sp.color = TITLE_COLOR;
-    draw_string(canvas, title_font, upper_str1, &sp, TITLE_WIDTH, font_height(title_font));
-
-    /* Body */
-    sp.y += font_height(body_font) + BODY_TOP_MARGIN;
-    sp.x = 128 + LEFT_MARGIN;
-    sp.color = BODY_COLOR;
-    draw_string(canvas, body_font, str2, &sp, BODY_WIDTH,
-                font_height(body_font) + BODY_FONT_LINE_PADDING);
+    layout_notification_text(str1, str2, 128 + LEFT_MARGIN, TITLE_WIDTH,
+                             BODY_WIDTH, &sp);
 
     layout_notification_icon(type, &sp);
 }
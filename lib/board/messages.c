@@ -191,23 +191,35 @@ static void raw_dispatch(const MessagesMap_t *entry, const uint8_t *msg,
   })
 #endif
 
+/// Reassembly state for usb_rx_helper. Kept at file scope so that it can be
+/// put back to its power-on state by usb_rx_reset().
+static struct {
+  bool firstFrame;
+  uint16_t msgId;
+  uint32_t msgSize;
+  uint8_t msg[MAX_FRAME_SIZE];
+  size_t cursor;  //< Index into msg where the current frame is to be written.
+  const MessagesMap_t *entry;
+} rx = {.firstFrame = true};
+
+/// Drop any partially received message.
+void usb_rx_reset(void) {
+  rx.msgId = 0xffff;
+  rx.msgSize = 0;
+  memset(rx.msg, 0, sizeof(rx.msg));
+  rx.cursor = 0;
+  rx.firstFrame = true;
+  rx.entry = NULL;
+}
+
 /// Common helper that handles USB messages from host
 void usb_rx_helper(const uint8_t *buf, size_t length, MessageMapType type) {
-  static bool firstFrame = true;
-
-  static uint16_t msgId;
-  static uint32_t msgSize;
-  static uint8_t msg[MAX_FRAME_SIZE];
-  static size_t
-      cursor;  //< Index into msg where the current frame is to be written.
-  static const MessagesMap_t *entry;
-
-  if (firstFrame) {
-    msgId = 0xffff;
-    msgSize = 0;
-    memset(msg, 0, sizeof(msg));
-    cursor = 0;
-    entry = NULL;
+  if (rx.firstFrame) {
+    rx.msgId = 0xffff;
+    rx.msgSize = 0;
+    memset(rx.msg, 0, sizeof(rx.msg));
+    rx.cursor = 0;
+    rx.entry = NULL;
   }
 
   assert(buf != NULL);
@@ -222,7 +234,7 @@ void usb_rx_helper(const uint8_t *buf, size_t length, MessageMapType type) {
     goto reset;
   }
 
-  if (firstFrame && (buf[1] != '#' || buf[2] != '#')) {
+  if (rx.firstFrame && (buf[1] != '#' || buf[2] != '#')) {
     (*msg_failure)(FailureType_Failure_UnexpectedMessage, "Malformed packet");
     goto reset;
   }
@@ -231,25 +243,25 @@ void usb_rx_helper(const uint8_t *buf, size_t length, MessageMapType type) {
   const uint8_t *frame;
   size_t frameSize;
 
-  if (firstFrame) {
+  if (rx.firstFrame) {
     // Reset the buffer that we're writing fragments into.
-    memset(msg, 0, sizeof(msg));
+    memset(rx.msg, 0, sizeof(rx.msg));
 
     // Then fish out the id / size, which are big-endian uint16 /
     // uint32's respectively.
-    msgId = buf[4] | ((uint16_t)buf[3]) << 8;
-    msgSize = buf[8] | ((uint32_t)buf[7]) << 8 | ((uint32_t)buf[6]) << 16 |
-              ((uint32_t)buf[5]) << 24;
+    rx.msgId = buf[4] | ((uint16_t)buf[3]) << 8;
+    rx.msgSize = buf[8] | ((uint32_t)buf[7]) << 8 |
+                 ((uint32_t)buf[6]) << 16 | ((uint32_t)buf[5]) << 24;
 
     // Determine callback handler and message map type.
-    entry = message_map_entry(type, msgId, IN_MSG);
+    rx.entry = message_map_entry(type, rx.msgId, IN_MSG);
 
     // And reset the cursor.
-    cursor = 0;
+    rx.cursor = 0;
 
     // Then take note of the fragment boundaries.
     frame = &buf[9];
-    frameSize = MIN(length - 9, msgSize);
+    frameSize = MIN(length - 9, rx.msgSize);
   } else {
     // Otherwise it's a continuation/fragment.
     frame = &buf[1];
@@ -257,49 +269,45 @@ void usb_rx_helper(const uint8_t *buf, size_t length, MessageMapType type) {
   }
 
   // If the msgId wasn't in our map, bail.
-  if (!entry) {
+  if (!rx.entry) {
     (*msg_failure)(FailureType_Failure_UnexpectedMessage, "Unknown message");
     goto reset;
   }
 
-  if (entry->dispatch == RAW) {
+  if (rx.entry->dispatch == RAW) {
     /* Call dispatch for every segment since we are not buffering and parsing,
      * and assume the raw dispatched callbacks will handle their own state and
      * buffering internally
      */
-    raw_dispatch(entry, frame, frameSize, msgSize);
-    firstFrame = false;
+    raw_dispatch(rx.entry, frame, frameSize, rx.msgSize);
+    rx.firstFrame = false;
     return;
   }
 
   size_t end;
-  if (check_uadd_overflow(cursor, frameSize, &end) || sizeof(msg) < end) {
+  if (check_uadd_overflow(rx.cursor, frameSize, &end) ||
+      sizeof(rx.msg) < end) {
     (*msg_failure)(FailureType_Failure_UnexpectedMessage, "Malformed message");
     goto reset;
   }
 
   // Copy content to frame buffer.
-  memcpy(&msg[cursor], frame, frameSize);
+  memcpy(&rx.msg[rx.cursor], frame, frameSize);
 
   // Advance the cursor.
-  cursor = end;
+  rx.cursor = end;
 
   // Only parse and message map if all segments have been buffered.
-  bool last_segment = cursor >= msgSize;
+  bool last_segment = rx.cursor >= rx.msgSize;
   if (!last_segment) {
-    firstFrame = false;
+    rx.firstFrame = false;
     return;
   }
 
-  dispatch(entry, msg, msgSize);
+  dispatch(rx.entry, rx.msg, rx.msgSize);
 
 reset:
-  msgId = 0xffff;
-  msgSize = 0;
-  memset(msg, 0, sizeof(msg));
-  cursor = 0;
-  firstFrame = true;
-  entry = NULL;
+  usb_rx_reset();
 }
 
 /* Tiny messages */
@@ -430,7 +430,19 @@ char usbTiny(char set) {
 
 #endif  // EMULATOR
 
+#ifdef EMULATOR
+static msg_write_hook_t msg_write_hook;
+
+void set_msg_write_hook(msg_write_hook_t hook) { msg_write_hook = hook; }
+#endif
+
 bool msg_write(MessageType msg_id, const void *msg) {
+#ifdef EMULATOR
+  if (msg_write_hook) {
+    msg_write_hook(msg_id, msg);
+  }
+#endif
+
   const pb_field_t *fields = message_fields(NORMAL_MSG, msg_id, OUT_MSG);
 
   if (!fields) return false;
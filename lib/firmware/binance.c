@@ -7,56 +7,78 @@
 
 #include "messages-binance.pb.h"
 
+#include <string.h>
+
 static CONFIDENTIAL HDNode node;
-static SHA256_CTX ctx;
+static TendermintJsonHasher json;
+static TendermintAddressCache addresses;
 static bool has_message;
 static bool initialized;
 static uint32_t msgs_remaining;
 static BinanceSignTx msg;
 
+typedef enum {
+  TransferIdle,
+  TransferInputs,
+  TransferOutputs,
+} TransferStage;
+
+typedef struct {
+  char denom[sizeof(((BinanceCoin *)0)->denom)];
+  uint64_t in;
+  uint64_t out;
+} TransferTotal;
+
+static TransferStage transfer_stage;
+static TransferTotal transfer_totals[BINANCE_TRANSFER_DENOMS];
+static size_t transfer_total_count;
+
 const BinanceSignTx *binance_getBinanceSignTx(void) { return &msg; }
 
+const char *binance_signerAddress(void) {
+  return tendermint_cachedAddress(&addresses, "bnb");
+}
+
 bool binance_signTxInit(const HDNode *_node, const BinanceSignTx *_msg) {
   initialized = true;
   msgs_remaining = _msg->msg_count;
   has_message = false;
+  transfer_stage = TransferIdle;
+  transfer_total_count = 0;
 
   memzero(&node, sizeof(node));
   memcpy(&node, _node, sizeof(node));
+  tendermint_addressCacheInit(&addresses, &node);
   memcpy(&msg, _msg, sizeof(msg));
 
-  bool success = true;
-  char buffer[64 + 1];
-
-  sha256_Init(&ctx);
+  tendermint_jsonInit(&json);
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"account_number\":\"%" PRIu64 "\"",
-                                 msg.account_number);
+  tendermint_jsonWriteStr(&json, "{\"account_number\":\"");
+  tendermint_jsonWriteUint(&json, msg.account_number);
+  tendermint_jsonWriteStr(&json, "\"");
 
   const char *const chainid_prefix = ",\"chain_id\":\"";
-  sha256_Update(&ctx, (uint8_t *)chainid_prefix, strlen(chainid_prefix));
-  tendermint_sha256UpdateEscaped(&ctx, msg.chain_id, strlen(msg.chain_id));
+  tendermint_jsonWrite(&json, chainid_prefix, strlen(chainid_prefix));
+  tendermint_jsonWriteEscaped(&json, msg.chain_id, strlen(msg.chain_id));
 
   const char *const data_memo = "\",\"data\":null,\"memo\":\"";
-  sha256_Update(&ctx, (uint8_t *)data_memo, strlen(data_memo));
+  tendermint_jsonWrite(&json, data_memo, strlen(data_memo));
   if (msg.has_memo) {
-    tendermint_sha256UpdateEscaped(&ctx, msg.memo, strlen(msg.memo));
+    tendermint_jsonWriteEscaped(&json, msg.memo, strlen(msg.memo));
   }
 
-  sha256_Update(&ctx, (const uint8_t *)"\",\"msgs\":[", 10);
-  return success;
+  tendermint_jsonWrite(&json, "\",\"msgs\":[", 10);
+  return true;
 }
 
 bool binance_serializeCoin(const BinanceCoin *coin) {
-  bool success = true;
-  char buffer[64 + 1];
-
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"amount\":%" PRIu64 ",\"denom\":\"%s\"}",
-                                 coin->amount, coin->denom);
+  tendermint_jsonWriteStr(&json, "{\"amount\":");
+  tendermint_jsonWriteUint(&json, coin->amount);
+  tendermint_jsonWriteStr(&json, ",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, coin->denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  return success;
+  return true;
 }
 
 bool binance_serializeInputOutput(const BinanceInputOutput *io) {
@@ -67,61 +89,141 @@ bool binance_serializeInputOutput(const BinanceInputOutput *io) {
     return false;
   }
 
-  sha256_Update(&ctx, (const uint8_t *)"{\"address\":\"", 12);
-  sha256_Update(&ctx, (const uint8_t *)io->address, strlen(io->address));
-  sha256_Update(&ctx, (const uint8_t *)"\",\"coins\":[", 11);
+  tendermint_jsonWrite(&json, "{\"address\":\"", 12);
+  tendermint_jsonWrite(&json, io->address, strlen(io->address));
+  tendermint_jsonWrite(&json, "\",\"coins\":[", 11);
 
   bool success = true;
   for (int i = 0; i < io->coins_count; i++) {
     success &= binance_serializeCoin(&io->coins[i]);
-    if (i + 1 != io->coins_count) sha256_Update(&ctx, (const uint8_t *)",", 1);
+    if (i + 1 != io->coins_count) tendermint_jsonWrite(&json, ",", 1);
   }
 
-  sha256_Update(&ctx, (const uint8_t *)"]}", 2);
+  tendermint_jsonWrite(&json, "]}", 2);
 
   return success;
 }
 
-bool binance_signTxUpdateTransfer(const BinanceTransferMsg *_msg) {
-  bool success = true;
+static bool transfer_addCoins(const BinanceInputOutput *io, bool input) {
+  if (io->coins_count == 0) return false;
 
-  sha256_Update(&ctx, (const uint8_t *)"{\"inputs\":[", 11);
+  for (int i = 0; i < io->coins_count; i++) {
+    const BinanceCoin *coin = &io->coins[i];
+
+    size_t t = 0;
+    for (; t < transfer_total_count; t++) {
+      if (strcmp(transfer_totals[t].denom, coin->denom) == 0) break;
+    }
+    if (t == transfer_total_count) {
+      if (transfer_total_count == BINANCE_TRANSFER_DENOMS) return false;
+      strlcpy(transfer_totals[t].denom, coin->denom,
+              sizeof(transfer_totals[t].denom));
+      transfer_totals[t].in = 0;
+      transfer_totals[t].out = 0;
+      transfer_total_count++;
+    }
+
+    uint64_t *total = input ? &transfer_totals[t].in : &transfer_totals[t].out;
+    if (*total + coin->amount < *total) return false;
+    *total += coin->amount;
+  }
 
-  for (int i = 0; i < _msg->inputs_count; i++) {
-    success &= binance_serializeInputOutput(&_msg->inputs[i]);
-    if (i + 1 != _msg->inputs_count)
-      sha256_Update(&ctx, (const uint8_t *)",", 1);
+  return true;
+}
+
+bool binance_signTxTransferInput(const BinanceInputOutput *io) {
+  if (msgs_remaining == 0) return false;
+
+  // Only the signing key's own address can be spent from
+  const char *signer = binance_signerAddress();
+  if (!signer || strcmp(signer, io->address) != 0) return false;
+
+  switch (transfer_stage) {
+    case TransferIdle:
+      tendermint_jsonWrite(&json, "{\"inputs\":[", 11);
+      transfer_stage = TransferInputs;
+      transfer_total_count = 0;
+      break;
+    case TransferInputs:
+      tendermint_jsonWrite(&json, ",", 1);
+      break;
+    case TransferOutputs:
+      // All inputs come before the first output
+      return false;
   }
 
-  sha256_Update(&ctx, (const uint8_t *)"],\"outputs\":[", 13);
+  return transfer_addCoins(io, true) && binance_serializeInputOutput(io);
+}
 
-  for (int i = 0; i < _msg->outputs_count; i++) {
-    success &= binance_serializeInputOutput(&_msg->outputs[i]);
-    if (i + 1 != _msg->outputs_count)
-      sha256_Update(&ctx, (const uint8_t *)",", 1);
+bool binance_signTxTransferOutput(const BinanceInputOutput *io) {
+  switch (transfer_stage) {
+    case TransferIdle:
+      return false;
+    case TransferInputs:
+      tendermint_jsonWrite(&json, "],\"outputs\":[", 13);
+      transfer_stage = TransferOutputs;
+      break;
+    case TransferOutputs:
+      tendermint_jsonWrite(&json, ",", 1);
+      break;
   }
 
-  sha256_Update(&ctx, (const uint8_t *)"]}", 2);
+  if (!transfer_addCoins(io, false)) return false;
+
+  // Outputs may never spend more than the inputs provide
+  for (size_t t = 0; t < transfer_total_count; t++) {
+    if (transfer_totals[t].out > transfer_totals[t].in) return false;
+  }
 
+  return binance_serializeInputOutput(io);
+}
+
+bool binance_signTxTransferIsBalanced(void) {
+  if (transfer_stage != TransferOutputs) return false;
+
+  for (size_t t = 0; t < transfer_total_count; t++) {
+    if (transfer_totals[t].in != transfer_totals[t].out) return false;
+  }
+  return true;
+}
+
+bool binance_signTxTransferEnd(void) {
+  if (!binance_signTxTransferIsBalanced()) return false;
+
+  tendermint_jsonWrite(&json, "]}", 2);
+
+  transfer_stage = TransferIdle;
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 
-bool binance_signTxFinalize(uint8_t *public_key, uint8_t *signature) {
-  char buffer[64 + 1];
+bool binance_signTxUpdateTransfer(const BinanceTransferMsg *_msg) {
+  bool success = true;
 
-  if (!tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                           "],\"sequence\":\"%" PRIu64
-                           "\",\"source\":\"%" PRIu64 "\"}",
-                           msg.sequence, msg.source))
-    return false;
+  for (int i = 0; i < _msg->inputs_count; i++) {
+    success &= binance_signTxTransferInput(&_msg->inputs[i]);
+  }
+
+  for (int i = 0; i < _msg->outputs_count; i++) {
+    success &= binance_signTxTransferOutput(&_msg->outputs[i]);
+  }
+
+  return success && binance_signTxTransferEnd();
+}
+
+bool binance_signTxFinalize(uint8_t *public_key, uint8_t *signature) {
+  tendermint_jsonWriteStr(&json, "],\"sequence\":\"");
+  tendermint_jsonWriteUint(&json, msg.sequence);
+  tendermint_jsonWriteStr(&json, "\",\"source\":\"");
+  tendermint_jsonWriteUint(&json, msg.source);
+  tendermint_jsonWriteStr(&json, "\"}");
 
   hdnode_fill_public_key(&node);
   memcpy(public_key, node.public_key, 33);
 
   uint8_t hash[SHA256_DIGEST_LENGTH];
-  sha256_Final(&ctx, hash);
+  tendermint_jsonFinal(&json, hash);
   return ecdsa_sign_digest(&secp256k1, node.private_key, hash, signature, NULL,
                            NULL) == 0;
 }
@@ -134,6 +236,10 @@ void binance_signAbort(void) {
   initialized = false;
   has_message = false;
   msgs_remaining = 0;
+  transfer_stage = TransferIdle;
+  transfer_total_count = 0;
+  memzero(transfer_totals, sizeof(transfer_totals));
   memzero(&msg, sizeof(msg));
   memzero(&node, sizeof(node));
+  memzero(&addresses, sizeof(addresses));
 }
@@ -0,0 +1,447 @@
+/*
+ * This file is part of the Keepkey project.
+ *
+ * Copyright (C) 2024 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/cosmos_direct.h"
+
+#include "keepkey/board/util.h"
+#include "trezor/crypto/ecdsa.h"
+#include "trezor/crypto/memzero.h"
+#include "trezor/crypto/secp256k1.h"
+#include "trezor/crypto/sha2.h"
+
+#include <nanopb.h>
+#include <string.h>
+
+#define COSMOS_DIRECT_CHAIN_ID_MAX 32
+
+// SignDoc field tags (field number << 3 | wire type)
+#define SIGNDOC_BODY_BYTES 0x0a
+#define SIGNDOC_AUTH_INFO_BYTES 0x12
+#define SIGNDOC_CHAIN_ID 0x1a
+#define SIGNDOC_ACCOUNT_NUMBER 0x20
+
+#define TXBODY_MESSAGES 1
+#define TXBODY_MEMO 2
+#define TXBODY_EXTENSION_OPTIONS 1023
+#define AUTHINFO_FEE 2
+
+typedef enum {
+  WalkTag,
+  WalkLength,
+  WalkVarint,
+  WalkSkip,
+  WalkCapture,
+} WalkState;
+
+/*
+ * Follows the top level fields of a TxBody or AuthInfo as its bytes arrive,
+ * without needing the whole message in memory. Only fields that are shown
+ * to the user are buffered, at most COSMOS_DIRECT_FIELD_MAX bytes at a time.
+ */
+typedef struct {
+  bool is_body;
+  uint32_t total;
+  uint32_t offset;
+  WalkState state;
+  uint64_t varint;
+  uint8_t shift;
+  uint32_t field;
+  uint32_t left;
+  CosmosDirectField capture;
+  uint32_t capture_offset;
+  uint32_t capture_total;
+} Walker;
+
+static CONFIDENTIAL HDNode node;
+static SHA256_CTX ctx;
+static Walker body, auth_info;
+static uint8_t field_buf[COSMOS_DIRECT_FIELD_MAX];
+static size_t field_len;
+static char chain_id[COSMOS_DIRECT_CHAIN_ID_MAX + 1];
+static uint64_t account_number;
+static CosmosDirectReviewFn review;
+static bool initialized;
+
+static void hash_varint(uint64_t value) {
+  uint8_t buf[10];
+  size_t len = 0;
+  do {
+    buf[len] = value & 0x7f;
+    value >>= 7;
+    if (value) buf[len] |= 0x80;
+    len++;
+  } while (value);
+  sha256_Update(&ctx, buf, len);
+}
+
+static void walker_init(Walker *w, bool is_body, uint32_t total) {
+  memset(w, 0, sizeof(*w));
+  w->is_body = is_body;
+  w->total = total;
+  w->state = WalkTag;
+}
+
+/// Hands the buffered piece of the current field to the review callback.
+static bool walker_review(Walker *w) {
+  if (!w->left) w->state = WalkTag;
+  bool ok = !review || review(w->capture, w->capture_offset, w->capture_total,
+                              field_buf, field_len);
+  w->capture_offset += field_len;
+  memzero(field_buf, sizeof(field_buf));
+  field_len = 0;
+  return ok;
+}
+
+/// \returns true iff the field is shown to the user, and if so which
+static bool walker_classify(const Walker *w, uint32_t field,
+                            CosmosDirectField *capture) {
+  if (w->is_body) {
+    if (field == TXBODY_MESSAGES) {
+      *capture = CosmosDirectField_Message;
+      return true;
+    }
+    if (field == TXBODY_MEMO) {
+      *capture = CosmosDirectField_Memo;
+      return true;
+    }
+    return false;
+  }
+
+  if (field == AUTHINFO_FEE) {
+    *capture = CosmosDirectField_Fee;
+    return true;
+  }
+  return false;
+}
+
+static bool walker_onTag(Walker *w, uint64_t tag) {
+  if (tag >> 3 == 0 || tag >> 3 > UINT32_MAX) return false;
+
+  w->field = tag >> 3;
+  pb_wire_type_t wire = tag & 7;
+
+  // Critical extensions change the meaning of the transaction, and we
+  // can't show them.
+  if (w->is_body && w->field == TXBODY_EXTENSION_OPTIONS) return false;
+
+  bool shown = walker_classify(w, w->field, &w->capture);
+  if (shown && wire != PB_WT_STRING) return false;
+
+  switch (wire) {
+    case PB_WT_VARINT:
+      w->state = WalkVarint;
+      return true;
+    case PB_WT_64BIT:
+      w->state = WalkSkip;
+      w->left = 8;
+      return true;
+    case PB_WT_32BIT:
+      w->state = WalkSkip;
+      w->left = 4;
+      return true;
+    case PB_WT_STRING:
+      w->state = WalkLength;
+      return true;
+  }
+  return false;
+}
+
+static bool walker_onLength(Walker *w, uint64_t len) {
+  if (len > w->total - w->offset) return false;
+
+  w->left = len;
+
+  CosmosDirectField capture;
+  if (!walker_classify(w, w->field, &capture)) {
+    w->state = len ? WalkSkip : WalkTag;
+    return true;
+  }
+
+  field_len = 0;
+  w->capture_offset = 0;
+  w->capture_total = len;
+  w->state = WalkCapture;
+  return len ? true : walker_review(w);
+}
+
+static bool walker_update(Walker *w, const uint8_t *data, size_t len) {
+  if (len > w->total - w->offset) return false;
+
+  while (len) {
+    switch (w->state) {
+      case WalkTag:
+      case WalkLength:
+      case WalkVarint: {
+        uint8_t byte = *data++;
+        len--;
+        w->offset++;
+
+        if (w->shift > 63) return false;
+        w->varint |= (uint64_t)(byte & 0x7f) << w->shift;
+        w->shift += 7;
+        if (byte & 0x80) continue;
+
+        uint64_t value = w->varint;
+        w->varint = 0;
+        w->shift = 0;
+
+        if (w->state == WalkTag) {
+          if (!walker_onTag(w, value)) return false;
+        } else if (w->state == WalkLength) {
+          if (!walker_onLength(w, value)) return false;
+        } else {
+          w->state = WalkTag;
+        }
+        break;
+      }
+      case WalkSkip:
+      case WalkCapture: {
+        size_t n = MIN(len, w->left);
+        if (w->state == WalkCapture) {
+          n = MIN(n, sizeof(field_buf) - field_len);
+          memcpy(field_buf + field_len, data, n);
+          field_len += n;
+        }
+        data += n;
+        len -= n;
+        w->offset += n;
+        w->left -= n;
+
+        if (w->state == WalkCapture) {
+          // Review the field once it is complete, or a piece of it once the
+          // buffer fills up.
+          if ((!w->left || field_len == sizeof(field_buf)) &&
+              !walker_review(w))
+            return false;
+        } else if (!w->left) {
+          w->state = WalkTag;
+        }
+        break;
+      }
+    }
+  }
+
+  // A field may not run past the end of its message.
+  if (w->offset == w->total && w->state != WalkTag) return false;
+
+  return true;
+}
+
+static bool walker_isDone(const Walker *w) { return w->offset == w->total; }
+
+bool cosmos_directInit(const HDNode *_node, uint32_t body_len,
+                       uint32_t auth_info_len, const char *_chain_id,
+                       uint64_t _account_number, CosmosDirectReviewFn _review) {
+  cosmos_directAbort();
+
+  if (!body_len || !auth_info_len) return false;
+
+  size_t chain_id_len = strlen(_chain_id);
+  if (chain_id_len > COSMOS_DIRECT_CHAIN_ID_MAX) return false;
+
+  memcpy(&node, _node, sizeof(node));
+  memcpy(chain_id, _chain_id, chain_id_len + 1);
+  account_number = _account_number;
+  review = _review;
+
+  walker_init(&body, true, body_len);
+  walker_init(&auth_info, false, auth_info_len);
+
+  sha256_Init(&ctx);
+  uint8_t tag = SIGNDOC_BODY_BYTES;
+  sha256_Update(&ctx, &tag, 1);
+  hash_varint(body_len);
+
+  initialized = true;
+  return true;
+}
+
+bool cosmos_directUpdateBody(const uint8_t *data, size_t len) {
+  if (!initialized || walker_isDone(&body)) return false;
+
+  if (!walker_update(&body, data, len)) return false;
+  sha256_Update(&ctx, data, len);
+
+  if (walker_isDone(&body)) {
+    uint8_t tag = SIGNDOC_AUTH_INFO_BYTES;
+    sha256_Update(&ctx, &tag, 1);
+    hash_varint(auth_info.total);
+  }
+
+  return true;
+}
+
+bool cosmos_directUpdateAuthInfo(const uint8_t *data, size_t len) {
+  if (!initialized || !walker_isDone(&body) || walker_isDone(&auth_info))
+    return false;
+
+  if (!walker_update(&auth_info, data, len)) return false;
+  sha256_Update(&ctx, data, len);
+  return true;
+}
+
+bool cosmos_directIsComplete(void) {
+  return initialized && walker_isDone(&body) && walker_isDone(&auth_info);
+}
+
+bool cosmos_directDigest(uint8_t hash[32]) {
+  if (!cosmos_directIsComplete()) {
+    cosmos_directAbort();
+    return false;
+  }
+
+  // proto3 leaves default valued scalars off the wire.
+  size_t chain_id_len = strlen(chain_id);
+  if (chain_id_len) {
+    uint8_t tag = SIGNDOC_CHAIN_ID;
+    sha256_Update(&ctx, &tag, 1);
+    hash_varint(chain_id_len);
+    sha256_Update(&ctx, (const uint8_t *)chain_id, chain_id_len);
+  }
+
+  if (account_number) {
+    uint8_t tag = SIGNDOC_ACCOUNT_NUMBER;
+    sha256_Update(&ctx, &tag, 1);
+    hash_varint(account_number);
+  }
+
+  sha256_Final(&ctx, hash);
+  return true;
+}
+
+bool cosmos_directFinalize(uint8_t *public_key, uint8_t *signature) {
+  uint8_t hash[SHA256_DIGEST_LENGTH];
+  if (!cosmos_directDigest(hash)) return false;
+
+  hdnode_fill_public_key(&node);
+  memcpy(public_key, node.public_key, 33);
+
+  bool ok = ecdsa_sign_digest(&secp256k1, node.private_key, hash, signature,
+                              NULL, NULL) == 0;
+  memzero(hash, sizeof(hash));
+  cosmos_directAbort();
+  return ok;
+}
+
+bool cosmos_directIsInited(void) { return initialized; }
+
+void cosmos_directAbort(void) {
+  initialized = false;
+  review = NULL;
+  account_number = 0;
+  memzero(&node, sizeof(node));
+  memzero(&ctx, sizeof(ctx));
+  memzero(&body, sizeof(body));
+  memzero(&auth_info, sizeof(auth_info));
+  memzero(field_buf, sizeof(field_buf));
+  field_len = 0;
+  memzero(chain_id, sizeof(chain_id));
+}
+
+/// Reads a length delimited field as a view into the decoded buffer.
+static bool decode_view(pb_istream_t *stream, const uint8_t *base,
+                        size_t base_len, const uint8_t **view,
+                        size_t *view_len) {
+  uint32_t size;
+  if (!pb_decode_varint32(stream, &size)) return false;
+  if (size > stream->bytes_left) return false;
+
+  *view = base + (base_len - stream->bytes_left);
+  *view_len = size;
+  return pb_read(stream, NULL, size);
+}
+
+bool cosmos_directDecodeAny(const uint8_t *data, size_t len,
+                            CosmosDirectAny *any) {
+  memset(any, 0, sizeof(*any));
+  pb_istream_t stream = pb_istream_from_buffer(data, len);
+
+  while (stream.bytes_left) {
+    pb_wire_type_t wire;
+    uint32_t tag;
+    bool eof;
+    if (!pb_decode_tag(&stream, &wire, &tag, &eof)) return false;
+
+    if (tag == 1 && wire == PB_WT_STRING) {
+      if (!decode_view(&stream, data, len, (const uint8_t **)&any->type_url,
+                       &any->type_url_len))
+        return false;
+    } else if (tag == 2 && wire == PB_WT_STRING) {
+      if (!decode_view(&stream, data, len, &any->value, &any->value_len))
+        return false;
+    } else if (!pb_skip_field(&stream, wire)) {
+      return false;
+    }
+  }
+
+  return any->type_url_len != 0;
+}
+
+static bool decode_coin(const uint8_t *data, size_t len,
+                        CosmosDirectFee *fee) {
+  pb_istream_t stream = pb_istream_from_buffer(data, len);
+
+  while (stream.bytes_left) {
+    pb_wire_type_t wire;
+    uint32_t tag;
+    bool eof;
+    if (!pb_decode_tag(&stream, &wire, &tag, &eof)) return false;
+
+    if (tag == 1 && wire == PB_WT_STRING) {
+      if (!decode_view(&stream, data, len, (const uint8_t **)&fee->denom,
+                       &fee->denom_len))
+        return false;
+    } else if (tag == 2 && wire == PB_WT_STRING) {
+      if (!decode_view(&stream, data, len, (const uint8_t **)&fee->amount,
+                       &fee->amount_len))
+        return false;
+    } else if (!pb_skip_field(&stream, wire)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool cosmos_directDecodeFee(const uint8_t *data, size_t len,
+                            CosmosDirectFee *fee) {
+  memset(fee, 0, sizeof(*fee));
+  pb_istream_t stream = pb_istream_from_buffer(data, len);
+
+  while (stream.bytes_left) {
+    pb_wire_type_t wire;
+    uint32_t tag;
+    bool eof;
+    if (!pb_decode_tag(&stream, &wire, &tag, &eof)) return false;
+
+    if (tag == 1 && wire == PB_WT_STRING) {
+      const uint8_t *coin;
+      size_t coin_len;
+      if (!decode_view(&stream, data, len, &coin, &coin_len)) return false;
+      if (fee->coin_count++ == 0 && !decode_coin(coin, coin_len, fee))
+        return false;
+    } else if (tag == 2 && wire == PB_WT_VARINT) {
+      if (!pb_decode_varint(&stream, &fee->gas_limit)) return false;
+    } else if (!pb_skip_field(&stream, wire)) {
+      return false;
+    }
+  }
+
+  return true;
+}
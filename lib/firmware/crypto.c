@@ -18,7 +18,9 @@
  * along with this library.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "keepkey/board/confirm_sm.h"
 #include "keepkey/board/layout.h"
+#include "keepkey/board/memcmp_s.h"
 #include "keepkey/firmware/coins.h"
 #include "keepkey/firmware/crypto.h"
 #include "trezor/crypto/address.h"
@@ -36,6 +38,11 @@
 
 #include <string.h>
 
+// Must match deps/crypto/ecdsa_curve_size.c: trezor-crypto and the firmware
+// have to be built with the same USE_PRECOMPUTED_CP.
+_Static_assert(sizeof(ecdsa_curve) == KK_ECDSA_CURVE_SIZE,
+               "firmware built with a different USE_PRECOMPUTED_CP");
+
 uint32_t ser_length(uint32_t len, uint8_t *out) {
   if (len < 253) {
     out[0] = len & 0xFF;
@@ -135,33 +142,61 @@ int cryptoGetECDHSessionKey(const HDNode *node, const uint8_t *peer_public_key,
 _Static_assert(sizeof(((CoinType *)0)->signed_message_header) < 256,
                "Message header too long");
 
-static void cryptoMessageHash(const CoinType *coin, const curve_info *curve,
-                              const uint8_t *message, size_t message_len,
-                              uint8_t hash[HASHER_DIGEST_LENGTH]) {
-  Hasher hasher;
-  hasher_Init(&hasher, curve->hasher_sign);
+bool cryptoMessageHashInit(CryptoMessageHasher *ctx, const CoinType *coin,
+                           uint32_t message_len) {
+  memzero(ctx, sizeof(*ctx));
+
+  const curve_info *curve = get_curve_by_name(coin->curve_name);
+  if (!curve) return false;
+
+  if (!coin->has_signed_message_header) return false;
+
+  hasher_Init(&ctx->hasher, curve->hasher_sign);
   uint8_t header_len = strlen(coin->signed_message_header);
-  hasher_Update(&hasher, &header_len, 1);
-  hasher_Update(&hasher, (const uint8_t *)coin->signed_message_header,
-                strlen(coin->signed_message_header));
-  uint8_t varint[5];
-  uint32_t l = ser_length(message_len, varint);
-  hasher_Update(&hasher, varint, l);
-  hasher_Update(&hasher, message, message_len);
-  hasher_Final(&hasher, hash);
+  hasher_Update(&ctx->hasher, &header_len, 1);
+  hasher_Update(&ctx->hasher, (const uint8_t *)coin->signed_message_header,
+                header_len);
+  ser_length_hash(&ctx->hasher, message_len);
+  ctx->remaining = message_len;
+  return true;
+}
+
+bool cryptoMessageHashUpdate(CryptoMessageHasher *ctx, const uint8_t *data,
+                             size_t len) {
+  if (len > ctx->remaining) return false;
+
+  hasher_Update(&ctx->hasher, data, len);
+  ctx->remaining -= len;
+  return true;
+}
+
+bool cryptoMessageHashFinal(CryptoMessageHasher *ctx,
+                            uint8_t hash[HASHER_DIGEST_LENGTH]) {
+  if (ctx->remaining != 0) return false;
+  hasher_Final(&ctx->hasher, hash);
+  return true;
+}
+
+static bool cryptoMessageHash(const CoinType *coin, const uint8_t *message,
+                              size_t message_len,
+                              uint8_t hash[HASHER_DIGEST_LENGTH]) {
+  CryptoMessageHasher ctx;
+  return cryptoMessageHashInit(&ctx, coin, message_len) &&
+         cryptoMessageHashUpdate(&ctx, message, message_len) &&
+         cryptoMessageHashFinal(&ctx, hash);
 }
 
 int cryptoMessageSign(const CoinType *coin, HDNode *node,
                       InputScriptType script_type, const uint8_t *message,
                       size_t message_len, uint8_t *signature) {
-  const curve_info *curve = get_curve_by_name(coin->curve_name);
-  if (!curve) return 1;
-
-  if (!coin->has_signed_message_header) return 1;
-
   uint8_t hash[HASHER_DIGEST_LENGTH];
-  cryptoMessageHash(coin, curve, message, message_len, hash);
+  if (!cryptoMessageHash(coin, message, message_len, hash)) return 1;
 
+  return cryptoMessageSignDigest(node, script_type, hash, signature);
+}
+
+int cryptoMessageSignDigest(HDNode *node, InputScriptType script_type,
+                            const uint8_t *hash, uint8_t *signature) {
   uint8_t pby;
   int result = hdnode_sign_digest(node, hash, signature + 1, &pby, NULL);
   if (result == 0) {
@@ -186,6 +221,14 @@ int cryptoMessageSign(const CoinType *coin, HDNode *node,
 int cryptoMessageVerify(const CoinType *coin, const uint8_t *message,
                         size_t message_len, const char *address,
                         const uint8_t *signature) {
+  uint8_t hash[HASHER_DIGEST_LENGTH];
+  if (!cryptoMessageHash(coin, message, message_len, hash)) return 1;
+
+  return cryptoMessageVerifyDigest(coin, hash, address, signature);
+}
+
+int cryptoMessageVerifyDigest(const CoinType *coin, const uint8_t *hash,
+                              const char *address, const uint8_t *signature) {
   // check for invalid signature prefix
   if (signature[0] < 27 || signature[0] > 43) {
     return 1;
@@ -194,11 +237,6 @@ int cryptoMessageVerify(const CoinType *coin, const uint8_t *message,
   const curve_info *curve = get_curve_by_name(coin->curve_name);
   if (!curve) return 1;
 
-  if (!coin->has_signed_message_header) return 1;
-
-  uint8_t hash[HASHER_DIGEST_LENGTH];
-  cryptoMessageHash(coin, curve, message, message_len, hash);
-
   uint8_t recid = (signature[0] - 27) % 4;
   bool compressed = signature[0] >= 31;
 
@@ -267,30 +305,123 @@ int cryptoMessageVerify(const CoinType *coin, const uint8_t *message,
   return 0;
 }
 
+#define COSIGNER_PATH_MAX \
+  (sizeof(((HDNodePathType *)0)->address_n) / sizeof(uint32_t))
+
+/// A cosigner xpub, derived along every step of a path but the last.
+/// Multisig inputs and change outputs of one wallet share that prefix, so
+/// each of them only needs the final non-hardened step.
+typedef struct {
+  bool valid;
+  const char *curve_name;
+  uint32_t depth;
+  uint32_t child_num;
+  uint8_t chain_code[32];
+  uint8_t public_key[33];
+  uint32_t prefix[COSIGNER_PATH_MAX];
+  size_t prefix_count;
+  HDNode node;
+  bool has_leaf;
+  uint32_t leaf;
+  uint8_t leaf_pubkey[33];
+} CosignerCacheEntry;
+
+static CosignerCacheEntry cosigner_cache[CRYPTO_COSIGNER_CACHE_SIZE];
+static size_t cosigner_cache_next;
+
+void cryptoCosignerCacheClear(void) {
+  memzero(cosigner_cache, sizeof(cosigner_cache));
+  cosigner_cache_next = 0;
+}
+
+static bool cosigner_matches(const CosignerCacheEntry *entry,
+                             const CoinType *coin,
+                             const HDNodePathType *hdnodepath,
+                             size_t prefix_count) {
+  return entry->valid && entry->curve_name == coin->curve_name &&
+         entry->depth == hdnodepath->node.depth &&
+         entry->child_num == hdnodepath->node.child_num &&
+         entry->prefix_count == prefix_count &&
+         memcmp(entry->chain_code, hdnodepath->node.chain_code.bytes, 32) ==
+             0 &&
+         memcmp(entry->public_key, hdnodepath->node.public_key.bytes, 33) ==
+             0 &&
+         memcmp(entry->prefix, hdnodepath->address_n,
+                prefix_count * sizeof(uint32_t)) == 0;
+}
+
+static CosignerCacheEntry *cosigner_derive(const CoinType *coin,
+                                           const HDNodePathType *hdnodepath,
+                                           size_t prefix_count) {
+  for (size_t i = 0; i < CRYPTO_COSIGNER_CACHE_SIZE; i++) {
+    if (cosigner_matches(&cosigner_cache[i], coin, hdnodepath, prefix_count)) {
+      return &cosigner_cache[i];
+    }
+  }
+
+  CosignerCacheEntry *entry =
+      &cosigner_cache[cosigner_cache_next++ % CRYPTO_COSIGNER_CACHE_SIZE];
+  memzero(entry, sizeof(*entry));
+
+  if (hdnode_from_xpub(hdnodepath->node.depth, hdnodepath->node.child_num,
+                       hdnodepath->node.chain_code.bytes,
+                       hdnodepath->node.public_key.bytes, coin->curve_name,
+                       &entry->node) == 0) {
+    return NULL;
+  }
+  animating_progress_handler("Deriving pubkey...", 0);
+  for (size_t i = 0; i < prefix_count; i++) {
+    if (hdnode_public_ckd(&entry->node, hdnodepath->address_n[i]) == 0) {
+      memzero(entry, sizeof(*entry));
+      return NULL;
+    }
+    animating_progress_handler("Deriving pubkey...", (i * 1000) / prefix_count);
+  }
+
+  entry->curve_name = coin->curve_name;
+  entry->depth = hdnodepath->node.depth;
+  entry->child_num = hdnodepath->node.child_num;
+  memcpy(entry->chain_code, hdnodepath->node.chain_code.bytes, 32);
+  memcpy(entry->public_key, hdnodepath->node.public_key.bytes, 33);
+  memcpy(entry->prefix, hdnodepath->address_n, prefix_count * sizeof(uint32_t));
+  entry->prefix_count = prefix_count;
+  entry->valid = true;
+  return entry;
+}
+
 uint8_t *cryptoHDNodePathToPubkey(const CoinType *coin,
                                   const HDNodePathType *hdnodepath) {
   if (!hdnodepath ||
       !hdnodepath->node.has_public_key ||
-      hdnodepath->node.public_key.size != 33) {
+      hdnodepath->node.public_key.size != 33 ||
+      hdnodepath->node.chain_code.size != 32 ||
+      hdnodepath->address_n_count > COSIGNER_PATH_MAX) {
     return 0;
   }
 
-  static HDNode node;
-  if (hdnode_from_xpub(hdnodepath->node.depth, hdnodepath->node.child_num,
-                       hdnodepath->node.chain_code.bytes,
-                       hdnodepath->node.public_key.bytes, coin->curve_name,
-                       &node) == 0) {
+  const size_t count = hdnodepath->address_n_count;
+  CosignerCacheEntry *entry =
+      cosigner_derive(coin, hdnodepath, count ? count - 1 : 0);
+  if (!entry) {
     return 0;
   }
-  animating_progress_handler("Deriving pubkey...", 0);
-  for (uint32_t i = 0; i < hdnodepath->address_n_count; i++) {
-    if (hdnode_public_ckd(&node, hdnodepath->address_n[i]) == 0) {
+
+  if (count == 0) {
+    return entry->node.public_key;
+  }
+
+  const uint32_t leaf = hdnodepath->address_n[count - 1];
+  if (!entry->has_leaf || entry->leaf != leaf) {
+    static HDNode node;
+    memcpy(&node, &entry->node, sizeof(node));
+    if (hdnode_public_ckd(&node, leaf) == 0) {
       return 0;
     }
-    animating_progress_handler("Deriving pubkey...",
-                               (i * 1000) / hdnodepath->address_n_count);
+    memcpy(entry->leaf_pubkey, node.public_key, 33);
+    entry->leaf = leaf;
+    entry->has_leaf = true;
   }
-  return node.public_key;
+  return entry->leaf_pubkey;
 }
 
 int cryptoMultisigPubkeyIndex(const CoinType *coin,
@@ -385,3 +516,66 @@ int cryptoIdentityFingerprint(const IdentityType *identity, uint8_t *hash) {
   sha256_Final(&ctx, hash);
   return 1;
 }
+
+typedef struct {
+  const ecdsa_curve *curve;
+  uint8_t priv_key[32];
+  uint8_t digest[32];
+  int (*is_canonical)(uint8_t by, uint8_t sig[64]);
+  bool pending;  // waiting for the confirmation to run presign_work
+  bool done;
+  int result;
+  uint8_t sig[64];
+  uint8_t by;
+} PresignState;
+
+static CONFIDENTIAL PresignState presign;
+
+static void presign_work(void) {
+  if (!presign.pending) return;
+  presign.pending = false;
+  // RFC6979 nonces make this the same signature cryptoSignDigest would
+  // compute later; nearly all of the time goes into R = k*G.
+  presign.result =
+      ecdsa_sign_digest(presign.curve, presign.priv_key, presign.digest,
+                        presign.sig, &presign.by, presign.is_canonical);
+  presign.done = true;
+}
+
+void cryptoPresignDigest(const ecdsa_curve *curve, const uint8_t *priv_key,
+                         const uint8_t *digest,
+                         int (*is_canonical)(uint8_t by, uint8_t sig[64])) {
+  cryptoPresignClear();
+  presign.curve = curve;
+  memcpy(presign.priv_key, priv_key, sizeof(presign.priv_key));
+  memcpy(presign.digest, digest, sizeof(presign.digest));
+  presign.is_canonical = is_canonical;
+  presign.pending = true;
+  confirm_setIdleWork(presign_work);
+}
+
+int cryptoSignDigest(const ecdsa_curve *curve, const uint8_t *priv_key,
+                     const uint8_t *digest, uint8_t *sig, uint8_t *pby,
+                     int (*is_canonical)(uint8_t by, uint8_t sig[64])) {
+  bool hit = presign.done && presign.curve == curve &&
+             presign.is_canonical == is_canonical &&
+             memcmp_s(presign.priv_key, priv_key, 32) == 0 &&
+             memcmp_s(presign.digest, digest, 32) == 0;
+  if (!hit) {
+    cryptoPresignClear();
+    return ecdsa_sign_digest(curve, priv_key, digest, sig, pby, is_canonical);
+  }
+
+  int result = presign.result;
+  memcpy(sig, presign.sig, 64);
+  if (pby) {
+    *pby = presign.by;
+  }
+  cryptoPresignClear();
+  return result;
+}
+
+void cryptoPresignClear(void) {
+  confirm_setIdleWork(NULL);
+  memzero(&presign, sizeof(presign));
+}
@@ -0,0 +1,240 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2018 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/eos-contracts/abi.h"
+
+#include "keepkey/board/confirm_sm.h"
+#include "keepkey/board/keepkey_board.h"
+#include "keepkey/firmware/app_confirm.h"
+#include "keepkey/firmware/eos.h"
+
+#include "messages-eos.pb.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/// Longest string field shown, same as the eosio.token transfer memo limit.
+#define EOS_ABI_STRING_MAX 256
+
+/// Names shown per screen for EosAbi_NameVector.
+#define EOS_ABI_NAMES_PER_PAGE 6
+
+static const EosAbiAction abis[] = {
+    {EOS_eosio_token,
+     EOS_Transfer,
+     "Transfer",
+     4,
+     {{EosAbi_Name, "From"},
+      {EosAbi_Name, "To"},
+      {EosAbi_Asset, "Quantity"},
+      {EosAbi_String, "Memo"}}},
+    {EOS_eosio,
+     EOS_DelegateBW,
+     "Delegate",
+     5,
+     {{EosAbi_Name, "From"},
+      {EosAbi_Name, "Receiver"},
+      {EosAbi_Asset, "NET"},
+      {EosAbi_Asset, "CPU"},
+      {EosAbi_Bool, "Transfer"}}},
+    {EOS_eosio,
+     EOS_UndelegateBW,
+     "Undelegate",
+     4,
+     {{EosAbi_Name, "From"},
+      {EosAbi_Name, "Receiver"},
+      {EosAbi_Asset, "NET"},
+      {EosAbi_Asset, "CPU"}}},
+    {EOS_eosio, EOS_Refund, "Refund", 1, {{EosAbi_Name, "Owner"}}},
+    {EOS_eosio,
+     EOS_BuyRam,
+     "Buy RAM",
+     3,
+     {{EosAbi_Name, "Payer"},
+      {EosAbi_Name, "Receiver"},
+      {EosAbi_Asset, "Quantity"}}},
+    {EOS_eosio,
+     EOS_BuyRamBytes,
+     "Buy RAM",
+     3,
+     {{EosAbi_Name, "Payer"},
+      {EosAbi_Name, "Receiver"},
+      {EosAbi_Uint32, "Bytes"}}},
+    {EOS_eosio,
+     EOS_SellRam,
+     "Sell RAM",
+     2,
+     {{EosAbi_Name, "Account"}, {EosAbi_Int64, "Bytes"}}},
+    {EOS_eosio,
+     EOS_VoteProducer,
+     "Vote Producer",
+     3,
+     {{EosAbi_Name, "Voter"},
+      {EosAbi_Name, "Proxy"},
+      {EosAbi_NameVector, "Producers"}}},
+};
+
+const EosAbiAction *eos_abiFind(uint64_t account, uint64_t name) {
+  for (size_t i = 0; i < sizeof(abis) / sizeof(abis[0]); i++) {
+    if (abis[i].account == account && abis[i].name == name) return &abis[i];
+  }
+  return NULL;
+}
+
+static bool abi_read(const uint8_t **p, const uint8_t *end, void *out,
+                     size_t len) {
+  if ((size_t)(end - *p) < len) return false;
+  memcpy(out, *p, len);
+  *p += len;
+  return true;
+}
+
+static bool abi_confirmField(const char *title, const char *label,
+                             const char *value) {
+  return confirm(ButtonRequestType_ButtonRequest_ConfirmEosAction, title,
+                 "%s: %s", label, value);
+}
+
+static bool abi_confirmNames(const char *title, const EosAbiField *field,
+                             const uint8_t *names, uint64_t count) {
+  if (count == 0) return abi_confirmField(title, field->label, "none");
+
+  const uint64_t pages =
+      (count + EOS_ABI_NAMES_PER_PAGE - 1) / EOS_ABI_NAMES_PER_PAGE;
+  for (uint64_t page = 0; page < pages; page++) {
+    char list[(EOS_NAME_STR_SIZE + 2) * EOS_ABI_NAMES_PER_PAGE + 1] = {0};
+    const uint64_t first = page * EOS_ABI_NAMES_PER_PAGE;
+    for (uint64_t i = first; i < count && i < first + EOS_ABI_NAMES_PER_PAGE;
+         i++) {
+      uint64_t value;
+      memcpy(&value, names + 8 * i, 8);
+      char name[EOS_NAME_STR_SIZE];
+      if (!eos_formatName(value, name)) return false;
+      if (i != first) strlcat(list, ", ", sizeof(list));
+      strlcat(list, name, sizeof(list));
+    }
+
+    char label[SMALL_STR_BUF];
+    snprintf(label, sizeof(label), "%s %" PRIu32 "/%" PRIu32, field->label,
+             (uint32_t)(page + 1), (uint32_t)pages);
+    if (!abi_confirmField(title, label, list)) return false;
+  }
+  return true;
+}
+
+/// Walks the action data field by field. Nothing is shown unless \p show.
+static bool abi_walk(const EosAbiAction *abi, const uint8_t *data, size_t len,
+                     bool show) {
+  const uint8_t *p = data;
+  const uint8_t *end = data + len;
+
+  for (size_t f = 0; f < abi->field_count; f++) {
+    const EosAbiField *field = &abi->fields[f];
+    char value[EOS_ASSET_STR_SIZE];
+
+    switch (field->type) {
+      case EosAbi_Name: {
+        uint64_t name;
+        if (!abi_read(&p, end, &name, 8)) return false;
+        if (!eos_formatName(name, value)) return false;
+        if (name == 0) strlcpy(value, "none", sizeof(value));
+        break;
+      }
+      case EosAbi_Asset: {
+        EosAsset asset;
+        memset(&asset, 0, sizeof(asset));
+        asset.has_amount = asset.has_symbol = true;
+        if (!abi_read(&p, end, &asset.amount, 8)) return false;
+        if (!abi_read(&p, end, &asset.symbol, 8)) return false;
+        if (!eos_formatAsset(&asset, value)) return false;
+        break;
+      }
+      case EosAbi_String: {
+        uint64_t str_len;
+        if (!eos_decodeUInt(&p, end, &str_len)) return false;
+        if (EOS_ABI_STRING_MAX < str_len || (uint64_t)(end - p) < str_len)
+          return false;
+        if (show && str_len) {
+          char title[MEDIUM_STR_BUF];
+          snprintf(title, sizeof(title), "Confirm %s (%" PRIu32 " bytes)",
+                   field->label, (uint32_t)str_len);
+          if (!confirm_data(ButtonRequestType_ButtonRequest_ConfirmMemo, title,
+                            p, str_len)) {
+            return false;
+          }
+        }
+        p += str_len;
+        continue;
+      }
+      case EosAbi_Bool: {
+        uint8_t b;
+        if (!abi_read(&p, end, &b, 1) || 1 < b) return false;
+        strlcpy(value, b ? "yes" : "no", sizeof(value));
+        break;
+      }
+      case EosAbi_Uint32: {
+        uint32_t u;
+        if (!abi_read(&p, end, &u, 4)) return false;
+        snprintf(value, sizeof(value), "%" PRIu32, u);
+        break;
+      }
+      case EosAbi_Int64: {
+        int64_t i;
+        if (!abi_read(&p, end, &i, 8)) return false;
+        snprintf(value, sizeof(value), "%" PRId64, i);
+        break;
+      }
+      case EosAbi_NameVector: {
+        uint64_t count;
+        if (!eos_decodeUInt(&p, end, &count)) return false;
+        if ((uint64_t)(end - p) / 8 < count) return false;
+        const uint8_t *names = p;
+        uint64_t prev = 0;
+        for (uint64_t i = 0; i < count; i++) {
+          uint64_t name;
+          memcpy(&name, p, 8);
+          p += 8;
+          // The contract also enforces this
+          if (i != 0 && name <= prev) return false;
+          prev = name;
+        }
+        if (show && !abi_confirmNames(abi->title, field, names, count))
+          return false;
+        continue;
+      }
+      default:
+        return false;
+    }
+
+    if (show && !abi_confirmField(abi->title, field->label, value))
+      return false;
+  }
+
+  return p == end;
+}
+
+bool eos_abiValidate(const EosAbiAction *abi, const uint8_t *data,
+                     size_t len) {
+  return abi_walk(abi, data, len, /*show=*/false);
+}
+
+bool eos_abiConfirm(const EosAbiAction *abi, const uint8_t *data, size_t len) {
+  return abi_walk(abi, data, len, /*show=*/true);
+}
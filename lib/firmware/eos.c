@@ -21,6 +21,8 @@
 
 #include "eos.h"
 
+#include "keepkey/firmware/eos-contracts/abi.h"
+
 #include "keepkey/board/confirm_sm.h"
 #include "keepkey/board/keepkey_board.h"
 #include "keepkey/board/util.h"
@@ -51,6 +53,17 @@ static uint32_t actions_remaining = 0;
 static uint32_t unknown_total = 0;
 static uint32_t unknown_remaining = 0;
 
+/// Largest single packed action: account, name, authorizations and data.
+/// Fits a voteproducer for 30 producers with a dozen authorizations.
+#define EOS_PACKED_ACTION_MAX 512
+
+/// Bytes of the packed action currently being received. Actions may span
+/// EosActionUnknown chunks, so the tail of a chunk is kept until the rest
+/// of its action arrives.
+static bool packing = false;
+static uint8_t packed[EOS_PACKED_ACTION_MAX];
+static size_t packed_len = 0;
+
 bool eos_formatAsset(const EosAsset *asset, char str[EOS_ASSET_STR_SIZE]) {
   memset(str, 0, EOS_ASSET_STR_SIZE);
   char *s = str;
@@ -279,6 +292,16 @@ size_t eos_hashUInt(Hasher *hasher, uint64_t val) {
   return count;
 }
 
+bool eos_decodeUInt(const uint8_t **data, const uint8_t *end, uint64_t *val) {
+  *val = 0;
+  for (unsigned shift = 0; *data < end && shift < 64; shift += 7) {
+    uint8_t b = *(*data)++;
+    *val |= (uint64_t)(b & 0x7f) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
 void eos_signingInit(const uint8_t *chain_id, uint32_t num_actions,
                      const EosTxHeader *_header, const HDNode *_root,
                      const uint32_t _address_n[8], size_t _address_n_count) {
@@ -307,6 +330,8 @@ void eos_signingInit(const uint8_t *chain_id, uint32_t num_actions,
   unknown_remaining = 0;
   unknown_total = 0;
   hasher_Init(&hasher_unknown, HASHER_SHA2);
+  packing = false;
+  packed_len = 0;
 
   actions_remaining = num_actions;
   inited = true;
@@ -332,6 +357,9 @@ void eos_signingAbort(void) {
   actions_remaining = 0;
   unknown_remaining = 0;
   unknown_total = 0;
+  packing = false;
+  memzero(packed, sizeof(packed));
+  packed_len = 0;
 }
 
 bool eos_compileAsset(const EosAsset *asset) {
@@ -418,6 +446,14 @@ bool eos_compileActionUnknown(const EosActionCommon *common,
     return false;
   }
 
+  if (packing) {
+    fsm_sendFailure(FailureType_Failure_SyntaxError,
+                    "Expected more packed action data chunks");
+    eos_signingAbort();
+    layoutHome();
+    return false;
+  }
+
   if (!storage_isPolicyEnabled("AdvancedMode")) {
     (void)review(ButtonRequestType_ButtonRequest_Other, "Warning",
                  "Signing of arbitrary EOS actions is recommended only for "
@@ -485,6 +521,185 @@ bool eos_compileActionUnknown(const EosActionCommon *common,
   return true;
 }
 
+static bool packedActionsFailed(FailureType type, const char *reason) {
+  fsm_sendFailure(type, reason);
+  eos_signingAbort();
+  layoutHome();
+  return false;
+}
+
+bool eos_isPackedActions(const EosActionCommon *common) {
+  return common->has_account && common->account == EOS_PackedActions &&
+         common->has_name && common->name == EOS_Packed &&
+         common->authorization_count == 0;
+}
+
+typedef struct _EosPackedAction {
+  uint64_t account;
+  uint64_t name;
+  const uint8_t *auth;
+  uint64_t auth_count;
+  const uint8_t *data;
+  uint64_t data_len;
+} EosPackedAction;
+
+/// Reads a varint, telling a value cut short by the end of the buffer apart
+/// from a malformed one.
+/// \returns 1 if read, 0 if more bytes are needed, -1 if malformed.
+static int packedReadUInt(const uint8_t **p, const uint8_t *end,
+                          uint64_t *val) {
+  const uint8_t *start = *p;
+  if (eos_decodeUInt(p, end, val)) return 1;
+  return end - start < 10 ? 0 : -1;
+}
+
+/// Parses the serialized eosio::action at the start of buf.
+/// \returns its length, 0 if buf holds only part of it, or -1 if it is
+/// malformed or longer than EOS_PACKED_ACTION_MAX.
+static int packedActionParse(const uint8_t *buf, size_t len,
+                             EosPackedAction *action) {
+  const uint8_t *p = buf;
+  const uint8_t *end = buf + len;
+
+  if (len < 16) return 0;
+  memcpy(&action->account, p, 8);
+  memcpy(&action->name, p + 8, 8);
+  p += 16;
+
+  int status = packedReadUInt(&p, end, &action->auth_count);
+  if (status <= 0) return status;
+  if (action->auth_count == 0 ||
+      EOS_PACKED_ACTION_MAX / 16 < action->auth_count)
+    return -1;
+  if ((uint64_t)(end - p) / 16 < action->auth_count) return 0;
+  action->auth = p;
+  p += 16 * action->auth_count;
+
+  status = packedReadUInt(&p, end, &action->data_len);
+  if (status <= 0) return status;
+  if (EOS_PACKED_ACTION_MAX < action->data_len) return -1;
+  if ((uint64_t)(end - p) < action->data_len) return 0;
+  action->data = p;
+  p += action->data_len;
+
+  if (EOS_PACKED_ACTION_MAX < p - buf) return -1;
+  return p - buf;
+}
+
+static bool packedConfirmAuthorization(const EosAbiAction *abi,
+                                       const EosPackedAction *action) {
+  for (uint64_t i = 0; i < action->auth_count; i++) {
+    uint64_t actor, permission;
+    memcpy(&actor, action->auth + 16 * i, 8);
+    memcpy(&permission, action->auth + 16 * i + 8, 8);
+
+    char actor_str[EOS_NAME_STR_SIZE], permission_str[EOS_NAME_STR_SIZE];
+    if (!eos_formatName(actor, actor_str) ||
+        !eos_formatName(permission, permission_str))
+      return false;
+
+    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmEosAction, abi->title,
+                 "Authorization %" PRIu32 "/%" PRIu32 ":\n%s@%s",
+                 (uint32_t)(i + 1), (uint32_t)action->auth_count, actor_str,
+                 permission_str))
+      return false;
+  }
+  return true;
+}
+
+/// Compiles every complete action at the start of the packed buffer, and
+/// drops them from it.
+static bool packedActionsConsume(void) {
+  size_t used = 0;
+
+  while (used < packed_len) {
+    // Each entry is a serialized eosio::action, which is also exactly what
+    // goes into the preimage.
+    EosPackedAction action;
+    int len = packedActionParse(packed + used, packed_len - used, &action);
+    if (len < 0)
+      return packedActionsFailed(FailureType_Failure_SyntaxError,
+                                 "Malformed packed action");
+    if (len == 0) break;
+
+    const EosAbiAction *abi = eos_abiFind(action.account, action.name);
+    if (!abi)
+      return packedActionsFailed(
+          FailureType_Failure_SyntaxError,
+          "Packed actions must be supported contract actions");
+
+    if (!eos_abiValidate(abi, action.data, action.data_len))
+      return packedActionsFailed(FailureType_Failure_SyntaxError,
+                                 "Malformed packed action data");
+
+    if (actions_remaining == 0)
+      return packedActionsFailed(FailureType_Failure_SyntaxError,
+                                 "Action count mismatch");
+
+    if (!packedConfirmAuthorization(abi, &action) ||
+        !eos_abiConfirm(abi, action.data, action.data_len))
+      return packedActionsFailed(FailureType_Failure_ActionCancelled,
+                                 "Action Cancelled");
+
+    actions_remaining--;
+    hasher_Update(&hasher_preimage, packed + used, len);
+    used += len;
+  }
+
+  memmove(packed, packed + used, packed_len - used);
+  packed_len -= used;
+  return true;
+}
+
+bool eos_compileActionsPacked(const EosActionUnknown *action) {
+  if (unknown_remaining == 0) {
+    if (action->data_size == 0)
+      return packedActionsFailed(FailureType_Failure_SyntaxError,
+                                 "Empty packed actions");
+    packing = true;
+    packed_len = 0;
+    unknown_total = unknown_remaining = action->data_size;
+  } else if (!packing) {
+    return packedActionsFailed(FailureType_Failure_SyntaxError,
+                               "Expected more EOSActionUnknown data chunks");
+  } else if (action->data_size != unknown_total) {
+    return packedActionsFailed(
+        FailureType_Failure_SyntaxError,
+        "EosActionUnknown unexpected change in total length");
+  }
+
+  if (unknown_remaining < action->data_chunk.size)
+    return packedActionsFailed(FailureType_Failure_SyntaxError,
+                               "EosActionUnknown unexpected data chunk size");
+  unknown_remaining -= action->data_chunk.size;
+
+  const uint8_t *chunk = action->data_chunk.bytes;
+  size_t chunk_len = action->data_chunk.size;
+  while (chunk_len) {
+    size_t n = MIN(chunk_len, sizeof(packed) - packed_len);
+    memcpy(packed + packed_len, chunk, n);
+    packed_len += n;
+    chunk += n;
+    chunk_len -= n;
+
+    if (!packedActionsConsume()) return false;
+
+    // Whatever is left is the start of a single action
+    if (packed_len == sizeof(packed))
+      return packedActionsFailed(FailureType_Failure_SyntaxError,
+                                 "Packed action too large");
+  }
+
+  if (unknown_remaining == 0) {
+    packing = false;
+    if (packed_len != 0)
+      return packedActionsFailed(FailureType_Failure_SyntaxError,
+                                 "Malformed packed action");
+  }
+
+  return true;
+}
+
 static int eos_is_canonic(uint8_t v, uint8_t signature[64]) {
   (void)v;
   return !(signature[0] & 0x80) &&
@@ -203,6 +203,16 @@ static void hash_rlp_number(uint32_t number) {
   hash_rlp_field(data + offset, 4 - offset);
 }
 
+/*
+ * Push the access list of a typed transaction, after the last data chunk.
+ * EthereumSignTx has no field for access list entries, so it is always empty.
+ */
+static void hash_access_list(void) {
+  if (ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY) {
+    hash_rlp_list_length(0);
+  }
+}
+
 /*
  * Calculate the number of bytes needed for an RLP length header.
  * NOTE: supports up to 16MB of data (how unlikely...)
@@ -248,11 +258,10 @@ static int ethereum_is_canonic(uint8_t v, uint8_t signature[64]) {
   return (v & 2) == 0;
 }
 
-static void send_signature(void) {
-  uint8_t hash[32], sig[64];
-  uint8_t v;
-  layoutProgress(_("Signing"), 1000);
-
+/*
+ * Finishes the hash once the data and access list are in.
+ */
+static void ethereum_hashFinal(uint8_t hash[32]) {
   if (ethereum_tx_type == ETHEREUM_TX_TYPE_LEGACY) {
     /* legacy eip-155 replay protection */
     if (chain_id) {
@@ -264,6 +273,14 @@ static void send_signature(void) {
   }
 
   keccak_Final(&keccak_ctx, hash);
+}
+
+static void send_signature(void) {
+  uint8_t hash[32], sig[64];
+  uint8_t v;
+  layoutProgress(_("Signing"), 1000);
+
+  ethereum_hashFinal(hash);
   if (ecdsa_sign_digest(&secp256k1, privkey, hash, sig, &v,
                         ethereum_is_canonic) != 0) {
     fsm_sendFailure(FailureType_Failure_Other, "Signing failed");
@@ -278,7 +295,7 @@ static void send_signature(void) {
 
   msg_tx_request.has_signature_v = true;
   if (chain_id > MAX_CHAIN_ID ||
-      ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
+      ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY) {
     msg_tx_request.signature_v = v;
   } else if (chain_id) {
     msg_tx_request.signature_v = v + 2 * chain_id + 35;
@@ -306,6 +323,92 @@ static void send_signature(void) {
 
   ethereum_signing_abort();
 }
+
+/* Format a 256 bit fixed point number with the given number of decimals.
+ * The result is byte-for-byte what bn_format(amnt, NULL, suffix, decimals, 0,
+ * false, buf, buflen) produces, but the decimal conversion runs nine digits
+ * per pass over 32 bit words instead of three per pass over bignum limbs, and
+ * the decimal point is placed by position rather than by counting digits as
+ * they are pushed. Anything that might not fit in buf is left to bn_format so
+ * that overflow behaves exactly the same.
+ * Returns the length of the formatted string.
+ */
+size_t ethereum_formatFixedPoint(const bignum256 *amnt, const char *suffix,
+                                 uint32_t decimals, char *buf, size_t buflen) {
+  // 2^256 has 78 decimal digits
+  char digits[81];
+  char *d = digits + sizeof(digits);
+  uint8_t be[32];
+  uint32_t words[8];
+
+  bn_write_be(amnt, be);
+  size_t top = 0;
+  for (size_t i = 0; i < 8; i++) {
+    words[i] = ((uint32_t)be[4 * i] << 24) | ((uint32_t)be[4 * i + 1] << 16) |
+               ((uint32_t)be[4 * i + 2] << 8) | be[4 * i + 3];
+    if (words[i] == 0 && top == i) {
+      top++;
+    }
+  }
+  memzero(be, sizeof(be));
+
+  while (top < 8) {
+    uint64_t rem = 0;
+    for (size_t i = top; i < 8; i++) {
+      uint64_t cur = (rem << 32) | words[i];
+      words[i] = (uint32_t)(cur / 1000000000);
+      rem = cur % 1000000000;
+    }
+    while (top < 8 && words[top] == 0) {
+      top++;
+    }
+    uint32_t chunk = (uint32_t)rem;
+    for (int j = 0; j < 9 && (top < 8 || chunk != 0); j++) {
+      *--d = '0' + chunk % 10;
+      chunk /= 10;
+    }
+  }
+
+  size_t ndigits = digits + sizeof(digits) - d;
+  const char *int_part = d;
+  size_t int_len = ndigits - (ndigits > decimals ? decimals : ndigits);
+  const char *frac = d + int_len;
+  size_t frac_len = ndigits - int_len;
+  size_t frac_zeros = decimals - frac_len;
+  if (int_len == 0) {
+    int_part = "0";
+    int_len = 1;
+  }
+  while (frac_len > 0 && frac[frac_len - 1] == '0') {
+    frac_len--;
+  }
+  if (frac_len == 0) {
+    frac_zeros = 0;
+  }
+
+  size_t suffixlen = suffix ? strlen(suffix) : 0;
+  size_t len = int_len + (frac_len ? 1 + frac_zeros + frac_len : 0);
+  if (len + 1 + 2 * suffixlen > buflen) {
+    return bn_format(amnt, NULL, suffix, decimals, 0, false, buf, buflen);
+  }
+
+  char *out = buf;
+  memcpy(out, int_part, int_len);
+  out += int_len;
+  if (frac_len) {
+    *out++ = '.';
+    memset(out, '0', frac_zeros);
+    out += frac_zeros;
+    memcpy(out, frac, frac_len);
+    out += frac_len;
+  }
+  if (suffixlen) {
+    memcpy(out, suffix, suffixlen);
+  }
+  out[suffixlen] = '\0';
+  return len + suffixlen;
+}
+
 /* Format a 256 bit number (amount in wei) into a human readable format
  * using standard ethereum units.
  * The buffer must be at least 25 bytes.
@@ -373,7 +476,7 @@ void ethereumFormatAmount(const bignum256 *amnt, const TokenType *token,
       }
     }
   }
-  bn_format(amnt, NULL, suffix, decimals, 0, false, buf, buflen);
+  ethereum_formatFixedPoint(amnt, suffix, decimals, buf, buflen);
 }
 
 static void layoutEthereumConfirmTx(const uint8_t *to, uint32_t to_len,
@@ -583,13 +686,29 @@ static bool ethereum_signing_check(EthereumSignTx *msg) {
     return false;
   }
 
+  // typed transactions always carry their chain id
+  if (ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY && !msg->has_chain_id) {
+    return false;
+  }
+
+  // EIP-1559 is priced by both fee caps, legacy and EIP-2930 by gas_price
+  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
+    if (!msg->has_max_fee_per_gas || !msg->has_max_priority_fee_per_gas) {
+      return false;
+    }
+  } else if (!msg->has_gas_price || msg->has_max_fee_per_gas ||
+             msg->has_max_priority_fee_per_gas) {
+    return false;
+  }
+
   return true;
 }
 
-void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
-                           bool needs_confirm) {
-  char confirm_body_message[121] = {0};
-
+/*
+ * Reads and checks the parameters of a transaction and starts its hash.
+ * Returns false, having sent a Failure, if the transaction is rejected.
+ */
+static bool ethereum_signing_start(EthereumSignTx *msg) {
   ethereum_signing = true;
   sha3_256_Init(&keccak_ctx);
 
@@ -606,7 +725,7 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
       fsm_sendFailure(FailureType_Failure_SyntaxError,
                       _("Chain Id out of bounds"));
       ethereum_signing_abort();
-      return;
+      return false;
     }
     chain_id = msg->chain_id;
   } else {
@@ -621,7 +740,7 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
       fsm_sendFailure(FailureType_Failure_SyntaxError,
                       _("Txtype out of bounds"));
       ethereum_signing_abort();
-      return;
+      return false;
     }
   } else {
     wanchain_tx_type = 0;
@@ -629,13 +748,15 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
 
   /* Ethereum tx type */
   if (msg->has_type) {
-    if (msg->type == 0 || msg->type == 2) {
+    if (msg->type == ETHEREUM_TX_TYPE_LEGACY ||
+        msg->type == ETHEREUM_TX_TYPE_EIP_2930 ||
+        msg->type == ETHEREUM_TX_TYPE_EIP_1559) {
       ethereum_tx_type = msg->type;
     } else {
       fsm_sendFailure(FailureType_Failure_SyntaxError,
                       _("Ethereum tx type out of bounds"));
       ethereum_signing_abort();
-      return;
+      return false;
     }
   } else {
     ethereum_tx_type = ETHEREUM_TX_TYPE_LEGACY;
@@ -646,7 +767,7 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
       fsm_sendFailure(FailureType_Failure_Other,
                       _("Data length provided, but no initial chunk"));
       ethereum_signing_abort();
-      return;
+      return false;
     }
     /* Our encoding only supports transactions up to 2^24 bytes.  To
      * prevent exceeding the limit we use a stricter limit on data length.
@@ -655,7 +776,7 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
       fsm_sendFailure(FailureType_Failure_SyntaxError,
                       _("Data length exceeds limit"));
       ethereum_signing_abort();
-      return;
+      return false;
     }
     data_total = msg->data_length;
   } else {
@@ -665,18 +786,121 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
     fsm_sendFailure(FailureType_Failure_Other,
                     _("Invalid size of initial chunk"));
     ethereum_signing_abort();
-    return;
+    return false;
   }
 
-  const TokenType *token = NULL;
-
   // safety checks
   if (!ethereum_signing_check(msg)) {
     fsm_sendFailure(FailureType_Failure_SyntaxError, _("Safety check failed"));
     ethereum_signing_abort();
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Hashes the transaction up to and including the initial data chunk, and the
+ * access list too if there is no more data.
+ */
+static void ethereum_hashHeader(const EthereumSignTx *msg) {
+  /* Stage 1: Calculate total RLP length */
+  uint32_t rlp_length = 0;
+  layoutProgress(_("Signing"), 0);
+
+  if (ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY) {
+    rlp_length += rlp_calculate_number_length(chain_id);
+  }
+
+  rlp_length += rlp_calculate_length(msg->nonce.size, msg->nonce.bytes[0]);
+  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
+    rlp_length += rlp_calculate_length(msg->max_priority_fee_per_gas.size,
+                                       msg->max_priority_fee_per_gas.bytes[0]);
+    rlp_length += rlp_calculate_length(msg->max_fee_per_gas.size,
+                                       msg->max_fee_per_gas.bytes[0]);
+  } else {
+    rlp_length += rlp_calculate_length(msg->gas_price.size, msg->gas_price.bytes[0]);
+  }
+
+  rlp_length += rlp_calculate_length(msg->gas_limit.size, msg->gas_limit.bytes[0]);
+  rlp_length += rlp_calculate_length(msg->to.size, msg->to.bytes[0]);
+  rlp_length += rlp_calculate_length(msg->value.size, msg->value.bytes[0]);
+  rlp_length += rlp_calculate_length(data_total, msg->data_initial_chunk.bytes[0]);
+    
+  if (ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY) {
+    rlp_length += 1;  // c0, the empty access list
+  }
+
+  if (wanchain_tx_type) {
+    rlp_length += rlp_calculate_number_length(wanchain_tx_type);
+  }
+      
+  if (ethereum_tx_type == ETHEREUM_TX_TYPE_LEGACY) {
+    // legacy EIP-155 replay protection
+    if (chain_id) {
+      rlp_length += rlp_calculate_number_length(chain_id);
+      rlp_length += rlp_calculate_length(0, 0);
+      rlp_length += rlp_calculate_length(0, 0);
+    }
+  }
+
+  // Start the hash:
+  // keccak256(0x01 || rlp([chain_id, nonce, gas_price, gas_limit,
+  //           destination, amount, data, access_list]))
+  // keccak256(0x02 || rlp([chain_id, nonce, max_priority_fee_per_gas, max_fee_per_gas,
+  //           gas_limit, destination, amount, data, access_list]))
+
+  // tx type should never be greater than one byte in length
+  // https://github.com/ethereum/EIPs/blob/master/EIPS/eip-2718.md#transactiontype-only-goes-up-to-0x7f
+  if (ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY) {
+    uint8_t datbuf[1] = {(uint8_t)ethereum_tx_type};
+    hash_data(datbuf, sizeof(datbuf));
+  }
+
+  layoutProgress(_("Signing"), 100);
+  /* Stage 2: Store header fields */
+  hash_rlp_list_length(rlp_length);
+
+  if (wanchain_tx_type) {
+    hash_rlp_number(wanchain_tx_type);
+  }
+
+  if (ethereum_tx_type != ETHEREUM_TX_TYPE_LEGACY) {
+    hash_rlp_number(chain_id);
+  }
+
+  hash_rlp_field(msg->nonce.bytes, msg->nonce.size);
+    
+  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
+    hash_rlp_field(msg->max_priority_fee_per_gas.bytes,
+                   msg->max_priority_fee_per_gas.size);
+    hash_rlp_field(msg->max_fee_per_gas.bytes, msg->max_fee_per_gas.size);
+  } else {
+    hash_rlp_field(msg->gas_price.bytes, msg->gas_price.size);
+  }
+    
+  hash_rlp_field(msg->gas_limit.bytes, msg->gas_limit.size);
+  hash_rlp_field(msg->to.bytes, msg->to.size);
+  hash_rlp_field(msg->value.bytes, msg->value.size);
+  hash_rlp_length(data_total, msg->data_initial_chunk.bytes[0]);
+  hash_data(msg->data_initial_chunk.bytes, msg->data_initial_chunk.size);
+  data_left = data_total - msg->data_initial_chunk.size;
+
+  if (data_left == 0) {
+    hash_access_list();
+  }
+}
+
+void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
+                           bool needs_confirm) {
+  char confirm_body_message[121] = {0};
+
+  if (!ethereum_signing_start(msg)) {
     return;
   }
 
+  const TokenType *token = NULL;
+
   bool data_needs_confirm = true;
   if (ethereum_contractHandled(data_total, msg, node)) {
     if (!ethereum_contractConfirmed(data_total, msg, node)) {
@@ -771,100 +995,7 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
     return;
   }
 
-  /* Stage 1: Calculate total RLP length */
-  uint32_t rlp_length = 0;
-  layoutProgress(_("Signing"), 0);
-
-  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
-    // This is the chain ID length for 1559 tx (only one byte for now)
-    rlp_length += rlp_calculate_number_length(chain_id);
-
-    //rlp_length += 1;
-  }
-
-  rlp_length += rlp_calculate_length(msg->nonce.size, msg->nonce.bytes[0]);
-  if (msg->has_max_fee_per_gas) {
-    if (msg->has_max_priority_fee_per_gas) {
-      rlp_length += rlp_calculate_length(msg->max_priority_fee_per_gas.size,
-                                         msg->max_priority_fee_per_gas.bytes[0]);
-    }
-    rlp_length += rlp_calculate_length(msg->max_fee_per_gas.size,
-                                       msg->max_fee_per_gas.bytes[0]);    
-  } else {
-    rlp_length += rlp_calculate_length(msg->gas_price.size, msg->gas_price.bytes[0]);
-  }
-
-  rlp_length += rlp_calculate_length(msg->gas_limit.size, msg->gas_limit.bytes[0]);
-  rlp_length += rlp_calculate_length(msg->to.size, msg->to.bytes[0]);
-  rlp_length += rlp_calculate_length(msg->value.size, msg->value.bytes[0]);
-  rlp_length += rlp_calculate_length(data_total, msg->data_initial_chunk.bytes[0]);
-    
-  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
-    // access list size
-    rlp_length += 1;  // c0, keepkey does not support >0 length access list at this time
-  }
-
-  if (wanchain_tx_type) {
-    rlp_length += rlp_calculate_number_length(wanchain_tx_type);
-  }
-      
-  if (ethereum_tx_type == ETHEREUM_TX_TYPE_LEGACY) {
-    // legacy EIP-155 replay protection
-    if (chain_id) {
-      rlp_length += rlp_calculate_number_length(chain_id);
-      rlp_length += rlp_calculate_length(0, 0);
-      rlp_length += rlp_calculate_length(0, 0);
-    }
-  }
-
-  // Start the hash:
-  // keccak256(0x02 || rlp([chain_id, nonce, max_priority_fee_per_gas, max_fee_per_gas, 
-  //           gas_limit, destination, amount, data, access_list]))  
-
-  // tx type should never be greater than one byte in length
-  // https://github.com/ethereum/EIPs/blob/master/EIPS/eip-2718.md#transactiontype-only-goes-up-to-0x7f
-  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
-    uint8_t datbuf[1] = {0x02};
-    hash_data(datbuf, sizeof(datbuf));
-  }
-
-  layoutProgress(_("Signing"), 100);
-  /* Stage 2: Store header fields */
-  hash_rlp_list_length(rlp_length);
-
-  if (wanchain_tx_type) {
-    hash_rlp_number(wanchain_tx_type);
-  }
-
-  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
-    // chain id goes here for 1559 (only one byte for now)
-    hash_rlp_field((uint8_t *)(&chain_id), sizeof(uint8_t));
-  }
-
-  hash_rlp_field(msg->nonce.bytes, msg->nonce.size);
-    
-  if (msg->has_max_fee_per_gas) {
-    if (msg->has_max_priority_fee_per_gas) {
-      hash_rlp_field(msg->max_priority_fee_per_gas.bytes,
-                     msg->max_priority_fee_per_gas.size);
-    }
-    hash_rlp_field(msg->max_fee_per_gas.bytes, msg->max_fee_per_gas.size);
-  } else {
-    hash_rlp_field(msg->gas_price.bytes, msg->gas_price.size);
-  }
-    
-  hash_rlp_field(msg->gas_limit.bytes, msg->gas_limit.size);
-  hash_rlp_field(msg->to.bytes, msg->to.size);
-  hash_rlp_field(msg->value.bytes, msg->value.size);
-  hash_rlp_length(data_total, msg->data_initial_chunk.bytes[0]);
-  hash_data(msg->data_initial_chunk.bytes, msg->data_initial_chunk.size);
-  data_left = data_total - msg->data_initial_chunk.size;
-
-  if (ethereum_tx_type == ETHEREUM_TX_TYPE_EIP_1559) {
-    // Keepkey does not support an access list size >0 at this time
-    uint8_t datbuf[1] = {0xC0};   // size of empty access list
-    hash_data(datbuf, sizeof(datbuf));
-  }
+  ethereum_hashHeader(msg);
 
   memcpy(privkey, node->private_key, 32);
 
@@ -875,6 +1006,21 @@ void ethereum_signing_init(EthereumSignTx *msg, const HDNode *node,
   }
 }
 
+#ifdef EMULATOR
+bool ethereum_signing_txHash(EthereumSignTx *msg, uint8_t hash[32]) {
+  if (!ethereum_signing_start(msg)) {
+    return false;
+  }
+  bool complete = msg->data_initial_chunk.size == data_total;
+  if (complete) {
+    ethereum_hashHeader(msg);
+    ethereum_hashFinal(hash);
+  }
+  ethereum_signing_abort();
+  return complete;
+}
+#endif
+
 void ethereum_signing_txack(EthereumTxAck *tx) {
   if (!ethereum_signing) {
     fsm_sendFailure(FailureType_Failure_UnexpectedMessage,
@@ -902,6 +1048,7 @@ void ethereum_signing_txack(EthereumTxAck *tx) {
   if (data_left > 0) {
     send_request_chunk();
   } else {
+    hash_access_list();
     send_signature();
   }
 }
@@ -914,53 +1061,83 @@ void ethereum_signing_abort(void) {
   }
 }
 
-static void ethereum_message_hash(const uint8_t *message, size_t message_len,
-                                  uint8_t hash[32]) {
-  struct SHA3_CTX ctx;
+void ethereum_message_hashInit(EthereumMessageHasher *ctx,
+                               uint32_t message_len) {
   uint8_t c;
 
-  sha3_256_Init(&ctx);
-  sha3_Update(&ctx, (const uint8_t *)"\x19" "Ethereum Signed Message:\n", 26);
+  memzero(ctx, sizeof(*ctx));
+  sha3_256_Init(&ctx->ctx);
+  sha3_Update(&ctx->ctx, (const uint8_t *)"\x19" "Ethereum Signed Message:\n", 26);
   if (message_len >= 1000000000) {
     c = '0' + message_len / 1000000000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 100000000) {
     c = '0' + message_len / 100000000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 10000000) {
     c = '0' + message_len / 10000000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 1000000) {
     c = '0' + message_len / 1000000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 100000) {
     c = '0' + message_len / 100000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 10000) {
     c = '0' + message_len / 10000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 1000) {
     c = '0' + message_len / 1000 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 100) {
     c = '0' + message_len / 100 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   if (message_len >= 10) {
     c = '0' + message_len / 10 % 10;
-    sha3_Update(&ctx, &c, 1);
+    sha3_Update(&ctx->ctx, &c, 1);
   }
   c = '0' + message_len % 10;
-  sha3_Update(&ctx, &c, 1);
-  sha3_Update(&ctx, message, message_len);
-  keccak_Final(&ctx, hash);
+  sha3_Update(&ctx->ctx, &c, 1);
+  ctx->remaining = message_len;
+}
+
+bool ethereum_message_hashUpdate(EthereumMessageHasher *ctx,
+                                 const uint8_t *data, size_t len) {
+  if (len > ctx->remaining) return false;
+
+  sha3_Update(&ctx->ctx, data, len);
+  ctx->remaining -= len;
+  return true;
+}
+
+bool ethereum_message_hashFinal(EthereumMessageHasher *ctx, uint8_t hash[32]) {
+  if (ctx->remaining != 0) return false;
+  keccak_Final(&ctx->ctx, hash);
+  return true;
+}
+
+static void ethereum_message_hash(const uint8_t *message, size_t message_len,
+                                  uint8_t hash[32]) {
+  EthereumMessageHasher ctx;
+  ethereum_message_hashInit(&ctx, message_len);
+  ethereum_message_hashUpdate(&ctx, message, message_len);
+  ethereum_message_hashFinal(&ctx, hash);
+}
+
+void ethereum_message_presign(const EthereumSignMessage *msg,
+                              const HDNode *node) {
+  uint8_t hash[32];
+  ethereum_message_hash(msg->message.bytes, msg->message.size, hash);
+  cryptoPresignDigest(&secp256k1, node->private_key, hash,
+                      ethereum_is_canonic);
 }
 
 void ethereum_message_sign(const EthereumSignMessage *msg, const HDNode *node,
@@ -968,6 +1145,7 @@ void ethereum_message_sign(const EthereumSignMessage *msg, const HDNode *node,
   uint8_t hash[32];
 
   if (!hdnode_get_ethereum_pubkeyhash(node, resp->address.bytes)) {
+    cryptoPresignClear();
     return;
   }
   resp->has_address = true;
@@ -976,8 +1154,8 @@ void ethereum_message_sign(const EthereumSignMessage *msg, const HDNode *node,
   ethereum_message_hash(msg->message.bytes, msg->message.size, hash);
 
   uint8_t v;
-  if (ecdsa_sign_digest(&secp256k1, node->private_key, hash,
-                        resp->signature.bytes, &v, ethereum_is_canonic) != 0) {
+  if (cryptoSignDigest(&secp256k1, node->private_key, hash,
+                       resp->signature.bytes, &v, ethereum_is_canonic) != 0) {
     fsm_sendFailure(FailureType_Failure_Other, _("Signing failed"));
     return;
   }
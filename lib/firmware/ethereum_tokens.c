@@ -43,11 +43,20 @@ const TokenType *tokenIter(int32_t *ctr) {
 }
 
 const TokenType *tokenByChainAddress(uint8_t chain_id, const uint8_t *address) {
+  // Batches of transfers hit the same contract over and over, so remember
+  // the last match instead of rescanning the whole table each time.
+  static const TokenType *last_hit = NULL;
+
   if (!address) return 0;
+  if (last_hit && chain_id == last_hit->chain_id &&
+      memcmp(address, last_hit->address, 20) == 0) {
+    return last_hit;
+  }
   for (int i = 0; i < TOKENS_COUNT; i++) {
     if (chain_id == tokens[i].chain_id &&
         memcmp(address, tokens[i].address, 20) == 0) {
-      return &(tokens[i]);
+      last_hit = &(tokens[i]);
+      return last_hit;
     }
   }
   if (memcmp(address, Ethtest.address, 20) == 0) {
@@ -46,6 +46,7 @@
 #include "keepkey/firmware/fsm.h"
 #include "keepkey/firmware/home_sm.h"
 #include "keepkey/firmware/mayachain.h"
+#include "keepkey/firmware/nano.h"
 #include "keepkey/firmware/osmosis.h"
 #include "keepkey/firmware/passphrase_sm.h"
 #include "keepkey/firmware/pin_sm.h"
@@ -193,6 +194,8 @@ static HDNode *fsm_getDerivedNode(const char *curve, const uint32_t *address_n,
     return &node;
   }
 
+  // hdnode_private_ckd_cached keeps the parent of the last path element, so
+  // repeated requests for one account only redo the final child derivation.
   if (hdnode_private_ckd_cached(&node, address_n, address_n_count,
                                 fingerprint) == 0) {
     fsm_sendFailure(FailureType_Failure_Other, "Failed to derive private key");
@@ -270,6 +273,125 @@ void fsm_msgClearSession(ClearSession *msg) {
   fsm_sendSuccess("Session cleared");
 }
 
+static TendermintSummary tendermint_summary;
+static bool tendermint_summarizing;
+
+/*
+ * Offers to review a long Cosmos-family transaction as one summary. Messages
+ * whose handler can summarize them are then totalled rather than confirmed one
+ * by one; anything else is still shown on its own.
+ */
+static void fsm_tendermintSummaryStart(uint32_t msg_count) {
+  tendermint_summaryInit(&tendermint_summary);
+  tendermint_summarizing =
+      msg_count >= TENDERMINT_SUMMARY_MIN_MSGS &&
+      confirm(ButtonRequestType_ButtonRequest_Other, "Review Summary",
+              "Review %" PRIu32
+              " messages as one summary? Reject to review each message.",
+              msg_count);
+}
+
+/*
+ * Shows the totals of the summarized messages. Called once every message has
+ * been received, before the final signing confirmation.
+ */
+static bool fsm_tendermintSummaryConfirm(
+    const TendermintMsgRegistry *registry) {
+  bool summarizing = tendermint_summarizing;
+  tendermint_summarizing = false;
+  if (!summarizing || tendermint_summary.msg_count == 0) {
+    return true;
+  }
+
+  for (size_t i = 0; i < tendermint_summary.total_count; i++) {
+    const TendermintSummaryTotal *total = &tendermint_summary.totals[i];
+    char suffix[sizeof(total->denom) + 1] = " ";
+    if (total->symbol) {
+      strlcpy(suffix, total->symbol, sizeof(suffix));
+    } else {
+      strlcat(suffix, total->denom, sizeof(suffix));
+    }
+    char amount_str[64];
+    bn_format_uint64(total->amount, NULL, suffix, total->decimals, 0, false,
+                     amount_str, sizeof(amount_str));
+    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, "Summary",
+                 "%s %s in total?", total->action, amount_str)) {
+      goto cancelled;
+    }
+  }
+
+  for (size_t i = 0; i < tendermint_summary.validator_count; i++) {
+    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, "Summary",
+                 "Validator %u of %u:\n%s", (unsigned)(i + 1),
+                 (unsigned)tendermint_summary.validator_count,
+                 tendermint_summary.validators[i])) {
+      goto cancelled;
+    }
+  }
+
+  return true;
+
+cancelled:
+  registry->sign_abort();
+  fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
+  layoutHome();
+  return false;
+}
+
+/*
+ * Runs the handler registered for the message carried by a Cosmos-family
+ * MsgAck. On failure the signing session is aborted and the host told why.
+ */
+static bool fsm_tendermintMsgDispatch(const TendermintMsgRegistry *registry,
+                                      const void *ack) {
+  const TendermintMsgHandler *handler =
+      tendermint_findMsgHandler(registry, ack);
+  if (!handler) {
+    registry->sign_abort();
+    fsm_sendFailure(FailureType_Failure_FirmwareError,
+                    _(registry->invalid_type));
+    layoutHome();
+    return false;
+  }
+
+  if (!handler->validate(ack)) {
+    registry->sign_abort();
+    fsm_sendFailure(FailureType_Failure_FirmwareError,
+                    _(registry->missing_params));
+    layoutHome();
+    return false;
+  }
+
+  // A message that cannot be summarized is shown on its own, and must not
+  // leave part of itself in the summary.
+  static TendermintSummary before;
+  bool summarized = false;
+  if (tendermint_summarizing && handler->summarize) {
+    memcpy(&before, &tendermint_summary, sizeof(before));
+    summarized = handler->summarize(ack, &tendermint_summary);
+    if (!summarized) {
+      memcpy(&tendermint_summary, &before, sizeof(before));
+    }
+  }
+  if (summarized) {
+    tendermint_summary.msg_count++;
+  } else if (!handler->confirm(ack)) {
+    registry->sign_abort();
+    fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
+    layoutHome();
+    return false;
+  }
+
+  if (!handler->update(ack)) {
+    registry->sign_abort();
+    fsm_sendFailure(FailureType_Failure_SyntaxError, handler->update_failure);
+    layoutHome();
+    return false;
+  }
+
+  return true;
+}
+
 #include "fsm_msg_common.h"
 #include "fsm_msg_coin.h"
 #include "fsm_msg_ethereum.h"
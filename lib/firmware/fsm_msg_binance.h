@@ -93,16 +93,42 @@ void fsm_msgBinanceSignTx(const BinanceSignTx *msg) {
 
 static void binance_response(void);
 
+static void binance_formatCoin(const BinanceCoin *coin, char *amount_str,
+                               size_t amount_len) {
+  char denom_str[sizeof(coin->denom) + 1];
+  denom_str[0] = ' ';
+  strlcpy(denom_str + 1, coin->denom, sizeof(denom_str) - 1);
+  bn_format_uint64(coin->amount, NULL, denom_str, 8, 0, false, amount_str,
+                   amount_len);
+}
+
+static bool binance_confirmOutput(const BinanceInputOutput *output) {
+  switch (output->address_type) {
+    case OutputAddressType_TRANSFER:
+    default:
+      for (int i = 0; i < output->coins_count; i++) {
+        char amount_str[64];
+        binance_formatCoin(&output->coins[i], amount_str, sizeof(amount_str));
+        if (!confirm_transaction_output(
+                ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
+                output->address)) {
+          return false;
+        }
+      }
+      return true;
+  }
+}
+
+/*
+ * A transfer may be split across several BinanceTransferMsg acks so that
+ * multi-send payouts need not fit in one message: every input comes before
+ * the first output, and the transfer is closed as soon as its outputs spend
+ * exactly its inputs.
+ */
 void fsm_msgBinanceTransferMsg(const BinanceTransferMsg *msg) {
   CHECK_PARAM(binance_signingIsInited(), "Signing not in progress?");
-  CHECK_PARAM(msg->inputs_count == 1, "Malformed BinanceTransferMsg")
-  CHECK_PARAM(msg->inputs[0].coins_count == 1, "Malformed BinanceTransferMsg")
-  CHECK_PARAM(msg->outputs_count == 1, "Malformed BinanceTransferMsg")
-  CHECK_PARAM(msg->outputs[0].coins_count == 1, "Malformed BinanceTransferMsg")
-  CHECK_PARAM(msg->inputs[0].coins[0].amount == msg->outputs[0].coins[0].amount,
-              "Malformed BinanceTransferMsg")
-  CHECK_PARAM(strcmp(msg->inputs[0].coins[0].denom,
-                     msg->outputs[0].coins[0].denom) == 0,
+  CHECK_PARAM(!binance_signingIsFinished(), "Malformed BinanceTransferMsg")
+  CHECK_PARAM(msg->inputs_count + msg->outputs_count != 0,
               "Malformed BinanceTransferMsg")
 
   const CoinType *coin = fsm_getCoin(true, "Binance");
@@ -110,27 +136,52 @@ void fsm_msgBinanceTransferMsg(const BinanceTransferMsg *msg) {
     return;
   }
 
-  switch (msg->outputs[0].address_type) {
-    case OutputAddressType_TRANSFER:
-    default: {
-      char amount_str[42];
-      char denom_str[14];
-      snprintf(denom_str, strlen(msg->outputs[0].coins[0].denom) + 2, " %s", msg->outputs[0].coins[0].denom);
-      bn_format_uint64(msg->outputs[0].coins[0].amount, NULL, denom_str, 8, 0,
-                       false, amount_str, sizeof(amount_str));
-      if (!confirm_transaction_output(
-              ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-              msg->outputs[0].address)) {
-        binance_signAbort();
-        fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-        layoutHome();
-        return;
-      }
-      break;
+  // Inputs are not confirmed: they must all be the signer's own address, and
+  // every coin they provide is confirmed where an output spends it.
+  for (int i = 0; i < msg->inputs_count; i++) {
+    const char *signer = binance_signerAddress();
+    if (!signer || strcmp(signer, msg->inputs[i].address) != 0) {
+      binance_signAbort();
+      fsm_sendFailure(FailureType_Failure_SyntaxError,
+                      "Transfer input does not match the signing address");
+      layoutHome();
+      return;
     }
+
+    if (!binance_signTxTransferInput(&msg->inputs[i])) {
+      binance_signAbort();
+      fsm_sendFailure(FailureType_Failure_SyntaxError,
+                      "Failed to include transfer message in transaction");
+      layoutHome();
+      return;
+    }
+  }
+
+  for (int i = 0; i < msg->outputs_count; i++) {
+    if (!binance_confirmOutput(&msg->outputs[i])) {
+      binance_signAbort();
+      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
+      layoutHome();
+      return;
+    }
+
+    if (!binance_signTxTransferOutput(&msg->outputs[i])) {
+      binance_signAbort();
+      fsm_sendFailure(FailureType_Failure_SyntaxError,
+                      "Failed to include transfer message in transaction");
+      layoutHome();
+      return;
+    }
+  }
+
+  if (!binance_signTxTransferIsBalanced()) {
+    // Ask for the rest of the transfer
+    RESP_INIT(BinanceTxRequest);
+    msg_write(MessageType_MessageType_BinanceTxRequest, resp);
+    return;
   }
 
-  if (!binance_signTxUpdateTransfer(msg)) {
+  if (!binance_signTxTransferEnd()) {
     binance_signAbort();
     fsm_sendFailure(FailureType_Failure_SyntaxError,
                     "Failed to include transfer message in transaction");
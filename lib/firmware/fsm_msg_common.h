@@ -5,6 +5,7 @@ void fsm_msgInitialize(Initialize *msg) {
   ethereum_signing_abort();
   tendermint_signAbort();
   eos_signingAbort();
+  cryptoPresignClear();
   session_clear(false);  // do not clear PIN
   layoutHome();
   fsm_msgGetFeatures(0);
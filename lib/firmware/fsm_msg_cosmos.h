@@ -103,356 +103,293 @@ void fsm_msgCosmosSignTx(const CosmosSignTx *msg) {
   }
 
   memzero(node, sizeof(*node));
+  fsm_tendermintSummaryStart(msg->msg_count);
   msg_write(MessageType_MessageType_CosmosMsgRequest, resp);
   layoutHome();
 }
 
-void fsm_msgCosmosMsgAck(const CosmosMsgAck *msg) {
-  // Confirm transaction basics
-  CHECK_PARAM(tendermint_signingIsInited(), "Signing not in progress");
+static bool cosmos_validateSend(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return msg->send.has_to_address && msg->send.has_amount;
+}
 
-  const CoinType *coin = fsm_getCoin(true, "Cosmos");
-  if (!coin) {
-    return;
+static bool cosmos_confirmSend(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  switch (msg->send.address_type) {
+    case OutputAddressType_TRANSFER:
+    default: {
+      char amount_str[32];
+      bn_format_uint64(msg->send.amount, NULL, " ATOM", 6, 0, false,
+                       amount_str, sizeof(amount_str));
+      return confirm_transaction_output(
+          ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
+          msg->send.to_address);
+    }
   }
+}
 
-  const CosmosSignTx *sign_tx = (CosmosSignTx *)tendermint_getSignTx();
+static bool cosmos_updateSend(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return tendermint_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address,
+                                        "cosmos", "uatom", "cosmos-sdk");
+}
 
-  if (msg->has_send) {
-    if (!msg->send.has_to_address || !msg->send.has_amount) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-    switch (msg->send.address_type) {
-      case OutputAddressType_TRANSFER:
-      default: {
-        char amount_str[32];
-        bn_format_uint64(msg->send.amount, NULL, " ATOM", 6, 0, false,
-                         amount_str, sizeof(amount_str));
-        if (!confirm_transaction_output(
-                ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-                msg->send.to_address)) {
-          tendermint_signAbort();
-          fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-          layoutHome();
-          return;
-        }
-
-        break;
-      }
-    }
+static bool cosmos_validateDelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return msg->delegate.has_delegator_address &&
+         msg->delegate.has_validator_address && msg->delegate.has_amount;
+}
 
-    if (!tendermint_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address,
-                                        "cosmos", "uatom", "cosmos-sdk")) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include send message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_delegate) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->delegate.has_delegator_address ||
-        !msg->delegate.has_validator_address || !msg->delegate.has_amount) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-    /** Confirm transaction parameters on-screen */
-    char amount_str[32];
-    bn_format_uint64(msg->delegate.amount, NULL, " ATOM", 6, 0, false,
-                     amount_str, sizeof(amount_str));
+static bool cosmos_confirmDelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  char amount_str[32];
+  bn_format_uint64(msg->delegate.amount, NULL, " ATOM", 6, 0, false,
+                   amount_str, sizeof(amount_str));
+
+  return confirm_cosmos_address("Confirm delegator address",
+                                msg->delegate.delegator_address) &&
+         confirm_cosmos_address("Confirm validator address",
+                                msg->delegate.validator_address) &&
+         confirm_with_custom_layout(
+             &layout_notification_no_title_bold,
+             ButtonRequestType_ButtonRequest_ConfirmOutput, "", "Delegate %s?",
+             amount_str);
+}
 
-    if (!confirm_cosmos_address("Confirm delegator address",
-                                msg->delegate.delegator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_updateDelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return tendermint_signTxUpdateMsgDelegate(
+      msg->delegate.amount, msg->delegate.delegator_address,
+      msg->delegate.validator_address, "cosmos", "uatom", "cosmos-sdk");
+}
 
-    if (!confirm_cosmos_address("Confirm validator address",
-                                msg->delegate.validator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_isSigner(const char *address) {
+  const char *signer = tendermint_signerAddress("cosmos");
+  return signer && strcmp(signer, address) == 0;
+}
 
-    if (!confirm_with_custom_layout(
-            &layout_notification_no_title_bold,
-            ButtonRequestType_ButtonRequest_ConfirmOutput, "", "Delegate %s?",
-            amount_str)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_summarizeDelegate(const void *ack,
+                                     TendermintSummary *summary) {
+  const CosmosMsgAck *msg = ack;
+  if (!cosmos_isSigner(msg->delegate.delegator_address) ||
+      !tendermint_summaryAddAmount(summary, "Delegate", "uatom", 6,
+                                   " ATOM", msg->delegate.amount)) {
+    return false;
+  }
+  return tendermint_summaryAddValidator(summary,
+                                        msg->delegate.validator_address);
+}
 
-    if (!tendermint_signTxUpdateMsgDelegate(
-            msg->delegate.amount, msg->delegate.delegator_address,
-            msg->delegate.validator_address, "cosmos", "uatom", "cosmos-sdk")) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include delegate message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_undelegate) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->undelegate.has_delegator_address ||
-        !msg->undelegate.has_validator_address || !msg->undelegate.has_amount) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-    /** Confirm transaction parameters on-screen */
-    char amount_str[32];
-    bn_format_uint64(msg->undelegate.amount, NULL, " ATOM", 6, 0, false,
-                     amount_str, sizeof(amount_str));
+static bool cosmos_validateUndelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return msg->undelegate.has_delegator_address &&
+         msg->undelegate.has_validator_address && msg->undelegate.has_amount;
+}
 
-    if (!confirm_cosmos_address("Confirm delegator address",
-                                msg->undelegate.delegator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_confirmUndelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  char amount_str[32];
+  bn_format_uint64(msg->undelegate.amount, NULL, " ATOM", 6, 0, false,
+                   amount_str, sizeof(amount_str));
+
+  return confirm_cosmos_address("Confirm delegator address",
+                                msg->undelegate.delegator_address) &&
+         confirm_cosmos_address("Confirm validator address",
+                                msg->undelegate.validator_address) &&
+         confirm_with_custom_layout(
+             &layout_notification_no_title_bold,
+             ButtonRequestType_ButtonRequest_ConfirmOutput, "",
+             "Undelegate %s?", amount_str);
+}
 
-    if (!confirm_cosmos_address("Confirm validator address",
-                                msg->undelegate.validator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_updateUndelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return tendermint_signTxUpdateMsgUndelegate(
+      msg->undelegate.amount, msg->undelegate.delegator_address,
+      msg->undelegate.validator_address, "cosmos", "uatom", "cosmos-sdk");
+}
 
-    if (!confirm_with_custom_layout(
-            &layout_notification_no_title_bold,
-            ButtonRequestType_ButtonRequest_ConfirmOutput, "", "Undelegate %s?",
-            amount_str)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_summarizeUndelegate(const void *ack,
+                                       TendermintSummary *summary) {
+  const CosmosMsgAck *msg = ack;
+  if (!cosmos_isSigner(msg->undelegate.delegator_address) ||
+      !tendermint_summaryAddAmount(summary, "Undelegate", "uatom", 6,
+                                   " ATOM", msg->undelegate.amount)) {
+    return false;
+  }
+  return tendermint_summaryAddValidator(summary,
+                                        msg->undelegate.validator_address);
+}
 
-    if (!tendermint_signTxUpdateMsgUndelegate(
-            msg->undelegate.amount, msg->undelegate.delegator_address,
-            msg->undelegate.validator_address, "cosmos", "uatom",
-            "cosmos-sdk")) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include undelegate message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_redelegate) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->redelegate.has_delegator_address ||
-        !msg->redelegate.has_validator_src_address ||
-        !msg->redelegate.has_validator_dst_address ||
-        !msg->redelegate.has_amount) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-    /** Confirm transaction parameters on-screen */
-    char amount_str[32];
-    bn_format_uint64(msg->redelegate.amount, NULL, " ATOM", 6, 0, false,
-                     amount_str, sizeof(amount_str));
+static bool cosmos_validateRedelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return msg->redelegate.has_delegator_address &&
+         msg->redelegate.has_validator_src_address &&
+         msg->redelegate.has_validator_dst_address &&
+         msg->redelegate.has_amount;
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Redelegate",
-                 "Redelegate %s?", amount_str)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_confirmRedelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  char amount_str[32];
+  bn_format_uint64(msg->redelegate.amount, NULL, " ATOM", 6, 0, false,
+                   amount_str, sizeof(amount_str));
+
+  return confirm(ButtonRequestType_ButtonRequest_Other, "Redelegate",
+                 "Redelegate %s?", amount_str) &&
+         confirm_cosmos_address("Delegator address",
+                                msg->redelegate.delegator_address) &&
+         confirm_cosmos_address("Validator source address",
+                                msg->redelegate.validator_src_address) &&
+         confirm_cosmos_address("Validator dest. address",
+                                msg->redelegate.validator_dst_address);
+}
 
-    if (!confirm_cosmos_address("Delegator address",
-                                msg->redelegate.delegator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_updateRedelegate(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return tendermint_signTxUpdateMsgRedelegate(
+      msg->redelegate.amount, msg->redelegate.delegator_address,
+      msg->redelegate.validator_src_address,
+      msg->redelegate.validator_dst_address, "cosmos", "uatom", "cosmos-sdk");
+}
 
-    if (!confirm_cosmos_address("Validator source address",
-                                msg->redelegate.validator_src_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_validateRewards(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return msg->rewards.has_delegator_address &&
+         msg->rewards.has_validator_address;
+}
 
-    if (!confirm_cosmos_address("Validator dest. address",
-                                msg->redelegate.validator_dst_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_confirmRewards(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  if (msg->rewards.has_amount) {
+    char amount_str[32];
+    bn_format_uint64(msg->rewards.amount, NULL, " ATOM", 6, 0, false,
+                     amount_str, sizeof(amount_str));
 
-    if (!tendermint_signTxUpdateMsgRedelegate(
-            msg->redelegate.amount, msg->redelegate.delegator_address,
-            msg->redelegate.validator_src_address,
-            msg->redelegate.validator_dst_address, "cosmos", "uatom",
-            "cosmos-sdk")) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include redelegate message in transaction");
-      layoutHome();
-      return;
+    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Claim Rewards",
+                 "Claim %s?", amount_str)) {
+      return false;
     }
-  } else if (msg->has_rewards) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->rewards.has_delegator_address ||
-        !msg->rewards.has_validator_address) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
+  } else {
+    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Claim Rewards",
+                 "Claim all available rewards?")) {
+      return false;
     }
+  }
 
-    if (msg->rewards.has_amount) {
-      /** Confirm transaction parameters on-screen */
-      char amount_str[32];
-      bn_format_uint64(msg->rewards.amount, NULL, " ATOM", 6, 0, false,
-                      amount_str, sizeof(amount_str));
-
-      if (!confirm(ButtonRequestType_ButtonRequest_Other, "Claim Rewards",
-                  "Claim %s?", amount_str)) {
-        tendermint_signAbort();
-        fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-        layoutHome();
-        return;
-      }
-    } else {
-      if (!confirm(ButtonRequestType_ButtonRequest_Other, "Claim Rewards",
-                  "Claim all available rewards?")) {
-        tendermint_signAbort();
-        fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-        layoutHome();
-        return;
-      }
-    }
+  return confirm_cosmos_address("Confirm delegator address",
+                                msg->rewards.delegator_address) &&
+         confirm_cosmos_address("Confirm validator address",
+                                msg->rewards.validator_address);
+}
 
-    if (!confirm_cosmos_address("Confirm delegator address",
-                                msg->rewards.delegator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_updateRewards(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return tendermint_signTxUpdateMsgRewards(
+      msg->rewards.has_amount ? &msg->rewards.amount : NULL,
+      msg->rewards.delegator_address, msg->rewards.validator_address, "cosmos",
+      "uatom", "cosmos-sdk");
+}
 
-    if (!confirm_cosmos_address("Confirm validator address",
-                                msg->rewards.validator_address)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_summarizeRewards(const void *ack,
+                                    TendermintSummary *summary) {
+  const CosmosMsgAck *msg = ack;
+  if (!cosmos_isSigner(msg->rewards.delegator_address)) {
+    return false;
+  }
+  if (msg->rewards.has_amount &&
+      !tendermint_summaryAddAmount(summary, "Claim", "uatom", 6,
+                                   " ATOM", msg->rewards.amount)) {
+    return false;
+  }
+  return tendermint_summaryAddValidator(summary,
+                                        msg->rewards.validator_address);
+}
 
-    if (!tendermint_signTxUpdateMsgRewards(
-            msg->rewards.has_amount ? &msg->rewards.amount : NULL,
-            msg->rewards.delegator_address, msg->rewards.validator_address,
-            "cosmos", "uatom", "cosmos-sdk")) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include rewards message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_ibc_transfer) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->ibc_transfer.has_sender ||
-        !msg->ibc_transfer.has_source_channel ||
-        !msg->ibc_transfer.has_source_port ||
-        !msg->ibc_transfer.has_revision_height ||
-        !msg->ibc_transfer.has_revision_number ||
-        !msg->ibc_transfer.has_denom) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-    /** Confirm transaction parameters on-screen */
-    char amount_str[32];
-    bn_format_uint64(msg->ibc_transfer.amount, NULL, " ATOM", 6, 0, false,
-                     amount_str, sizeof(amount_str));
+static bool cosmos_validateIBCTransfer(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return msg->ibc_transfer.has_sender && msg->ibc_transfer.has_source_channel &&
+         msg->ibc_transfer.has_source_port &&
+         msg->ibc_transfer.has_revision_height &&
+         msg->ibc_transfer.has_revision_number && msg->ibc_transfer.has_denom;
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "IBC Transfer",
-                 "Transfer %s to %s?", amount_str, msg->ibc_transfer.sender)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_confirmIBCTransfer(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  char amount_str[32];
+  bn_format_uint64(msg->ibc_transfer.amount, NULL, " ATOM", 6, 0, false,
+                   amount_str, sizeof(amount_str));
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
+  return confirm(ButtonRequestType_ButtonRequest_Other, "IBC Transfer",
+                 "Transfer %s to %s?", amount_str,
+                 msg->ibc_transfer.sender) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
                  "Confirm Source Channel", "%s",
-                 msg->ibc_transfer.source_channel)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+                 msg->ibc_transfer.source_channel) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Source Port",
+                 "%s", msg->ibc_transfer.source_port) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
+                 "Confirm Revision Height", "%s",
+                 msg->ibc_transfer.revision_height) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
+                 "Confirm Revision Number", "%s",
+                 msg->ibc_transfer.revision_number);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Source Port",
-                 "%s", msg->ibc_transfer.source_port)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool cosmos_updateIBCTransfer(const void *ack) {
+  const CosmosMsgAck *msg = ack;
+  return tendermint_signTxUpdateMsgIBCTransfer(
+      msg->ibc_transfer.amount, msg->ibc_transfer.sender,
+      msg->ibc_transfer.receiver, msg->ibc_transfer.source_channel,
+      msg->ibc_transfer.source_port, msg->ibc_transfer.revision_number,
+      msg->ibc_transfer.revision_height, "cosmos", "uatom", "cosmos-sdk");
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
-                 "Confirm Revision Height", "%s",
-                 msg->ibc_transfer.revision_height)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static const TendermintMsgHandler cosmos_msgHandlers[] = {
+    {offsetof(CosmosMsgAck, has_send), cosmos_validateSend, cosmos_confirmSend,
+     cosmos_updateSend, "Failed to include send message in transaction",
+     NULL},
+    {offsetof(CosmosMsgAck, has_delegate), cosmos_validateDelegate,
+     cosmos_confirmDelegate, cosmos_updateDelegate,
+     "Failed to include delegate message in transaction",
+     cosmos_summarizeDelegate},
+    {offsetof(CosmosMsgAck, has_undelegate), cosmos_validateUndelegate,
+     cosmos_confirmUndelegate, cosmos_updateUndelegate,
+     "Failed to include undelegate message in transaction",
+     cosmos_summarizeUndelegate},
+    {offsetof(CosmosMsgAck, has_redelegate), cosmos_validateRedelegate,
+     cosmos_confirmRedelegate, cosmos_updateRedelegate,
+     // Not summarized: a validator list cannot say which way stake moved.
+     "Failed to include redelegate message in transaction", NULL},
+    {offsetof(CosmosMsgAck, has_rewards), cosmos_validateRewards,
+     cosmos_confirmRewards, cosmos_updateRewards,
+     "Failed to include rewards message in transaction",
+     cosmos_summarizeRewards},
+    {offsetof(CosmosMsgAck, has_ibc_transfer), cosmos_validateIBCTransfer,
+     cosmos_confirmIBCTransfer, cosmos_updateIBCTransfer,
+     "Failed to include send message in transaction", NULL},
+};
+
+static const TendermintMsgRegistry cosmos_msgRegistry = {
+    cosmos_msgHandlers,
+    sizeof(cosmos_msgHandlers) / sizeof(cosmos_msgHandlers[0]),
+    tendermint_signAbort,
+    "Invalid Cosmos message type",
+    "Message is missing required parameters",
+};
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
-                 "Confirm Revision Number", "%s",
-                 msg->ibc_transfer.revision_number)) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+void fsm_msgCosmosMsgAck(const CosmosMsgAck *msg) {
+  // Confirm transaction basics
+  CHECK_PARAM(tendermint_signingIsInited(), "Signing not in progress");
 
-    if (!tendermint_signTxUpdateMsgIBCTransfer(
-            msg->ibc_transfer.amount, msg->ibc_transfer.sender,
-            msg->ibc_transfer.receiver, msg->ibc_transfer.source_channel,
-            msg->ibc_transfer.source_port, msg->ibc_transfer.revision_number,
-            msg->ibc_transfer.revision_height, "cosmos", "uatom",
-            "cosmos-sdk")) {
-      tendermint_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include send message in transaction");
-      layoutHome();
-      return;
-    }
-  } else {
-    tendermint_signAbort();
-    fsm_sendFailure(FailureType_Failure_FirmwareError,
-                    _("Invalid Cosmos message type"));
-    layoutHome();
+  const CoinType *coin = fsm_getCoin(true, "Cosmos");
+  if (!coin) {
+    return;
+  }
+
+  const CosmosSignTx *sign_tx = (CosmosSignTx *)tendermint_getSignTx();
+
+  if (!fsm_tendermintMsgDispatch(&cosmos_msgRegistry, msg)) {
     return;
   }
 
@@ -462,6 +399,12 @@ void fsm_msgCosmosMsgAck(const CosmosMsgAck *msg) {
     return;
   }
 
+  tendermint_signTxPresign();
+
+  if (!fsm_tendermintSummaryConfirm(&cosmos_msgRegistry)) {
+    return;
+  }
+
   if (sign_tx->has_memo && (strlen(sign_tx->memo) > 0)) {
     if (!confirm(ButtonRequestType_ButtonRequest_ConfirmMemo, _("Memo"), "%s",
                  sign_tx->memo)) {
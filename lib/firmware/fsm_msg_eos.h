@@ -169,6 +169,8 @@ void fsm_msgEosTxActionAck(const EosTxActionAck *msg) {
   } else if (msg->has_new_account) {
     if (!eos_compileActionNewAccount(&msg->common, &msg->new_account))
       goto action_compile_failed;
+  } else if (msg->has_unknown && eos_isPackedActions(&msg->common)) {
+    if (!eos_compileActionsPacked(&msg->unknown)) goto action_compile_failed;
   } else if (msg->has_unknown) {
     if (!eos_compileActionUnknown(&msg->common, &msg->unknown))
       goto action_compile_failed;
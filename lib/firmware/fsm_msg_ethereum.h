@@ -225,17 +225,32 @@ void fsm_msgEthereumSignMessage(EthereumSignMessage *msg) {
       snprintf(&msgBuf[2*ctr], 3, "%02x", msg->message.bytes[ctr]);
     }
   }
-  
+
+  // With the seed cached, the key is derived without prompts and the
+  // signature computed while the user reads the message. Otherwise nothing
+  // is derived until the message has been approved.
+  HDNode *node = NULL;
+  if (session_isSeedCached()) {
+    node = fsm_getDerivedNode(SECP256K1_NAME, msg->address_n,
+                              msg->address_n_count, NULL);
+    if (!node) return;
+    ethereum_message_presign(msg, node);
+  }
+
   if (!confirm(ButtonRequestType_ButtonRequest_ProtectCall, _(typeIndicator),
                "%s", msgBuf)) {
+    cryptoPresignClear();
+    if (node) memzero(node, sizeof(*node));
     fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
     layoutHome();
     return;
   }
 
-  HDNode *node = fsm_getDerivedNode(SECP256K1_NAME, msg->address_n,
-                                    msg->address_n_count, NULL);
-  if (!node) return;
+  if (!node) {
+    node = fsm_getDerivedNode(SECP256K1_NAME, msg->address_n,
+                              msg->address_n_count, NULL);
+    if (!node) return;
+  }
 
   ethereum_message_sign(msg, node, resp);
   memzero(node, sizeof(*node));
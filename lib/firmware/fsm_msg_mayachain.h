@@ -115,23 +115,91 @@ void fsm_msgMayachainSignTx(const MayachainSignTx *msg) {
   layoutHome();
 }
 
+static bool mayachain_validateSend(const void *ack) {
+  const MayachainMsgAck *msg = ack;
+  return msg->send.has_to_address && msg->send.has_amount &&
+         msg->send.has_denom;
+}
+
+static bool mayachain_confirmSend(const void *ack) {
+  const MayachainMsgAck *msg = ack;
+  switch (msg->send.address_type) {
+    case OutputAddressType_TRANSFER:
+    default: {
+      char amount_str[32];
+      char denom_str[71];
+      sprintf(denom_str, " %s", msg->send.denom);
+      bn_format_uint64(msg->send.amount, NULL, denom_str, 10, 0, false,
+                       amount_str, sizeof(amount_str));
+      return confirm_transaction_output(
+          ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
+          msg->send.to_address);
+    }
+  }
+}
+
+static bool mayachain_updateSend(const void *ack) {
+  const MayachainMsgAck *msg = ack;
+  return mayachain_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address,
+                                       msg->send.denom);
+}
+
+static bool mayachain_validateDeposit(const void *ack) {
+  const MayachainMsgAck *msg = ack;
+  return msg->deposit.has_asset && msg->deposit.has_amount &&
+         msg->deposit.has_memo && msg->deposit.has_signer;
+}
+
+static bool mayachain_confirmDeposit(const void *ack) {
+  const MayachainMsgAck *msg = ack;
+  char amount_str[32];
+  char asset_str[21];
+  asset_str[0] = ' ';
+  strlcpy(&(asset_str[1]), msg->deposit.asset, sizeof(asset_str) - 1);
+  bn_format_uint64(msg->deposit.amount, NULL, asset_str, 10, 0, false,
+                   amount_str, sizeof(amount_str));
+  if (!confirm_transaction_output(ButtonRequestType_ButtonRequest_ConfirmOutput,
+                                  amount_str, msg->deposit.signer)) {
+    return false;
+  }
+
+  // See if we can parse the memo
+  if (mayachain_parseConfirmMemo(msg->deposit.memo,
+                                 sizeof(msg->deposit.memo))) {
+    return true;
+  }
+
+  // Memo not recognizable, ask to confirm it
+  return confirm(ButtonRequestType_ButtonRequest_ConfirmMemo, _("Memo"), "%s",
+                 msg->deposit.memo);
+}
+
+static bool mayachain_updateDeposit(const void *ack) {
+  const MayachainMsgAck *msg = ack;
+  return mayachain_signTxUpdateMsgDeposit(&(msg->deposit));
+}
+
+static const TendermintMsgHandler mayachain_msgHandlers[] = {
+    {offsetof(MayachainMsgAck, has_send), mayachain_validateSend,
+     mayachain_confirmSend, mayachain_updateSend,
+     "Failed to include send message in transaction", NULL},
+    {offsetof(MayachainMsgAck, has_deposit), mayachain_validateDeposit,
+     mayachain_confirmDeposit, mayachain_updateDeposit,
+     "Failed to include deposit message in transaction", NULL},
+};
+
+static const TendermintMsgRegistry mayachain_msgRegistry = {
+    mayachain_msgHandlers,
+    sizeof(mayachain_msgHandlers) / sizeof(mayachain_msgHandlers[0]),
+    mayachain_signAbort,
+    "Invalid MAYAChain Message Type",
+    "Invalid MAYAChain Message Type",
+};
+
 void fsm_msgMayachainMsgAck(const MayachainMsgAck *msg) {
   // Confirm transaction basics
   // supports only 1 message ack
   CHECK_PARAM(mayachain_signingIsInited(), "Signing not in progress");
-  if (msg->has_send && msg->send.has_to_address && msg->send.has_amount && msg->send.has_denom) {
-    // pass
-  } else if (msg->has_deposit && msg->deposit.has_asset &&
-             msg->deposit.has_amount && msg->deposit.has_memo &&
-             msg->deposit.has_signer) {
-    // pass
-  } else {
-    mayachain_signAbort();
-    fsm_sendFailure(FailureType_Failure_FirmwareError,
-                    _("Invalid MAYAChain Message Type"));
-    layoutHome();
-    return;
-  }
 
   const CoinType *coin = fsm_getCoin(true, "MAYAChain");
   if (!coin) {
@@ -140,75 +208,8 @@ void fsm_msgMayachainMsgAck(const MayachainMsgAck *msg) {
 
   const MayachainSignTx *sign_tx = mayachain_getMayachainSignTx();
 
-  if (msg->has_send) {
-    switch (msg->send.address_type) {
-      case OutputAddressType_TRANSFER:
-      default: {
-        char amount_str[32];
-        char denom_str[71];
-        sprintf(denom_str, " %s", msg->send.denom);
-        bn_format_uint64(msg->send.amount, NULL, denom_str, 10, 0, false,
-                         amount_str, sizeof(amount_str));
-        if (!confirm_transaction_output(
-                ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-                msg->send.to_address)) {
-          mayachain_signAbort();
-          fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-          layoutHome();
-          return;
-        }
-
-        break;
-      }
-    }
-    if (!mayachain_signTxUpdateMsgSend(msg->send.amount,
-                                       msg->send.to_address,
-                                       msg->send.denom)) {
-      mayachain_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include send message in transaction");
-      layoutHome();
-      return;
-    }
-
-  } else if (msg->has_deposit) {
-    char amount_str[32];
-    char asset_str[21];
-    asset_str[0] = ' ';
-    strlcpy(&(asset_str[1]), msg->deposit.asset, sizeof(asset_str) - 1);
-    bn_format_uint64(msg->deposit.amount, NULL, asset_str, 10, 0, false,
-                     amount_str, sizeof(amount_str));
-    if (!confirm_transaction_output(
-            ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-            msg->deposit.signer)) {
-      mayachain_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (msg->deposit.has_memo) {
-      // See if we can parse the memo
-      if (!mayachain_parseConfirmMemo(msg->deposit.memo,
-                                      sizeof(msg->deposit.memo))) {
-        // Memo not recognizable, ask to confirm it
-        if (!confirm(ButtonRequestType_ButtonRequest_ConfirmMemo, _("Memo"),
-                     "%s", msg->deposit.memo)) {
-          mayachain_signAbort();
-          fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-          layoutHome();
-          return;
-        }
-      }
-    }
-
-    if (!mayachain_signTxUpdateMsgDeposit(&(msg->deposit))) {
-      mayachain_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include deposit message in transaction");
-      layoutHome();
-      return;
-    }
+  if (!fsm_tendermintMsgDispatch(&mayachain_msgRegistry, msg)) {
+    return;
   }
 
   if (!mayachain_signingIsFinished()) {
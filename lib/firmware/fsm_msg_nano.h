@@ -96,7 +96,7 @@ void fsm_msgNanoSignTx(NanoSignTx *msg) {
   }
 
   HDNode *recip = NULL;
-  if (msg->link_recipient_n_count > 0) {
+  if (msg->link_recipient_n_count > 0 && !nano_recipientIsCached(msg)) {
     recip = fsm_getDerivedNode(coin->curve_name, msg->link_recipient_n,
                                msg->link_recipient_n_count, NULL);
     if (!recip) {
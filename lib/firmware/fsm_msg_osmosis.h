@@ -115,584 +115,439 @@ void fsm_msgOsmosisSignTx(const OsmosisSignTx *msg) {
   }
 
   memzero(node, sizeof(*node));
+  fsm_tendermintSummaryStart(msg->msg_count);
   msg_write(MessageType_MessageType_OsmosisMsgRequest, resp);
   layoutHome();
 }
 
-void fsm_msgOsmosisMsgAck(const OsmosisMsgAck *msg) {
-  /** Confirm transaction basics */
-  CHECK_PARAM(osmosis_signingIsInited(), "Signing not in progress");
-
-  const CoinType *coin = fsm_getCoin(true, "Osmosis");
-  if (!coin) {
-    return;
+/// Scales uosmo amounts to OSMO for display; other denoms are shown as is.
+static float osmosis_displayAmount(const char *amount, const char *denom,
+                                   const char **display_denom) {
+  float value = atof(amount);
+  *display_denom = denom;
+  if (!strcmp(denom, "uosmo")) {
+    value /= pow(10, OSMOSIS_PRECISION);
+    *display_denom = "OSMO";
   }
+  return value;
+}
 
-  const OsmosisSignTx *sign_tx = osmosis_getOsmosisSignTx();
-
-  /** Confirm required transaction parameters exist */
-  if (msg->has_send) {
-    if (!msg->send.has_to_address || !msg->send.has_amount) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-
-    float amount = atof(msg->send.amount);
-    const char *denom = msg->send.denom;
-    if (!strcmp(msg->send.denom, "uosmo")) {
-      amount /= pow(10, OSMOSIS_PRECISION);
-      denom = "OSMO";
-    }
-
-    char amount_str[103];
-    snprintf(amount_str, sizeof(amount_str) - 1, "%.6f %s", amount, denom);
-
-    /** Confirm transaction parameters on screen */
-    if (!confirm_transaction_output(
-            ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-            msg->send.to_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!osmosis_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include send message in transaction");
-      layoutHome();
-      return;
-    }
-
-  } else if (msg->has_delegate) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->delegate.has_delegator_address ||
-        !msg->delegate.has_validator_address || !msg->delegate.has_amount) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
-
-    float amount = atof(msg->delegate.amount);
-    const char *denom = msg->delegate.denom;
-    if (!strcmp(msg->delegate.denom, "uosmo")) {
-      amount /= pow(10, OSMOSIS_PRECISION);
-      denom = "OSMO";
-    }
+static bool osmosis_formatShares(const char *shares, size_t shares_size,
+                                 uint8_t out[34]) {
+  char insoamt[33] = {0};
+  memset(out, 0, 34);
+  strlcpy(insoamt, shares, MIN(sizeof(insoamt), shares_size));
+  return base_to_precision(out, (uint8_t *)insoamt, 34, strlen(insoamt),
+                           OSMOSIS_LP_ASSET_PRECISION) >= 0;
+}
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm_osmosis_address("Confirm Delegator Address",
-                                 msg->delegate.delegator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_validateSend(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->send.has_to_address && msg->send.has_amount;
+}
 
-    if (!confirm_osmosis_address("Confirm Validator Address",
-                                 msg->delegate.validator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmSend(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  const char *denom;
+  float amount =
+      osmosis_displayAmount(msg->send.amount, msg->send.denom, &denom);
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Amount",
-                 "%.6f %s", amount, denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+  char amount_str[103];
+  snprintf(amount_str, sizeof(amount_str) - 1, "%.6f %s", amount, denom);
 
-    if (!osmosis_signTxUpdateMsgDelegate(
-            msg->delegate.amount, msg->delegate.delegator_address,
-            msg->delegate.validator_address, msg->delegate.denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include delegate message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_undelegate) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->undelegate.has_delegator_address ||
-        !msg->undelegate.has_validator_address || !msg->undelegate.has_amount) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+  return confirm_transaction_output(
+      ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
+      msg->send.to_address);
+}
 
-    float amount = atof(msg->undelegate.amount);
-    const char *denom = msg->undelegate.denom;
-    if (!strcmp(msg->undelegate.denom, "uosmo")) {
-      amount /= pow(10, OSMOSIS_PRECISION);
-      denom = "OSMO";
-    }
+static bool osmosis_updateSend(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address);
+}
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm_osmosis_address("Confirm Delegator Address",
-                                 msg->undelegate.delegator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_validateDelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->delegate.has_delegator_address &&
+         msg->delegate.has_validator_address && msg->delegate.has_amount;
+}
 
-    if (!confirm_osmosis_address("Confirm Validator Address",
-                                 msg->undelegate.validator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmDelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  const char *denom;
+  float amount =
+      osmosis_displayAmount(msg->delegate.amount, msg->delegate.denom, &denom);
+
+  return confirm_osmosis_address("Confirm Delegator Address",
+                                 msg->delegate.delegator_address) &&
+         confirm_osmosis_address("Confirm Validator Address",
+                                 msg->delegate.validator_address) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Amount",
+                 "%.6f %s", amount, denom);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Amount",
-                 "%.6f %s", amount, denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateDelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgDelegate(
+      msg->delegate.amount, msg->delegate.delegator_address,
+      msg->delegate.validator_address, msg->delegate.denom);
+}
 
-    if (!osmosis_signTxUpdateMsgUndelegate(
-            msg->undelegate.amount, msg->undelegate.delegator_address,
-            msg->undelegate.validator_address, msg->undelegate.denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include undelegate message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_lp_add) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->lp_add.has_sender || !msg->lp_add.has_pool_id ||
-        !msg->lp_add.has_share_out_amount || !msg->lp_add.has_denom_in_max_a ||
-        !msg->lp_add.has_amount_in_max_a || !msg->lp_add.has_denom_in_max_b ||
-        !msg->lp_add.has_amount_in_max_b) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+static bool osmosis_isSigner(const char *address) {
+  const char *signer = osmosis_signerAddress();
+  return signer && strcmp(signer, address) == 0;
+}
 
-    char insoamt[33] = {0};
-    uint8_t outsoamt[34] = {0};
-    strlcpy(insoamt, msg->lp_add.share_out_amount,
-            sizeof(msg->lp_add.share_out_amount));
+/// Osmosis amounts are strings in the message's base denom. uosmo totals are
+/// shown in OSMO, other denoms as is.
+static bool osmosis_summarizeAmount(TendermintSummary *summary,
+                                    const char *action, const char *amount,
+                                    const char *denom) {
+  uint64_t value;
+  if (!tendermint_parseUint(amount, &value)) {
+    return false;
+  }
+  if (strcmp(denom, "uosmo") == 0) {
+    return tendermint_summaryAddAmount(summary, action, denom,
+                                       OSMOSIS_PRECISION, " OSMO", value);
+  }
+  return tendermint_summaryAddAmount(summary, action, denom, 0, NULL, value);
+}
 
-    if (base_to_precision(outsoamt, (uint8_t *)insoamt, sizeof(outsoamt),
-                          strlen(insoamt), OSMOSIS_LP_ASSET_PRECISION) < 0) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_Other, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_summarizeDelegate(const void *ack,
+                                      TendermintSummary *summary) {
+  const OsmosisMsgAck *msg = ack;
+  if (!osmosis_isSigner(msg->delegate.delegator_address) ||
+      !osmosis_summarizeAmount(summary, "Delegate", msg->delegate.amount,
+                               msg->delegate.denom)) {
+    return false;
+  }
+  return tendermint_summaryAddValidator(summary,
+                                        msg->delegate.validator_address);
+}
 
-    float amount_in_max_b = atof(msg->lp_add.amount_in_max_b);
-    const char *denom_in_max_b = msg->lp_add.denom_in_max_b;
-    if (!strcmp(msg->lp_add.denom_in_max_b, "uosmo")) {
-      amount_in_max_b /= pow(10, OSMOSIS_PRECISION);
-      denom_in_max_b = "OSMO";
-    }
+static bool osmosis_validateUndelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->undelegate.has_delegator_address &&
+         msg->undelegate.has_validator_address && msg->undelegate.has_amount;
+}
 
-    float amount_in_max_a = atof(msg->lp_add.amount_in_max_a);
-    const char *denom_in_max_a = msg->lp_add.denom_in_max_a;
-    if (!strcmp(msg->lp_add.denom_in_max_a, "uosmo")) {
-      amount_in_max_a /= pow(10, OSMOSIS_PRECISION);
-      denom_in_max_a = "OSMO";
-    }
+static bool osmosis_confirmUndelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  const char *denom;
+  float amount = osmosis_displayAmount(msg->undelegate.amount,
+                                       msg->undelegate.denom, &denom);
+
+  return confirm_osmosis_address("Confirm Delegator Address",
+                                 msg->undelegate.delegator_address) &&
+         confirm_osmosis_address("Confirm Validator Address",
+                                 msg->undelegate.validator_address) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Amount",
+                 "%.6f %s", amount, denom);
+}
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Add Liquidity",
-                 "Deposit %.6f %s and...", amount_in_max_b, denom_in_max_b)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateUndelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgUndelegate(
+      msg->undelegate.amount, msg->undelegate.delegator_address,
+      msg->undelegate.validator_address, msg->undelegate.denom);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Add Liquidity",
-                 "... %.6f %s?", amount_in_max_a, denom_in_max_a)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_summarizeUndelegate(const void *ack,
+                                        TendermintSummary *summary) {
+  const OsmosisMsgAck *msg = ack;
+  if (!osmosis_isSigner(msg->undelegate.delegator_address) ||
+      !osmosis_summarizeAmount(summary, "Undelegate", msg->undelegate.amount,
+                               msg->undelegate.denom)) {
+    return false;
+  }
+  return tendermint_summaryAddValidator(summary,
+                                        msg->undelegate.validator_address);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Pool ID",
-                 "%lld", msg->lp_add.pool_id)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_validateLPAdd(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  uint8_t outsoamt[34];
+  return msg->lp_add.has_sender && msg->lp_add.has_pool_id &&
+         msg->lp_add.has_share_out_amount && msg->lp_add.has_denom_in_max_a &&
+         msg->lp_add.has_amount_in_max_a && msg->lp_add.has_denom_in_max_b &&
+         msg->lp_add.has_amount_in_max_b &&
+         osmosis_formatShares(msg->lp_add.share_out_amount,
+                              sizeof(msg->lp_add.share_out_amount), outsoamt);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
+static bool osmosis_confirmLPAdd(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  uint8_t outsoamt[34];
+  osmosis_formatShares(msg->lp_add.share_out_amount,
+                       sizeof(msg->lp_add.share_out_amount), outsoamt);
+
+  const char *denom_in_max_b;
+  float amount_in_max_b = osmosis_displayAmount(
+      msg->lp_add.amount_in_max_b, msg->lp_add.denom_in_max_b, &denom_in_max_b);
+
+  const char *denom_in_max_a;
+  float amount_in_max_a = osmosis_displayAmount(
+      msg->lp_add.amount_in_max_a, msg->lp_add.denom_in_max_a, &denom_in_max_a);
+
+  return confirm(ButtonRequestType_ButtonRequest_Other, "Add Liquidity",
+                 "Deposit %.6f %s and...", amount_in_max_b, denom_in_max_b) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Add Liquidity",
+                 "... %.6f %s?", amount_in_max_a, denom_in_max_a) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Pool ID",
+                 "%lld", msg->lp_add.pool_id) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
                  "Confirm Share Out Amount", "Receive %s GAMM-%lld shares?",
-                 outsoamt, msg->lp_add.pool_id)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+                 outsoamt, msg->lp_add.pool_id);
+}
 
-    if (!osmosis_signTxUpdateMsgLPAdd(
-            msg->lp_add.pool_id, msg->lp_add.sender,
-            msg->lp_add.share_out_amount, msg->lp_add.amount_in_max_a,
-            msg->lp_add.denom_in_max_a, msg->lp_add.amount_in_max_b,
-            msg->lp_add.denom_in_max_b)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include LP add message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_lp_remove) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->lp_remove.has_sender || !msg->lp_remove.has_pool_id ||
-        !msg->lp_remove.has_share_in_amount ||
-        !msg->lp_remove.has_denom_out_min_a ||
-        !msg->lp_remove.has_amount_out_min_a ||
-        !msg->lp_remove.has_denom_out_min_b ||
-        !msg->lp_remove.has_amount_out_min_b) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateLPAdd(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgLPAdd(
+      msg->lp_add.pool_id, msg->lp_add.sender, msg->lp_add.share_out_amount,
+      msg->lp_add.amount_in_max_a, msg->lp_add.denom_in_max_a,
+      msg->lp_add.amount_in_max_b, msg->lp_add.denom_in_max_b);
+}
 
-    char insoamt[33] = {0};
-    uint8_t outsoamt[34] = {0};
-    strlcpy(insoamt, msg->lp_remove.share_in_amount,
-            sizeof(msg->lp_remove.share_in_amount));
+static bool osmosis_validateLPRemove(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  uint8_t outsoamt[34];
+  return msg->lp_remove.has_sender && msg->lp_remove.has_pool_id &&
+         msg->lp_remove.has_share_in_amount &&
+         msg->lp_remove.has_denom_out_min_a &&
+         msg->lp_remove.has_amount_out_min_a &&
+         msg->lp_remove.has_denom_out_min_b &&
+         msg->lp_remove.has_amount_out_min_b &&
+         osmosis_formatShares(msg->lp_remove.share_in_amount,
+                              sizeof(msg->lp_remove.share_in_amount),
+                              outsoamt);
+}
 
-    if (base_to_precision(outsoamt, (uint8_t *)insoamt, sizeof(outsoamt),
-                          strlen(insoamt), OSMOSIS_LP_ASSET_PRECISION) < 0) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_Other, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmLPRemove(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  uint8_t outsoamt[34];
+  osmosis_formatShares(msg->lp_remove.share_in_amount,
+                       sizeof(msg->lp_remove.share_in_amount), outsoamt);
 
-    float amount_out_min_b = atof(msg->lp_remove.amount_out_min_b);
-    const char *denom_out_min_b = msg->lp_remove.denom_out_min_b;
-    if (!strcmp(msg->lp_remove.denom_out_min_b, "uosmo")) {
-      amount_out_min_b /= pow(10, OSMOSIS_PRECISION);
-      denom_out_min_b = "OSMO";
-    }
+  const char *denom_out_min_b;
+  float amount_out_min_b =
+      osmosis_displayAmount(msg->lp_remove.amount_out_min_b,
+                            msg->lp_remove.denom_out_min_b, &denom_out_min_b);
 
-    float amount_out_min_a = atof(msg->lp_remove.amount_out_min_a);
-    const char *denom_out_min_a = msg->lp_remove.denom_out_min_a;
-    if (!strcmp(msg->lp_remove.denom_out_min_a, "uosmo")) {
-      amount_out_min_a /= pow(10, OSMOSIS_PRECISION);
-      denom_out_min_a = "OSMO";
-    }
+  const char *denom_out_min_a;
+  float amount_out_min_a =
+      osmosis_displayAmount(msg->lp_remove.amount_out_min_a,
+                            msg->lp_remove.denom_out_min_a, &denom_out_min_a);
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Remove Liquidity",
+  return confirm(ButtonRequestType_ButtonRequest_Other, "Remove Liquidity",
                  "Withdraw %.6f %s and...", amount_out_min_b,
-                 denom_out_min_b)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Remove Liquidity",
-                 "... %.6f %s ?", amount_out_min_a, denom_out_min_a)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Pool ID",
-                 "%lld", msg->lp_remove.pool_id)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Pool share amount",
+                 denom_out_min_b) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Remove Liquidity",
+                 "... %.6f %s ?", amount_out_min_a, denom_out_min_a) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Pool ID",
+                 "%lld", msg->lp_remove.pool_id) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Pool share amount",
                  "Redeem %s GAMM-%lld shares?", outsoamt,
-                 msg->lp_remove.pool_id)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!osmosis_signTxUpdateMsgLPRemove(
-            msg->lp_remove.pool_id, msg->lp_remove.sender,
-            msg->lp_remove.share_in_amount, msg->lp_remove.amount_out_min_a,
-            msg->lp_remove.denom_out_min_a, msg->lp_remove.amount_out_min_b,
-            msg->lp_remove.denom_out_min_b)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include rewards message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_redelegate) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->redelegate.has_delegator_address ||
-        !msg->redelegate.has_validator_src_address ||
-        !msg->redelegate.has_validator_dst_address ||
-        !msg->redelegate.has_amount) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+                 msg->lp_remove.pool_id);
+}
 
-    float amount = atof(msg->redelegate.amount) / pow(10, OSMOSIS_PRECISION);
+static bool osmosis_updateLPRemove(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgLPRemove(
+      msg->lp_remove.pool_id, msg->lp_remove.sender,
+      msg->lp_remove.share_in_amount, msg->lp_remove.amount_out_min_a,
+      msg->lp_remove.denom_out_min_a, msg->lp_remove.amount_out_min_b,
+      msg->lp_remove.denom_out_min_b);
+}
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Redelegate",
-                 "Redelegate %.6f OSMO?", amount)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_validateRedelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->redelegate.has_delegator_address &&
+         msg->redelegate.has_validator_src_address &&
+         msg->redelegate.has_validator_dst_address &&
+         msg->redelegate.has_amount;
+}
 
-    if (!confirm_osmosis_address("Delegator Address",
-                                 msg->redelegate.delegator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmRedelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  float amount = atof(msg->redelegate.amount) / pow(10, OSMOSIS_PRECISION);
+
+  return confirm(ButtonRequestType_ButtonRequest_Other, "Redelegate",
+                 "Redelegate %.6f OSMO?", amount) &&
+         confirm_osmosis_address("Delegator Address",
+                                 msg->redelegate.delegator_address) &&
+         confirm_osmosis_address("Validator Source Address",
+                                 msg->redelegate.validator_src_address) &&
+         confirm_osmosis_address("Validator Dest. Address",
+                                 msg->redelegate.validator_dst_address);
+}
 
-    if (!confirm_osmosis_address("Validator Source Address",
-                                 msg->redelegate.validator_src_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateRedelegate(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgRedelegate(
+      msg->redelegate.amount, msg->redelegate.delegator_address,
+      msg->redelegate.validator_src_address,
+      msg->redelegate.validator_dst_address, msg->redelegate.denom);
+}
 
-    if (!confirm_osmosis_address("Validator Dest. Address",
-                                 msg->redelegate.validator_dst_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_validateRewards(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->rewards.has_delegator_address &&
+         msg->rewards.has_validator_address;
+}
 
-    if (!osmosis_signTxUpdateMsgRedelegate(
-            msg->redelegate.amount, msg->redelegate.delegator_address,
-            msg->redelegate.validator_src_address,
-            msg->redelegate.validator_dst_address, msg->redelegate.denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include redelegate message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_rewards) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->rewards.has_delegator_address ||
-        !msg->rewards.has_validator_address) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmRewards(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return confirm(ButtonRequestType_ButtonRequest_Other, "Claim Rewards",
+                 "Claim all available rewards?") &&
+         confirm_osmosis_address("Confirm Delegator Address",
+                                 msg->rewards.delegator_address) &&
+         confirm_osmosis_address("Confirm Validator Address",
+                                 msg->rewards.validator_address);
+}
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Claim Rewards",
-                 "Claim all available rewards?")) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateRewards(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgRewards(msg->rewards.delegator_address,
+                                        msg->rewards.validator_address);
+}
 
-    if (!confirm_osmosis_address("Confirm Delegator Address",
-                                 msg->rewards.delegator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_summarizeRewards(const void *ack,
+                                     TendermintSummary *summary) {
+  const OsmosisMsgAck *msg = ack;
+  if (!osmosis_isSigner(msg->rewards.delegator_address)) {
+    return false;
+  }
+  return tendermint_summaryAddValidator(summary,
+                                        msg->rewards.validator_address);
+}
 
-    if (!confirm_osmosis_address("Confirm Validator Address",
-                                 msg->rewards.validator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_validateSwap(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->swap.has_sender && msg->swap.has_pool_id &&
+         msg->swap.has_token_out_denom && msg->swap.has_token_in_denom &&
+         msg->swap.has_token_in_amount && msg->swap.has_token_out_min_amount;
+}
 
-    if (!osmosis_signTxUpdateMsgRewards(msg->rewards.delegator_address,
-                                        msg->rewards.validator_address)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include rewards message in transaction");
-      layoutHome();
-      return;
-    }
-  } else if (msg->has_swap) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->swap.has_sender ||
-        !msg->swap.has_pool_id | !msg->swap.has_token_out_denom ||
-        !msg->swap.has_token_in_denom || !msg->swap.has_token_in_amount ||
-        !msg->swap.has_token_out_min_amount) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmSwap(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  const char *token_in_denom;
+  float token_in_amount = osmosis_displayAmount(
+      msg->swap.token_in_amount, msg->swap.token_in_denom, &token_in_denom);
 
-    float token_in_amount = atof(msg->swap.token_in_amount);
-    const char *token_in_denom = msg->swap.token_in_denom;
-    if (!strcmp(msg->swap.token_in_denom, "uosmo")) {
-      token_in_amount /= pow(10, OSMOSIS_PRECISION);
-      token_in_denom = "OSMO";
-    }
+  const char *token_out_denom;
+  float token_out_min_amount =
+      osmosis_displayAmount(msg->swap.token_out_min_amount,
+                            msg->swap.token_out_denom, &token_out_denom);
 
-    float token_out_min_amount = atof(msg->swap.token_out_min_amount);
-    const char *token_out_denom = msg->swap.token_out_denom;
-    if (!strcmp(msg->swap.token_out_denom, "uosmo")) {
-      token_out_min_amount /= pow(10, OSMOSIS_PRECISION);
-      token_out_denom = "OSMO";
-    }
-
-    /** Confirm transaction parameters on-screen */
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Swap",
+  return confirm(ButtonRequestType_ButtonRequest_Other, "Swap",
                  "Swap %.6f %s for at least %.6f %s?", token_in_amount,
-                 token_in_denom, token_out_min_amount, token_out_denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Pool ID",
-                 "%lld", msg->swap.pool_id)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (!osmosis_signTxUpdateMsgSwap(
-            msg->swap.pool_id, msg->swap.token_out_denom, msg->swap.sender,
-            msg->swap.token_in_amount, msg->swap.token_in_denom,
-            msg->swap.token_out_min_amount)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include swap message in transaction");
-      layoutHome();
-      return;
-    }
+                 token_in_denom, token_out_min_amount, token_out_denom) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Pool ID",
+                 "%lld", msg->swap.pool_id);
+}
 
-  } else if (msg->has_ibc_transfer) {
-    /** Confirm required transaction parameters exist */
-    if (!msg->ibc_transfer.has_sender ||
-        !msg->ibc_transfer.has_source_channel ||
-        !msg->ibc_transfer.has_source_port ||
-        !msg->ibc_transfer.has_revision_height ||
-        !msg->ibc_transfer.has_revision_number ||
-        !msg->ibc_transfer.has_denom) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_FirmwareError,
-                      _("Message is missing required parameters"));
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateSwap(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgSwap(
+      msg->swap.pool_id, msg->swap.token_out_denom, msg->swap.sender,
+      msg->swap.token_in_amount, msg->swap.token_in_denom,
+      msg->swap.token_out_min_amount);
+}
 
-    float amount = atof(msg->ibc_transfer.amount);
-    const char *denom = msg->ibc_transfer.denom;
-    if (!strcmp(msg->ibc_transfer.denom, "uosmo")) {
-      amount /= pow(10, OSMOSIS_PRECISION);
-      denom = "OSMO";
-    }
+static bool osmosis_validateIBCTransfer(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return msg->ibc_transfer.has_sender && msg->ibc_transfer.has_source_channel &&
+         msg->ibc_transfer.has_source_port &&
+         msg->ibc_transfer.has_revision_height &&
+         msg->ibc_transfer.has_revision_number && msg->ibc_transfer.has_denom;
+}
 
-    /** Confirm transaction parameters on-screen */
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "IBC Transfer",
-                 "Transfer %.6f %s?", amount, denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_confirmIBCTransfer(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  const char *denom;
+  float amount = osmosis_displayAmount(msg->ibc_transfer.amount,
+                                       msg->ibc_transfer.denom, &denom);
+
+  return confirm(ButtonRequestType_ButtonRequest_Other, "IBC Transfer",
+                 "Transfer %.6f %s?", amount, denom) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Dest. Addr",
+                 "%s", msg->ibc_transfer.receiver) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
+                 "Confirm Source Channel", "%s",
+                 msg->ibc_transfer.source_channel) &&
+         confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Source Port",
+                 "%s", msg->ibc_transfer.source_port) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
+                 "Confirm Revision Height", "%s",
+                 msg->ibc_transfer.revision_height) &&
+         confirm(ButtonRequestType_ButtonRequest_Other,
+                 "Confirm Revision Number", "%s",
+                 msg->ibc_transfer.revision_number);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Dest. Addr",
-                 "%s", msg->ibc_transfer.receiver)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static bool osmosis_updateIBCTransfer(const void *ack) {
+  const OsmosisMsgAck *msg = ack;
+  return osmosis_signTxUpdateMsgIBCTransfer(
+      msg->ibc_transfer.amount, msg->ibc_transfer.sender,
+      msg->ibc_transfer.receiver, msg->ibc_transfer.source_channel,
+      msg->ibc_transfer.source_port, msg->ibc_transfer.revision_number,
+      msg->ibc_transfer.revision_height, msg->ibc_transfer.denom);
+}
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
-                 "Confirm Source Channel", "%s",
-                 msg->ibc_transfer.source_channel)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+static const TendermintMsgHandler osmosis_msgHandlers[] = {
+    {offsetof(OsmosisMsgAck, has_send), osmosis_validateSend,
+     osmosis_confirmSend, osmosis_updateSend,
+     "Failed to include send message in transaction", NULL},
+    {offsetof(OsmosisMsgAck, has_delegate), osmosis_validateDelegate,
+     osmosis_confirmDelegate, osmosis_updateDelegate,
+     "Failed to include delegate message in transaction",
+     osmosis_summarizeDelegate},
+    {offsetof(OsmosisMsgAck, has_undelegate), osmosis_validateUndelegate,
+     osmosis_confirmUndelegate, osmosis_updateUndelegate,
+     "Failed to include undelegate message in transaction",
+     osmosis_summarizeUndelegate},
+    {offsetof(OsmosisMsgAck, has_lp_add), osmosis_validateLPAdd,
+     osmosis_confirmLPAdd, osmosis_updateLPAdd,
+     "Failed to include LP add message in transaction", NULL},
+    {offsetof(OsmosisMsgAck, has_lp_remove), osmosis_validateLPRemove,
+     osmosis_confirmLPRemove, osmosis_updateLPRemove,
+     "Failed to include LP remove message in transaction", NULL},
+    {offsetof(OsmosisMsgAck, has_redelegate), osmosis_validateRedelegate,
+     osmosis_confirmRedelegate, osmosis_updateRedelegate,
+     // Not summarized: a validator list cannot say which way stake moved.
+     "Failed to include redelegate message in transaction", NULL},
+    {offsetof(OsmosisMsgAck, has_rewards), osmosis_validateRewards,
+     osmosis_confirmRewards, osmosis_updateRewards,
+     "Failed to include rewards message in transaction",
+     osmosis_summarizeRewards},
+    {offsetof(OsmosisMsgAck, has_swap), osmosis_validateSwap,
+     osmosis_confirmSwap, osmosis_updateSwap,
+     "Failed to include swap message in transaction", NULL},
+    {offsetof(OsmosisMsgAck, has_ibc_transfer), osmosis_validateIBCTransfer,
+     osmosis_confirmIBCTransfer, osmosis_updateIBCTransfer,
+     "Failed to include IBC transfer message in transaction", NULL},
+};
+
+static const TendermintMsgRegistry osmosis_msgRegistry = {
+    osmosis_msgHandlers,
+    sizeof(osmosis_msgHandlers) / sizeof(osmosis_msgHandlers[0]),
+    osmosis_signAbort,
+    "Invalid Osmosis message type",
+    "Message is missing required parameters",
+};
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other, "Confirm Source Port",
-                 "%s", msg->ibc_transfer.source_port)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+void fsm_msgOsmosisMsgAck(const OsmosisMsgAck *msg) {
+  /** Confirm transaction basics */
+  CHECK_PARAM(osmosis_signingIsInited(), "Signing not in progress");
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
-                 "Confirm Revision Height", "%s",
-                 msg->ibc_transfer.revision_height)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+  const CoinType *coin = fsm_getCoin(true, "Osmosis");
+  if (!coin) {
+    return;
+  }
 
-    if (!confirm(ButtonRequestType_ButtonRequest_Other,
-                 "Confirm Revision Number", "%s",
-                 msg->ibc_transfer.revision_number)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
+  const OsmosisSignTx *sign_tx = osmosis_getOsmosisSignTx();
 
-    if (!osmosis_signTxUpdateMsgIBCTransfer(
-            msg->ibc_transfer.amount, msg->ibc_transfer.sender,
-            msg->ibc_transfer.receiver, msg->ibc_transfer.source_channel,
-            msg->ibc_transfer.source_port, msg->ibc_transfer.revision_number,
-            msg->ibc_transfer.revision_height, msg->ibc_transfer.denom)) {
-      osmosis_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include IBC transfer message in transaction");
-      layoutHome();
-      return;
-    }
-  } else {
-    osmosis_signAbort();
-    fsm_sendFailure(FailureType_Failure_FirmwareError,
-                    _("Invalid Osmosis message type"));
-    layoutHome();
+  if (!fsm_tendermintMsgDispatch(&osmosis_msgRegistry, msg)) {
     return;
   }
 
@@ -702,6 +557,10 @@ void fsm_msgOsmosisMsgAck(const OsmosisMsgAck *msg) {
     return;
   }
 
+  if (!fsm_tendermintSummaryConfirm(&osmosis_msgRegistry)) {
+    return;
+  }
+
   if (sign_tx->has_memo && (strlen(sign_tx->memo) > 0)) {
     if (!confirm(ButtonRequestType_ButtonRequest_ConfirmMemo, _("Memo"), "%s",
                  sign_tx->memo)) {
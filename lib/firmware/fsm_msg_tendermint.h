@@ -166,6 +166,8 @@ void fsm_msgTendermintMsgAck(const TendermintMsgAck *msg) {
     return;
   }
 
+  tendermint_signTxPresign();
+
   if (sign_tx->has_memo && !confirm(ButtonRequestType_ButtonRequest_ConfirmMemo,
                                     _("Memo"), "%s", sign_tx->memo)) {
     tendermint_signAbort();
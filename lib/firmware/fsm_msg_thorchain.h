@@ -115,22 +115,87 @@ void fsm_msgThorchainSignTx(const ThorchainSignTx *msg) {
   layoutHome();
 }
 
+static bool thorchain_validateSend(const void *ack) {
+  const ThorchainMsgAck *msg = ack;
+  return msg->send.has_to_address && msg->send.has_amount;
+}
+
+static bool thorchain_confirmSend(const void *ack) {
+  const ThorchainMsgAck *msg = ack;
+  switch (msg->send.address_type) {
+    case OutputAddressType_TRANSFER:
+    default: {
+      char amount_str[32];
+      bn_format_uint64(msg->send.amount, NULL, " RUNE", 8, 0, false,
+                       amount_str, sizeof(amount_str));
+      return confirm_transaction_output(
+          ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
+          msg->send.to_address);
+    }
+  }
+}
+
+static bool thorchain_updateSend(const void *ack) {
+  const ThorchainMsgAck *msg = ack;
+  return thorchain_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address);
+}
+
+static bool thorchain_validateDeposit(const void *ack) {
+  const ThorchainMsgAck *msg = ack;
+  return msg->deposit.has_asset && msg->deposit.has_amount &&
+         msg->deposit.has_memo && msg->deposit.has_signer;
+}
+
+static bool thorchain_confirmDeposit(const void *ack) {
+  const ThorchainMsgAck *msg = ack;
+  char amount_str[32];
+  char asset_str[21];
+  asset_str[0] = ' ';
+  strlcpy(&(asset_str[1]), msg->deposit.asset, sizeof(asset_str) - 1);
+  bn_format_uint64(msg->deposit.amount, NULL, asset_str, 8, 0, false,
+                   amount_str, sizeof(amount_str));
+  if (!confirm_transaction_output(ButtonRequestType_ButtonRequest_ConfirmOutput,
+                                  amount_str, msg->deposit.signer)) {
+    return false;
+  }
+
+  // See if we can parse the memo
+  if (thorchain_parseConfirmMemo(msg->deposit.memo,
+                                 sizeof(msg->deposit.memo))) {
+    return true;
+  }
+
+  // Memo not recognizable, ask to confirm it
+  return confirm(ButtonRequestType_ButtonRequest_ConfirmMemo, _("Memo"), "%s",
+                 msg->deposit.memo);
+}
+
+static bool thorchain_updateDeposit(const void *ack) {
+  const ThorchainMsgAck *msg = ack;
+  return thorchain_signTxUpdateMsgDeposit(&(msg->deposit));
+}
+
+static const TendermintMsgHandler thorchain_msgHandlers[] = {
+    {offsetof(ThorchainMsgAck, has_send), thorchain_validateSend,
+     thorchain_confirmSend, thorchain_updateSend,
+     "Failed to include send message in transaction", NULL},
+    {offsetof(ThorchainMsgAck, has_deposit), thorchain_validateDeposit,
+     thorchain_confirmDeposit, thorchain_updateDeposit,
+     "Failed to include deposit message in transaction", NULL},
+};
+
+static const TendermintMsgRegistry thorchain_msgRegistry = {
+    thorchain_msgHandlers,
+    sizeof(thorchain_msgHandlers) / sizeof(thorchain_msgHandlers[0]),
+    thorchain_signAbort,
+    "Invalid THORChain Message Type",
+    "Invalid THORChain Message Type",
+};
+
 void fsm_msgThorchainMsgAck(const ThorchainMsgAck *msg) {
   // Confirm transaction basics
   // supports only 1 message ack
   CHECK_PARAM(thorchain_signingIsInited(), "Signing not in progress");
-  if (msg->has_send && msg->send.has_to_address && msg->send.has_amount) {
-    // pass
-  } else if (msg->has_deposit && msg->deposit.has_asset && msg->deposit.has_amount &&
-             msg->deposit.has_memo && msg->deposit.has_signer) {
-               // pass
-  } else {
-    thorchain_signAbort();
-    fsm_sendFailure(FailureType_Failure_FirmwareError,
-                    _("Invalid THORChain Message Type"));
-    layoutHome();
-    return;
-  }
 
   const CoinType *coin = fsm_getCoin(true, "THORChain");
   if (!coin) {
@@ -139,70 +204,8 @@ void fsm_msgThorchainMsgAck(const ThorchainMsgAck *msg) {
 
   const ThorchainSignTx *sign_tx = thorchain_getThorchainSignTx();
 
-  if (msg->has_send) {
-    switch (msg->send.address_type) {
-      case OutputAddressType_TRANSFER:
-      default: {
-        char amount_str[32];
-        bn_format_uint64(msg->send.amount, NULL, " RUNE", 8, 0, false, amount_str,
-                         sizeof(amount_str));
-        if (!confirm_transaction_output(
-                ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-                msg->send.to_address)) {
-          thorchain_signAbort();
-          fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-          layoutHome();
-          return;
-        }
-
-        break;
-      }
-    }
-    if (!thorchain_signTxUpdateMsgSend(msg->send.amount, msg->send.to_address)) {
-      thorchain_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include send message in transaction");
-      layoutHome();
-      return;
-    }
-
-  } else if (msg->has_deposit) {
-    char amount_str[32];
-    char asset_str[21];
-    asset_str[0] = ' ';
-    strlcpy(&(asset_str[1]), msg->deposit.asset, sizeof(asset_str) - 1);
-    bn_format_uint64(msg->deposit.amount, NULL, asset_str, 8, 0, false, amount_str,
-                     sizeof(amount_str));
-    if (!confirm_transaction_output(
-            ButtonRequestType_ButtonRequest_ConfirmOutput, amount_str,
-            msg->deposit.signer)) {
-      thorchain_signAbort();
-      fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-      layoutHome();
-      return;
-    }
-
-    if (msg->deposit.has_memo) {
-      // See if we can parse the memo
-      if (!thorchain_parseConfirmMemo(msg->deposit.memo, sizeof(msg->deposit.memo))) {
-        // Memo not recognizable, ask to confirm it
-        if (!confirm(ButtonRequestType_ButtonRequest_ConfirmMemo, _("Memo"), "%s",
-                     msg->deposit.memo)) {
-          thorchain_signAbort();
-          fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
-          layoutHome();
-          return;
-        }
-      }
-    }
-
-    if (!thorchain_signTxUpdateMsgDeposit(&(msg->deposit))) {
-      thorchain_signAbort();
-      fsm_sendFailure(FailureType_Failure_SyntaxError,
-                      "Failed to include deposit message in transaction");
-      layoutHome();
-      return;
-    }
+  if (!fsm_tendermintMsgDispatch(&thorchain_msgRegistry, msg)) {
+    return;
   }
 
 
@@ -23,6 +23,7 @@
 #include "keepkey/firmware/home_sm.h"
 #include "keepkey/firmware/storage.h"
 #include "keepkey/firmware/tendermint.h"
+#include "keepkey/firmware/thorchain_memo.h"
 #include "trezor/crypto/secp256k1.h"
 #include "trezor/crypto/ecdsa.h"
 #include "trezor/crypto/memzero.h"
@@ -32,7 +33,7 @@
 #include <time.h>
 
 static CONFIDENTIAL HDNode node;
-static SHA256_CTX ctx;
+static TendermintJsonHasher json;
 static bool initialized;
 static uint32_t msgs_remaining;
 static MayachainSignTx msg;
@@ -53,45 +54,35 @@ bool mayachain_signTxInit(const HDNode *_node, const MayachainSignTx *_msg) {
   memcpy(&node, _node, sizeof(node));
   memcpy(&msg, _msg, sizeof(msg));
 
-  bool success = true;
-  char buffer[64 + 1];
+  tendermint_jsonInit(&json);
 
-  sha256_Init(&ctx);
-
-  // Each segment guaranteed to be less than or equal to 64 bytes
-  // 19 + ^20 + 1 = ^40
-  if (!tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"account_number\":\"%" PRIu64 "\"",
-                                 msg.account_number))
-    return false;
+  tendermint_jsonWriteStr(&json, "{\"account_number\":\"");
+  tendermint_jsonWriteUint(&json, msg.account_number);
+  tendermint_jsonWriteStr(&json, "\"");
 
   // <escape chain_id>
   const char *const chainid_prefix = ",\"chain_id\":\"";
-  sha256_Update(&ctx, (uint8_t *)chainid_prefix, strlen(chainid_prefix));
-  tendermint_sha256UpdateEscaped(&ctx, msg.chain_id, strlen(msg.chain_id));
+  tendermint_jsonWrite(&json, chainid_prefix, strlen(chainid_prefix));
+  tendermint_jsonWriteEscaped(&json, msg.chain_id, strlen(msg.chain_id));
 
-  // 30 + ^10 + 19 = ^59
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "\",\"fee\":{\"amount\":[{\"amount\":\"%" PRIu32
-                          "\",\"denom\":\"cacao\"}]",
-                          msg.fee_amount);
+  tendermint_jsonWriteStr(&json, "\",\"fee\":{\"amount\":[{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, msg.fee_amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"cacao\"}]");
 
-  // 8 + ^10 + 2 = ^20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"gas\":\"%" PRIu32 "\"}", msg.gas);
+  tendermint_jsonWriteStr(&json, ",\"gas\":\"");
+  tendermint_jsonWriteUint(&json, msg.gas);
+  tendermint_jsonWriteStr(&json, "\"}");
 
   // <escape memo>
   const char *const memo_prefix = ",\"memo\":\"";
-  sha256_Update(&ctx, (uint8_t *)memo_prefix, strlen(memo_prefix));
+  tendermint_jsonWrite(&json, memo_prefix, strlen(memo_prefix));
   if (msg.has_memo) {
-    tendermint_sha256UpdateEscaped(&ctx, msg.memo, strlen(msg.memo));
+    tendermint_jsonWriteEscaped(&json, msg.memo, strlen(msg.memo));
   }
 
-  // 10
-  sha256_Update(&ctx, (uint8_t *)"\",\"msgs\":[", 10);
+  tendermint_jsonWrite(&json, "\",\"msgs\":[", 10);
 
-  return success;
+  return true;
 }
 
 bool mayachain_signTxUpdateMsgSend(const uint64_t amount,
@@ -100,7 +91,6 @@ bool mayachain_signTxUpdateMsgSend(const uint64_t amount,
   char mainnetp[] = "maya";
   char testnetp[] = "smaya";
   char *pfix;
-  char buffer[64 + 1];
 
   size_t decoded_len;
   char hrp[45];
@@ -120,72 +110,62 @@ bool mayachain_signTxUpdateMsgSend(const uint64_t amount,
     return false;
   }
 
-  bool success = true;
-
   const char *const prelude = "{\"type\":\"mayachain/MsgSend\",\"value\":{";
-  sha256_Update(&ctx, (uint8_t *)prelude, strlen(prelude));
+  tendermint_jsonWrite(&json, prelude, strlen(prelude));
 
-  // 21 + ^20 + 11 + ^69 + 3 = ^124
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"amount\":[{\"amount\":\"%" PRIu64 "\",\"denom\":\"%s\"}]", amount, denom);
+  tendermint_jsonWriteStr(&json, "\"amount\":[{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}]");
 
-  // 17 + 45 + 1 = 63
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"from_address\":\"%s\"", from_address);
+  tendermint_jsonWriteStr(&json, ",\"from_address\":\"");
+  tendermint_jsonWriteStr(&json, from_address);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 15 + 45 + 3 = 63
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"to_address\":\"%s\"}}", to_address);
+  tendermint_jsonWriteStr(&json, ",\"to_address\":\"");
+  tendermint_jsonWriteStr(&json, to_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool mayachain_signTxUpdateMsgDeposit(const MayachainMsgDeposit *depmsg) {
-  char buffer[64 + 1];
-
-  bool success = true;
-
   const char *const prelude = "{\"type\":\"mayachain/MsgDeposit\",\"value\":{";
-  sha256_Update(&ctx, (uint8_t *)prelude, strlen(prelude));
+  tendermint_jsonWrite(&json, prelude, strlen(prelude));
 
-  // 20 + ^20 + 1 = ^41
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"coins\":[{\"amount\":\"%" PRIu64 "\"", depmsg->amount);
+  tendermint_jsonWriteStr(&json, "\"coins\":[{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, depmsg->amount);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 10 + ^20 + 3 = ^33
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      ",\"asset\":\"%s\"}]", depmsg->asset);
+  tendermint_jsonWriteStr(&json, ",\"asset\":\"");
+  tendermint_jsonWriteStr(&json, depmsg->asset);
+  tendermint_jsonWriteStr(&json, "\"}]");
 
   // <escape memo>
   const char *const memo_prefix = ",\"memo\":\"";
-  sha256_Update(&ctx, (uint8_t *)memo_prefix, strlen(memo_prefix));
-  tendermint_sha256UpdateEscaped(&ctx, depmsg->memo, strlen(depmsg->memo));
+  tendermint_jsonWrite(&json, memo_prefix, strlen(memo_prefix));
+  tendermint_jsonWriteEscaped(&json, depmsg->memo, strlen(depmsg->memo));
 
-  // 17 + 45 + 1 = 63
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\",\"signer\":\"%s\"}}", depmsg->signer);
+  tendermint_jsonWriteStr(&json, "\",\"signer\":\"");
+  tendermint_jsonWriteStr(&json, depmsg->signer);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool mayachain_signTxFinalize(uint8_t *public_key, uint8_t *signature) {
-  char buffer[64 + 1];
-  
-  // 16 + ^20 = ^36
-  if (!tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                           "],\"sequence\":\"%" PRIu64 "\"}", msg.sequence))
-    return false;
+  tendermint_jsonWriteStr(&json, "],\"sequence\":\"");
+  tendermint_jsonWriteUint(&json, msg.sequence);
+  tendermint_jsonWriteStr(&json, "\"}");
 
   hdnode_fill_public_key(&node);
   memcpy(public_key, node.public_key, 33);
 
   uint8_t hash[SHA256_DIGEST_LENGTH];
-  sha256_Final(&ctx, hash);
+  tendermint_jsonFinal(&json, hash);
   return ecdsa_sign_digest(&secp256k1, node.private_key, hash, signature, NULL,
                            NULL) == 0;
 }
@@ -203,124 +183,15 @@ void mayachain_signAbort(void) {
 
 bool mayachain_parseConfirmMemo(const char *swapStr, size_t size) {
   /*
-    Input: swapStr is candidate mayachain data
-           size is the size of swapStr (<= 256)
-    Memos should be of the form:
-    transaction:chain.ticker-id:destination:limit
-                ^^^^^^^^^^^^^^----------asset
-
-    So, swap USDT to dest address 0x41e55..., limit 420
+    Memos are of the form transaction:chain.ticker-id:destination:limit, e.g.
+    swap USDT to dest address 0x41e55..., limit 420:
     SWAP:ETH.USDT-0xdac17f958d2ee523a2206206994597c13d831ec7:0x41e5560054824ea6b0732e656e3ad64e20e94e45:420
 
-    Swap transactions can be indicated by "SWAP" or "s" or "="
+    See thorchain_memoParse for the full grammar.
   */
-
-  char *parseTokPtrs[7] = {NULL, NULL, NULL, NULL,
-                           NULL, NULL, NULL};  // we can parse up to 7 tokens
-  char *tok;
-  char memoBuf[256];
-  uint16_t ctr;
-
-  // check if memo data is recognized
-
-  if (size > sizeof(memoBuf)) return false;
-  memzero(memoBuf, sizeof(memoBuf));
-  strlcpy(memoBuf, swapStr, size);
-  memoBuf[255] = '\0';  // ensure null termination
-  tok = strtok(memoBuf, ":");
-
-  // get transaction and asset
-  for (ctr = 0; ctr < 3; ctr++) {
-    if (tok != NULL) {
-      parseTokPtrs[ctr] = tok;
-      tok = strtok(NULL, ":.");
-    } else {
-      break;
-    }
-  }
-
-  if (ctr != 3) {
-    // Must have three tokens at this point: transaction, chain, asset. If
-    // not, just confirm data
-    return false;
-  }
-
-  // Check for swap
-  if (strncmp(parseTokPtrs[0], "SWAP", 4) == 0 || *parseTokPtrs[0] == 's' ||
-      *parseTokPtrs[0] == '=') {
-    // This is a swap, set up destination and limit
-    // This is the dest, may be blank which means swap to self
-    parseTokPtrs[3] = "self";
-    parseTokPtrs[4] = "none";
-    if (tok != NULL) {
-      if ((uint32_t)(tok - (parseTokPtrs[2] + strlen(parseTokPtrs[2]))) == 1) {
-        // has dest address
-        parseTokPtrs[3] = tok;
-        tok = strtok(NULL, ":");
-      }
-      if (tok != NULL) {
-        // has limit
-        parseTokPtrs[4] = tok;
-      }
-    }
-
-    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput,
-                 "Mayachain swap", "Confirm swap asset %s\n on chain %s", parseTokPtrs[2], parseTokPtrs[1])) {
-      return false;
-    }
-    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput,
-                 "Mayachain swap", "Confirm to %s", parseTokPtrs[3])) {
-      return false;
-    }
-    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput,
-                 "Mayachain swap", "Confirm limit %s", parseTokPtrs[4])) {
-      return false;
-    }
-    return true;
-  }
-
-  // Check for add liquidity
-  else if (strncmp(parseTokPtrs[0], "ADD", 3) == 0 || *parseTokPtrs[0] == 'a' ||
-           *parseTokPtrs[0] == '+') {
-    if (tok != NULL) {
-      // add liquidity pool address
-      parseTokPtrs[3] = tok;
-    } 
-
-    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput,
-                 "Mayachain add liquidity", "Confirm add asset %s\n on chain %s pool",
-                 parseTokPtrs[2], parseTokPtrs[1])) {
-      return false;
-    }
-    if (tok != NULL) {
-      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput,
-                 "Mayachain add liquidity", "Confirm to %s", parseTokPtrs[3])) {
-        return false;
-      }
-    }
-    return true;
-  }
-
-  // Check for withdraw liquidity
-  else if (strncmp(parseTokPtrs[0], "WITHDRAW", 8) == 0 || strncmp(parseTokPtrs[0], "wd", 2) == 0 ||
-           *parseTokPtrs[0] == '-') {
-    if (tok != NULL) {
-      // add liquidity pool address
-      parseTokPtrs[3] = tok;
-    } else {
-      return false;     // malformed memo
-    }
-
-    float percent = (float)(atoi(parseTokPtrs[3])) / 100;
-    if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput,
-                 "Mayachain withdraw liquidity", "Confirm withdraw %3.2f%% of asset %s on chain %s",
-                 percent, parseTokPtrs[2], parseTokPtrs[1])) {
-      return false;
-    }
-    return true;
-
-  } else {
-    // Just confirm whatever coin data if no mayachain intention data parsable
+  ThorchainMemo memo;
+  if (!thorchain_memoParse(swapStr, size, &memo)) {
     return false;
   }
+  return thorchain_memoConfirm(&memo, "Mayachain");
 }
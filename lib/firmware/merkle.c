@@ -0,0 +1,70 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2024 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/merkle.h"
+
+#include "trezor/crypto/hasher.h"
+
+#include <string.h>
+
+static void merkle_hashPair(const uint8_t *left, const uint8_t *right,
+                            uint8_t *out) {
+  uint8_t pair[64];
+  memcpy(pair, left, 32);
+  memcpy(pair + 32, right, 32);
+  hasher_Raw(HASHER_SHA2D, pair, sizeof(pair), out);
+}
+
+void merkle_init(MerkleTree *tree) { memset(tree, 0, sizeof(*tree)); }
+
+bool merkle_add(MerkleTree *tree, const uint8_t leaf[32]) {
+  if (tree->count == (1u << MERKLE_LEVELS) - 1) return false;
+
+  uint8_t hash[32];
+  memcpy(hash, leaf, 32);
+  tree->count++;
+  // Each trailing zero bit of the count completes a subtree
+  int level = 0;
+  for (; !(tree->count & (1u << level)); level++) {
+    merkle_hashPair(tree->inner[level], hash, hash);
+  }
+  memcpy(tree->inner[level], hash, 32);
+  return true;
+}
+
+bool merkle_root(const MerkleTree *tree, uint8_t root[32]) {
+  if (tree->count == 0) return false;
+
+  uint32_t count = tree->count;
+  int level = 0;
+  while (!(count & (1u << level))) level++;
+  memcpy(root, tree->inner[level], 32);
+  // Pad the lowest incomplete subtree by duplication until it completes,
+  // then fold in the complete subtrees to its left.
+  while (count != (1u << level)) {
+    merkle_hashPair(root, root, root);
+    count += 1u << level;
+    level++;
+    while (!(count & (1u << level))) {
+      merkle_hashPair(tree->inner[level], root, root);
+      level++;
+    }
+  }
+  return true;
+}
@@ -8,6 +8,7 @@
 #include "trezor/crypto/blake2b.h"
 #include "trezor/crypto/memzero.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <inttypes.h>
@@ -29,6 +30,29 @@ static char representative_address[MAX_NANO_ADDR_SIZE];
 static char recipient_address[MAX_NANO_ADDR_SIZE];
 static const CoinType *coin = NULL;
 
+/// The last block signed, so that the next block of a chain on the same
+/// account can use its hash as the frontier without re-hashing it.
+static struct {
+  bool valid;
+  const CoinType *coin;
+  ed25519_public_key account_pk;
+  uint8_t parent_hash[32];
+  uint8_t link[32];
+  char representative[MAX_NANO_ADDR_SIZE];
+  ed25519_public_key representative_pk;
+  uint8_t balance_be[16];
+  uint8_t block_hash[32];
+} frontier;
+
+/// The last link_recipient_n public key derived for this account.
+static struct {
+  bool valid;
+  ed25519_public_key account_pk;
+  uint32_t address_n[8];
+  size_t address_n_count;
+  ed25519_public_key public_key;
+} recipient;
+
 static uint8_t const NANO_BLOCK_HASH_PREAMBLE[32] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -79,54 +103,60 @@ void nano_hash_block_data(const uint8_t _account_pk[32],
   blake2b_Final(&ctx, _out_hash, 32);
 }
 
-const char *nano_getKnownRepName(const char *addr) {
-  static const struct {
-    const char *name;
-    const char *addr;
-  } reps[] = {
-      {"@meltingice ",
-       "xrb_1x7biz69cem95oo7gxkrw6kzhfywq4x5dupw4z1bdzkb74dk9kpxwzjbdhhs"},
-      {"@nanovault-rep ",
-       "xrb_3rw4un6ys57hrb39sy1qx8qy5wukst1iiponztrz9qiz6qqa55kxzx4491or"},
-      {"@nanowallet_rep1 ",
-       "xrb_3pczxuorp48td8645bs3m6c3xotxd3idskrenmi65rbrga5zmkemzhwkaznh"},
-      {"Binance Rep ",
-       "xrb_3jwrszth46rk1mu7rmb4rhm54us8yg1gw3ipodftqtikf5yqdyr7471nsg1k"},
-      {"BrainBlocks Rep ",
-       "xrb_1brainb3zz81wmhxndsbrjb94hx3fhr1fyydmg6iresyk76f3k7y7jiazoji"},
-      {"Genesis ",
-       "xrb_3t6k35gi95xu6tergt6p69ck76ogmitsa8mnijtpxm9fkcm736xtoncuohr3"},
-      {"KuCoin 1 ",
-       "xrb_1niabkx3gbxit5j5yyqcpas71dkffggbr6zpd3heui8rpoocm5xqbdwq44oh"},
-      {"NanoWallet Bot Rep ",
-       "xrb_16k5pimotz9zehjk795wa4qcx54mtusk8hc5mdsjgy57gnhbj3hj6zaib4ic"},
-      {"Nanode Rep ",
-       "xrb_1nanode8ngaakzbck8smq6ru9bethqwyehomf79sae1k7xd47dkidjqzffeg"},
-      {"OKEx Rep ",
-       "xrb_1tig1rio7iskejqgy6ap75rima35f9mexjazdqqquthmyu48118jiewny7zo"},
-      {"Official Rep 1 ",
-       "xrb_3arg3asgtigae3xckabaaewkx3bzsh7nwz7jkmjos79ihyaxwphhm6qgjps4"},
-      {"Official Rep 2 ",
-       "xrb_1stofnrxuz3cai7ze75o174bpm7scwj9jn3nxsn8ntzg784jf1gzn1jjdkou"},
-      {"Official Rep 3 ",
-       "xrb_1q3hqecaw15cjt7thbtxu3pbzr1eihtzzpzxguoc37bj1wc5ffoh7w74gi6p"},
-      {"Official Rep 4 ",
-       "xrb_3dmtrrws3pocycmbqwawk6xs7446qxa36fcncush4s1pejk16ksbmakis78m"},
-      {"Official Rep 5 ",
-       "xrb_3hd4ezdgsp15iemx7h81in7xz5tpxi43b6b41zn3qmwiuypankocw3awes5k"},
-      {"Official Rep 6 ",
-       "xrb_1awsn43we17c1oshdru4azeqjz9wii41dy8npubm4rg11so7dx3jtqgoeahy"},
-      {"Official Rep 7 ",
-       "xrb_1anrzcuwe64rwxzcco8dkhpyxpi8kd7zsjc1oeimpc3ppca4mrjtwnqposrs"},
-      {"Official Rep 8 ",
-       "xrb_1hza3f7wiiqa7ig3jczyxj5yo86yegcmqk3criaz838j91sxcckpfhbhhra1"},
-  };
-
-  for (size_t i = 0; i < sizeof(reps) / sizeof(reps[0]); i++) {
-    if (strcmp(addr, reps[i].addr) == 0) return reps[i].name;
-  }
+typedef struct {
+  const char *addr;
+  const char *name;
+} NanoKnownRep;
+
+// Sorted by address, for nano_getKnownRepName's binary search.
+static const NanoKnownRep known_reps[] = {
+    {"xrb_16k5pimotz9zehjk795wa4qcx54mtusk8hc5mdsjgy57gnhbj3hj6zaib4ic",
+     "NanoWallet Bot Rep "},
+    {"xrb_1anrzcuwe64rwxzcco8dkhpyxpi8kd7zsjc1oeimpc3ppca4mrjtwnqposrs",
+     "Official Rep 7 "},
+    {"xrb_1awsn43we17c1oshdru4azeqjz9wii41dy8npubm4rg11so7dx3jtqgoeahy",
+     "Official Rep 6 "},
+    {"xrb_1brainb3zz81wmhxndsbrjb94hx3fhr1fyydmg6iresyk76f3k7y7jiazoji",
+     "BrainBlocks Rep "},
+    {"xrb_1hza3f7wiiqa7ig3jczyxj5yo86yegcmqk3criaz838j91sxcckpfhbhhra1",
+     "Official Rep 8 "},
+    {"xrb_1nanode8ngaakzbck8smq6ru9bethqwyehomf79sae1k7xd47dkidjqzffeg",
+     "Nanode Rep "},
+    {"xrb_1niabkx3gbxit5j5yyqcpas71dkffggbr6zpd3heui8rpoocm5xqbdwq44oh",
+     "KuCoin 1 "},
+    {"xrb_1q3hqecaw15cjt7thbtxu3pbzr1eihtzzpzxguoc37bj1wc5ffoh7w74gi6p",
+     "Official Rep 3 "},
+    {"xrb_1stofnrxuz3cai7ze75o174bpm7scwj9jn3nxsn8ntzg784jf1gzn1jjdkou",
+     "Official Rep 2 "},
+    {"xrb_1tig1rio7iskejqgy6ap75rima35f9mexjazdqqquthmyu48118jiewny7zo",
+     "OKEx Rep "},
+    {"xrb_1x7biz69cem95oo7gxkrw6kzhfywq4x5dupw4z1bdzkb74dk9kpxwzjbdhhs",
+     "@meltingice "},
+    {"xrb_3arg3asgtigae3xckabaaewkx3bzsh7nwz7jkmjos79ihyaxwphhm6qgjps4",
+     "Official Rep 1 "},
+    {"xrb_3dmtrrws3pocycmbqwawk6xs7446qxa36fcncush4s1pejk16ksbmakis78m",
+     "Official Rep 4 "},
+    {"xrb_3hd4ezdgsp15iemx7h81in7xz5tpxi43b6b41zn3qmwiuypankocw3awes5k",
+     "Official Rep 5 "},
+    {"xrb_3jwrszth46rk1mu7rmb4rhm54us8yg1gw3ipodftqtikf5yqdyr7471nsg1k",
+     "Binance Rep "},
+    {"xrb_3pczxuorp48td8645bs3m6c3xotxd3idskrenmi65rbrga5zmkemzhwkaznh",
+     "@nanowallet_rep1 "},
+    {"xrb_3rw4un6ys57hrb39sy1qx8qy5wukst1iiponztrz9qiz6qqa55kxzx4491or",
+     "@nanovault-rep "},
+    {"xrb_3t6k35gi95xu6tergt6p69ck76ogmitsa8mnijtpxm9fkcm736xtoncuohr3",
+     "Genesis "},
+};
+
+static int known_rep_compare(const void *key, const void *elem) {
+  return strcmp((const char *)key, ((const NanoKnownRep *)elem)->addr);
+}
 
-  return NULL;
+const char *nano_getKnownRepName(const char *addr) {
+  const NanoKnownRep *rep =
+      bsearch(addr, known_reps, sizeof(known_reps) / sizeof(known_reps[0]),
+              sizeof(known_reps[0]), known_rep_compare);
+  return rep ? rep->name : NULL;
 }
 
 void nano_truncateAddress(const CoinType *_coin, char *str) {
@@ -187,9 +217,37 @@ bool nano_signingInit(const NanoSignTx *msg, const HDNode *node,
   return !invalid;
 }
 
+static bool nano_frontierMatches(const NanoSignTx *msg) {
+  if (!frontier.valid || frontier.coin != coin) return false;
+  if (memcmp(frontier.account_pk, account_pk, sizeof(account_pk))) return false;
+
+  uint8_t expected_parent[32] = {0};
+  if (msg->parent_block.has_parent_hash) {
+    memcpy(expected_parent, msg->parent_block.parent_hash.bytes,
+           sizeof(expected_parent));
+  }
+
+  return !memcmp(frontier.parent_hash, expected_parent,
+                 sizeof(expected_parent)) &&
+         !memcmp(frontier.link, msg->parent_block.link.bytes,
+                 sizeof(frontier.link)) &&
+         !memcmp(frontier.balance_be, msg->parent_block.balance.bytes,
+                 sizeof(frontier.balance_be)) &&
+         !strncmp(frontier.representative, msg->parent_block.representative,
+                  sizeof(frontier.representative));
+}
+
 bool nano_parentHash(const NanoSignTx *msg) {
   if (!msg->has_parent_block) return true;
 
+  if (nano_frontierMatches(msg)) {
+    // The parent is the block signed last, and already hashed
+    memcpy(parent_hash, frontier.block_hash, sizeof(parent_hash));
+    bn_from_bytes(frontier.balance_be, sizeof(frontier.balance_be),
+                  &parent_balance);
+    return true;
+  }
+
   if (msg->parent_block.has_parent_hash) {
     memcpy(parent_hash, msg->parent_block.parent_hash.bytes,
            sizeof(parent_hash));
@@ -221,8 +279,21 @@ bool nano_currentHash(const NanoSignTx *msg, const HDNode *recip) {
   if (msg->has_link_hash) {
     memcpy(link, msg->link_hash.bytes, sizeof(link));
   } else if (msg->link_recipient_n_count > 0) {
-    if (!recip) return false;
-    memcpy(link, &recip->public_key[1], sizeof(link));
+    if (recip) {
+      if (msg->link_recipient_n_count > sizeof(recipient.address_n) /
+                                             sizeof(recipient.address_n[0]))
+        return false;
+      recipient.valid = true;
+      memcpy(recipient.account_pk, account_pk, sizeof(account_pk));
+      memcpy(recipient.address_n, msg->link_recipient_n,
+             msg->link_recipient_n_count * sizeof(uint32_t));
+      recipient.address_n_count = msg->link_recipient_n_count;
+      memcpy(recipient.public_key, &recip->public_key[1],
+             sizeof(recipient.public_key));
+    } else if (!nano_recipientIsCached(msg)) {
+      return false;
+    }
+    memcpy(link, recipient.public_key, sizeof(link));
   } else if (msg->has_link_recipient) {
     memcpy(link, msg->link_recipient, sizeof(link));
     if (!nano_validate_address(
@@ -231,10 +302,17 @@ bool nano_currentHash(const NanoSignTx *msg, const HDNode *recip) {
       return false;
   }
 
-  if (!nano_validate_address(coin->nanoaddr_prefix,
-                             strlen(coin->nanoaddr_prefix), msg->representative,
-                             strlen(msg->representative), representative_pk))
+  if (frontier.valid && frontier.coin == coin &&
+      !strncmp(frontier.representative, msg->representative,
+               sizeof(frontier.representative))) {
+    memcpy(representative_pk, frontier.representative_pk,
+           sizeof(representative_pk));
+  } else if (!nano_validate_address(
+                 coin->nanoaddr_prefix, strlen(coin->nanoaddr_prefix),
+                 msg->representative, strlen(msg->representative),
+                 representative_pk)) {
     return false;
+  }
 
   memcpy(balance_be, msg->balance.bytes, sizeof(balance_be));
   bn_from_bytes(balance_be, sizeof(balance_be), &balance);
@@ -367,5 +445,31 @@ bool nano_signTx(const NanoSignTx *msg, HDNode *node, NanoSignedTx *resp) {
   resp->has_block_hash = true;
   resp->block_hash.size = sizeof(block_hash);
   memcpy(resp->block_hash.bytes, block_hash, sizeof(block_hash));
+
+  // This block is the account's new frontier
+  frontier.valid = true;
+  frontier.coin = coin;
+  memcpy(frontier.account_pk, account_pk, sizeof(account_pk));
+  memcpy(frontier.parent_hash, parent_hash, sizeof(parent_hash));
+  memcpy(frontier.link, link, sizeof(link));
+  strlcpy(frontier.representative, msg->representative,
+          sizeof(frontier.representative));
+  memcpy(frontier.representative_pk, representative_pk,
+         sizeof(representative_pk));
+  memcpy(frontier.balance_be, balance_be, sizeof(balance_be));
+  memcpy(frontier.block_hash, block_hash, sizeof(block_hash));
   return true;
 }
+
+bool nano_recipientIsCached(const NanoSignTx *msg) {
+  return recipient.valid &&
+         !memcmp(recipient.account_pk, account_pk, sizeof(account_pk)) &&
+         recipient.address_n_count == msg->link_recipient_n_count &&
+         !memcmp(recipient.address_n, msg->link_recipient_n,
+                 recipient.address_n_count * sizeof(uint32_t));
+}
+
+void nano_clearCache(void) {
+  memzero(&frontier, sizeof(frontier));
+  memzero(&recipient, sizeof(recipient));
+}
@@ -32,7 +32,8 @@
 #include <time.h>
 
 static CONFIDENTIAL HDNode node;
-static SHA256_CTX ctx;
+static TendermintJsonHasher json;
+static TendermintAddressCache addresses;
 static bool initialized;
 static uint32_t msgs_remaining;
 static OsmosisSignTx msg;
@@ -40,6 +41,10 @@ static bool testnet;
 
 const OsmosisSignTx *osmosis_getOsmosisSignTx(void) { return &msg; }
 
+const char *osmosis_signerAddress(void) {
+  return tendermint_cachedAddress(&addresses, testnet ? "tosmo" : "osmo");
+}
+
 bool osmosis_signTxInit(const HDNode *_node, const OsmosisSignTx *_msg) {
   initialized = true;
   msgs_remaining = _msg->msg_count;
@@ -51,216 +56,141 @@ bool osmosis_signTxInit(const HDNode *_node, const OsmosisSignTx *_msg) {
 
   memzero(&node, sizeof(node));
   memcpy(&node, _node, sizeof(node));
+  tendermint_addressCacheInit(&addresses, &node);
   memcpy(&msg, _msg, sizeof(msg));
 
-  bool success = true;
-  char buffer[64 + 1] = {0};
-
-  sha256_Init(&ctx);
+  tendermint_jsonInit(&json);
 
-  // Each segment guaranteed to be less than or equal to 64 bytes
-  // 19 + ^20 + 1 = ^40
-  if (!tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                           "{\"account_number\":\"%" PRIu64 "\"",
-                           msg.account_number))
-    return false;
+  tendermint_jsonWriteStr(&json, "{\"account_number\":\"");
+  tendermint_jsonWriteUint(&json, msg.account_number);
+  tendermint_jsonWriteStr(&json, "\"");
 
   // <escape chain_id>
   const char *const chainid_prefix = ",\"chain_id\":\"";
-  sha256_Update(&ctx, (uint8_t *)chainid_prefix, strlen(chainid_prefix));
+  tendermint_jsonWrite(&json, chainid_prefix, strlen(chainid_prefix));
 
-  tendermint_sha256UpdateEscaped(&ctx, msg.chain_id, strlen(msg.chain_id));
+  tendermint_jsonWriteEscaped(&json, msg.chain_id, strlen(msg.chain_id));
 
-  // 30 + ^10 + 19 = ^59
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "\",\"fee\":{\"amount\":[{\"amount\":\"%" PRIu32
-                          "\",\"denom\":\"uosmo\"}]",
-                          msg.fee_amount);
+  tendermint_jsonWriteStr(&json, "\",\"fee\":{\"amount\":[{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, msg.fee_amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"uosmo\"}]");
 
-  // 8 + ^10 + 2 = ^20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"gas\":\"%" PRIu32 "\"}", msg.gas);
+  tendermint_jsonWriteStr(&json, ",\"gas\":\"");
+  tendermint_jsonWriteUint(&json, msg.gas);
+  tendermint_jsonWriteStr(&json, "\"}");
 
   // <escape memo>
   const char *const memo_prefix = ",\"memo\":\"";
-  sha256_Update(&ctx, (uint8_t *)memo_prefix, strlen(memo_prefix));
+  tendermint_jsonWrite(&json, memo_prefix, strlen(memo_prefix));
 
   if (msg.has_memo) {
-    tendermint_sha256UpdateEscaped(&ctx, msg.memo, strlen(msg.memo));
+    tendermint_jsonWriteEscaped(&json, msg.memo, strlen(msg.memo));
   }
 
-  // 10
-  sha256_Update(&ctx, (uint8_t *)"\",\"msgs\":[", 10);
+  tendermint_jsonWrite(&json, "\",\"msgs\":[", 10);
 
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgSend(const char *amount, const char *to_address) {
-  char mainnetp[] = "osmo";
-  char testnetp[] = "tosmo";
-  char *pfix;
-  char buffer[64 + 1];
-
-  size_t decoded_len;
-  char hrp[45] = {0};
-  uint8_t decoded[38] = {0};
-  if (!bech32_decode(hrp, decoded, &decoded_len, to_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, to_address)) {
     return false;
   }
 
-  char from_address[46];
-
-  pfix = mainnetp;
-  if (testnet) {
-    pfix = testnetp;
-  }
-
-  if (!tendermint_getAddress(&node, pfix, from_address)) {
+  const char *from_address = osmosis_signerAddress();
+  if (!from_address) {
     return false;
   }
 
-  bool success = true;
-
   const char *const prelude = "{\"type\":\"cosmos-sdk/MsgSend\",\"value\":{";
-  sha256_Update(&ctx, (uint8_t *)prelude, strlen(prelude));
+  tendermint_jsonWrite(&json, prelude, strlen(prelude));
 
-  // 21 + ^20 + 19 = ^60
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"amount\":[{\"amount\":\"%s\",\"denom\":\"uosmo\"}]", amount);
+  tendermint_jsonWriteStr(&json, "\"amount\":[{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"uosmo\"}]");
 
-  // 17 + 45 + 1 = 63
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"from_address\":\"%s\"", from_address);
+  tendermint_jsonWriteStr(&json, ",\"from_address\":\"");
+  tendermint_jsonWriteStr(&json, from_address);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 15 + 45 + 3 = 63
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"to_address\":\"%s\"}}", to_address);
+  tendermint_jsonWriteStr(&json, ",\"to_address\":\"");
+  tendermint_jsonWriteStr(&json, to_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgDelegate(const char *amount,
                                      const char *delegator_address,
                                      const char *validator_address,
                                      const char *denom) {
-  char mainnetp[] = "osmo";
-  char testnetp[] = "tosmo";
-  char *pfix;
-
-  char buffer[128] = {0};
-  size_t decoded_len;
-  char hrp[45] = {0};
-  uint8_t decoded[38] = {0};
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54] = {0};
-
-  pfix = mainnetp;
-  if (testnet) {
-    pfix = testnetp;
-  }
-
-  if (!tendermint_getAddress(&node, pfix, from_address)) {
+  const char *from_address = osmosis_signerAddress();
+  if (!from_address) {
     return false;
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 23 = ^56
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "{\"type\":\"cosmos-sdk/MsgDelegate\",\"value\":{");
+  tendermint_jsonWriteStr(
+      &json, "{\"type\":\"cosmos-sdk/MsgDelegate\",\"value\":{");
 
-  // 20 + ^20 + 11 + ^9 + 2 = ^62
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"amount\":{\"amount\":\"%s\",\"denom\":\"%s\"}", amount, denom);
+  tendermint_jsonWriteStr(&json, "\"amount\":{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  // 22
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"delegator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\",\"",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
+  tendermint_jsonWriteStr(&json, "\",\"");
 
-  // 20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "validator_address\":\"");
+  tendermint_jsonWriteStr(&json, "validator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_address);
+  tendermint_jsonWriteStr(&json, validator_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgUndelegate(const char *amount,
                                        const char *delegator_address,
                                        const char *validator_address,
                                        const char *denom) {
-  char mainnetp[] = "osmo";
-  char testnetp[] = "tosmo";
-  char *pfix;
-
-  char buffer[128] = {0};
-  size_t decoded_len;
-  char hrp[45] = {0};
-  uint8_t decoded[38] = {0};
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54] = {0};
-
-  pfix = mainnetp;
-  if (testnet) {
-    pfix = testnetp;
-  }
-  if (!tendermint_getAddress(&node, pfix, from_address)) {
+  const char *from_address = osmosis_signerAddress();
+  if (!from_address) {
     return false;
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 25 = ^58
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "{\"type\":\"cosmos-sdk/MsgUndelegate\",\"value\":{");
+  tendermint_jsonWriteStr(
+      &json, "{\"type\":\"cosmos-sdk/MsgUndelegate\",\"value\":{");
 
-  // 20 + ^20 + 11 + ^9 + 2 = ^62
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"amount\":{\"amount\":\"%s\",\"denom\":\"%s\"}", amount, denom);
+  tendermint_jsonWriteStr(&json, "\"amount\":{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  // 22
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"delegator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\",\"",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
+  tendermint_jsonWriteStr(&json, "\",\"");
 
-  // 20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "validator_address\":\"");
+  tendermint_jsonWriteStr(&json, "validator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_address);
+  tendermint_jsonWriteStr(&json, validator_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgRedelegate(const char *amount,
@@ -268,67 +198,39 @@ bool osmosis_signTxUpdateMsgRedelegate(const char *amount,
                                        const char *validator_src_address,
                                        const char *validator_dst_address,
                                        const char *denom) {
-  char mainnetp[] = "osmo";
-  char testnetp[] = "tosmo";
-  char *pfix;
-
-  char buffer[128] = {0};
-  size_t decoded_len;
-  char hrp[45] = {0};
-  uint8_t decoded[38] = {0};
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54] = {0};
-  pfix = mainnetp;
-  if (testnet) {
-    pfix = testnetp;
-  }
-  if (!tendermint_getAddress(&node, pfix, from_address)) {
+  const char *from_address = osmosis_signerAddress();
+  if (!from_address) {
     return false;
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 28 = ^64
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "{\"type\":\"cosmos-sdk/MsgBeginRedelegate\",\"value\"");
+  tendermint_jsonWriteStr(
+      &json, "{\"type\":\"cosmos-sdk/MsgBeginRedelegate\",\"value\"");
 
-  // 22 + ^20 + 11 + ^9 + 2 = ^64
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      ":{\"amount\":{\"amount\":\"%s\",\"denom\":\"%s\"}", amount, denom);
+  tendermint_jsonWriteStr(&json, ":{\"amount\":{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  // 22
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"delegator_address\":\"");
 
-  // ^53 + 1 = ^54
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
 
-  // 27
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\",\"validator_dst_address\":\"");
+  tendermint_jsonWriteStr(&json, "\",\"validator_dst_address\":\"");
 
-  // ^53
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s",
-                                 validator_dst_address);
+  tendermint_jsonWriteStr(&json, validator_dst_address);
 
-  // 27
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\",\"validator_src_address\":\"");
+  tendermint_jsonWriteStr(&json, "\",\"validator_src_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_src_address);
+  tendermint_jsonWriteStr(&json, validator_src_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgLPAdd(const uint64_t pool_id, const char *sender,
@@ -337,45 +239,46 @@ bool osmosis_signTxUpdateMsgLPAdd(const uint64_t pool_id, const char *sender,
                                   const char *denom_in_max_a,
                                   const char *amount_in_max_b,
                                   const char *denom_in_max_b) {
-  char buffer[96 + 1] = {0};
-
-  bool success = true;
-
   const char *const prelude =
       "{\"type\":\"osmosis/gamm/join-pool\",\"value\":{";
-  sha256_Update(&ctx, (uint8_t *)prelude, strlen(prelude));
+  tendermint_jsonWrite(&json, prelude, strlen(prelude));
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"pool_id\":\"%" PRIu64 "\",", pool_id);
+  tendermint_jsonWriteStr(&json, "\"pool_id\":\"");
+  tendermint_jsonWriteUint(&json, pool_id);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"sender\":");
+  tendermint_jsonWriteStr(&json, "\"sender\":");
 
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"%s\",", sender);
+  tendermint_jsonWriteStr(&json, "\"");
+  tendermint_jsonWriteStr(&json, sender);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"share_out_amount\":");
+  tendermint_jsonWriteStr(&json, "\"share_out_amount\":");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"%s\",",
-                                 share_out_amount);
+  tendermint_jsonWriteStr(&json, "\"");
+  tendermint_jsonWriteStr(&json, share_out_amount);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"token_in_maxs\":[{");
+  tendermint_jsonWriteStr(&json, "\"token_in_maxs\":[{");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"amount\":\"%s\",", amount_in_max_a);
+  tendermint_jsonWriteStr(&json, "\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount_in_max_a);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"denom\":\"%s\"},", denom_in_max_a);
+  tendermint_jsonWriteStr(&json, "\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom_in_max_a);
+  tendermint_jsonWriteStr(&json, "\"},");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"amount\":\"%s\",", amount_in_max_b);
+  tendermint_jsonWriteStr(&json, "{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount_in_max_b);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"denom\":\"%s\"}]}}", denom_in_max_b);
+  tendermint_jsonWriteStr(&json, "\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom_in_max_b);
+  tendermint_jsonWriteStr(&json, "\"}]}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgLPRemove(const uint64_t pool_id, const char *sender,
@@ -384,98 +287,75 @@ bool osmosis_signTxUpdateMsgLPRemove(const uint64_t pool_id, const char *sender,
                                      const char *denom_out_min_a,
                                      const char *amount_out_min_b,
                                      const char *denom_out_min_b) {
-  char buffer[96 + 1] = {0};
-
-  bool success = true;
-
   const char *const prelude =
       "{\"type\":\"osmosis/gamm/exit-pool\",\"value\":{";
-  sha256_Update(&ctx, (uint8_t *)prelude, strlen(prelude));
+  tendermint_jsonWrite(&json, prelude, strlen(prelude));
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"pool_id\":\"%" PRIu64 "\",", pool_id);
+  tendermint_jsonWriteStr(&json, "\"pool_id\":\"");
+  tendermint_jsonWriteUint(&json, pool_id);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"sender\":");
+  tendermint_jsonWriteStr(&json, "\"sender\":");
 
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"%s\",", sender);
+  tendermint_jsonWriteStr(&json, "\"");
+  tendermint_jsonWriteStr(&json, sender);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"share_in_amount\":");
+  tendermint_jsonWriteStr(&json, "\"share_in_amount\":");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"%s\",",
-                                 share_out_amount);
+  tendermint_jsonWriteStr(&json, "\"");
+  tendermint_jsonWriteStr(&json, share_out_amount);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"token_out_mins\":[{");
+  tendermint_jsonWriteStr(&json, "\"token_out_mins\":[{");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"amount\":\"%s\",", amount_out_min_a);
+  tendermint_jsonWriteStr(&json, "\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount_out_min_a);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"denom\":\"%s\"},", denom_out_min_a);
+  tendermint_jsonWriteStr(&json, "\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom_out_min_a);
+  tendermint_jsonWriteStr(&json, "\"},");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"amount\":\"%s\",", amount_out_min_b);
+  tendermint_jsonWriteStr(&json, "{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount_out_min_b);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"denom\":\"%s\"}]}}", denom_out_min_b);
+  tendermint_jsonWriteStr(&json, "\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom_out_min_b);
+  tendermint_jsonWriteStr(&json, "\"}]}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgRewards(const char *delegator_address,
                                     const char *validator_address) {
-  char mainnetp[] = "osmo";
-  char testnetp[] = "tosmo";
-  char *pfix;
-
-  char buffer[128] = {0};
-  size_t decoded_len;
-  char hrp[45] = {0};
-  uint8_t decoded[38] = {0};
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
-  pfix = mainnetp;
-  if (testnet) {
-    pfix = testnetp;
-  }
-
-  // ^14 + 39 + 1 = ^54
-  char from_address[54] = {0};
-  if (!tendermint_getAddress(&node, pfix, from_address)) {
+  const char *from_address = osmosis_signerAddress();
+  if (!from_address) {
     return false;
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 38 = ^72
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
+  tendermint_jsonWriteStr(
+      &json,
       "{\"type\":\"cosmos-sdk/MsgWithdrawDelegationReward\",\"value\":{");
 
-  // 21
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, "\"delegator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\",\"",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
+  tendermint_jsonWriteStr(&json, "\",\"");
 
-  // 20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "validator_address\":\"");
+  tendermint_jsonWriteStr(&json, "validator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_address);
+  tendermint_jsonWriteStr(&json, validator_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgIBCTransfer(const char *amount, const char *sender,
@@ -485,77 +365,51 @@ bool osmosis_signTxUpdateMsgIBCTransfer(const char *amount, const char *sender,
                                         const char *revision_number,
                                         const char *revision_height,
                                         const char *denom) {
-  char mainnetp[] = "osmo";
-  char testnetp[] = "tosmo";
-  char *pfix;
-
-  char buffer[128] = {0};
-  size_t decoded_len;
-  char hrp[45] = {0};
-  uint8_t decoded[38] = {0};
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, receiver)) {
+  if (!tendermint_cachedValidateAddress(&addresses, receiver)) {
     return false;
   }
 
-  pfix = mainnetp;
-  if (testnet) {
-    pfix = testnetp;
-  }
-
-  // ^14 + 39 + 1 = ^54
-  char from_address[54] = {0};
-  if (!tendermint_getAddress(&node, pfix, from_address)) {
+  const char *from_address = osmosis_signerAddress();
+  if (!from_address) {
     return false;
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 23 = ^56
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "{\"type\":\"cosmos-sdk/MsgTransfer\",\"value\":{");
+  tendermint_jsonWriteStr(
+      &json, "{\"type\":\"cosmos-sdk/MsgTransfer\",\"value\":{");
 
-  // 13
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"receiver\":\"");
+  tendermint_jsonWriteStr(&json, "\"receiver\":\"");
 
-  // ^53 + 1 = ^54
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"", receiver);
+  tendermint_jsonWriteStr(&json, receiver);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 11
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), ",\"sender\":\"");
+  tendermint_jsonWriteStr(&json, ",\"sender\":\"");
 
-  // ^53 + 1 = ^54
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"", sender);
+  tendermint_jsonWriteStr(&json, sender);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 19 + ^32 + 1 = ^52
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"source_channel\":\"%s\"", source_channel);
+  tendermint_jsonWriteStr(&json, ",\"source_channel\":\"");
+  tendermint_jsonWriteStr(&json, source_channel);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 16 + ^32 + 2 = ^40
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"source_port\":\"%s\",", source_port);
+  tendermint_jsonWriteStr(&json, ",\"source_port\":\"");
+  tendermint_jsonWriteStr(&json, source_port);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  // 37 + ^16 = ^53
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"timeout_height\":{\"revision_height\":\"%s",
-                                 revision_height);
+  tendermint_jsonWriteStr(&json, "\"timeout_height\":{\"revision_height\":\"");
+  tendermint_jsonWriteStr(&json, revision_height);
 
-  // 21 + ^9 + 3 = ^33
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "\",\"revision_number\":\"%s\"},", revision_number);
+  tendermint_jsonWriteStr(&json, "\",\"revision_number\":\"");
+  tendermint_jsonWriteStr(&json, revision_number);
+  tendermint_jsonWriteStr(&json, "\"},");
 
-  // 20 + ^20 + 11 + ^9 + 3 = ^63
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"token\":{\"amount\":\"%s\",\"denom\":\"%s\"}}}", amount, denom);
+  tendermint_jsonWriteStr(&json, "\"token\":{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxUpdateMsgSwap(const uint64_t pool_id,
@@ -564,56 +418,50 @@ bool osmosis_signTxUpdateMsgSwap(const uint64_t pool_id,
                                  const char *token_in_amount,
                                  const char *token_in_denom,
                                  const char *token_out_min_amount) {
-  char buffer[96 + 1] = {0};
-
   // TODO: add testnet support
 
-  bool success = true;
-
   const char *const prelude =
       "{\"type\":\"osmosis/gamm/swap-exact-amount-in\",";
-  sha256_Update(&ctx, (uint8_t *)prelude, strlen(prelude));
+  tendermint_jsonWrite(&json, prelude, strlen(prelude));
 
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\"value\":{\"routes\":[{\"pool_id\":\"%" PRIu64 "\",", pool_id);
+  tendermint_jsonWriteStr(&json, "\"value\":{\"routes\":[{\"pool_id\":\"");
+  tendermint_jsonWriteUint(&json, pool_id);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "\"token_out_denom\":\"%s\"}],", token_out_denom);
+  tendermint_jsonWriteStr(&json, "\"token_out_denom\":\"");
+  tendermint_jsonWriteStr(&json, token_out_denom);
+  tendermint_jsonWriteStr(&json, "\"}],");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"sender\":\"%s\",", sender);
+  tendermint_jsonWriteStr(&json, "\"sender\":\"");
+  tendermint_jsonWriteStr(&json, sender);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "\"token_in\":{\"amount\":\"%s\",", token_in_amount);
+  tendermint_jsonWriteStr(&json, "\"token_in\":{\"amount\":\"");
+  tendermint_jsonWriteStr(&json, token_in_amount);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"denom\":\"%s\"},", token_in_denom);
+  tendermint_jsonWriteStr(&json, "\"denom\":\"");
+  tendermint_jsonWriteStr(&json, token_in_denom);
+  tendermint_jsonWriteStr(&json, "\"},");
 
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"token_out_min_amount\":\"%s\"}}",
-                                 token_out_min_amount);
+  tendermint_jsonWriteStr(&json, "\"token_out_min_amount\":\"");
+  tendermint_jsonWriteStr(&json, token_out_min_amount);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool osmosis_signTxFinalize(uint8_t *public_key, uint8_t *signature) {
-  char buffer[128] = {0};
-
-  // 14 + ^20 + 2 = ^36
-  if (!tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                           "],\"sequence\":\"%" PRIu64 "\"}", msg.sequence)) {
-    return false;
-  }
+  tendermint_jsonWriteStr(&json, "],\"sequence\":\"");
+  tendermint_jsonWriteUint(&json, msg.sequence);
+  tendermint_jsonWriteStr(&json, "\"}");
 
   hdnode_fill_public_key(&node);
   memcpy(public_key, node.public_key, 33);
 
   uint8_t hash[SHA256_DIGEST_LENGTH];
-  sha256_Final(&ctx, hash);
+  tendermint_jsonFinal(&json, hash);
   return ecdsa_sign_digest(&secp256k1, node.private_key, hash, signature, NULL,
                            NULL) == 0;
 }
@@ -627,4 +475,5 @@ void osmosis_signAbort(void) {
   msgs_remaining = 0;
   memzero(&msg, sizeof(msg));
   memzero(&node, sizeof(node));
+  memzero(&addresses, sizeof(addresses));
 }
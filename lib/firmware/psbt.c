@@ -0,0 +1,413 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2024 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/psbt.h"
+
+#include "keepkey/board/util.h"
+
+#include <string.h>
+
+enum {
+  PsbtState_Magic,
+  PsbtState_KeyLen,
+  PsbtState_Key,
+  PsbtState_ValueLen,
+  PsbtState_Value,
+  PsbtState_Done,
+  PsbtState_Error,
+};
+
+enum {
+  TxState_Version,
+  TxState_InCount,
+  TxState_InHash,
+  TxState_InIndex,
+  TxState_InScriptLen,
+  TxState_InSequence,
+  TxState_OutCount,
+  TxState_OutAmount,
+  TxState_OutScriptLen,
+  TxState_OutScript,
+  TxState_LockTime,
+  TxState_Done,
+};
+
+static const uint8_t psbt_magic[] = {'p', 's', 'b', 't', 0xff};
+
+static bool psbt_fail(PsbtParser *parser, const char *error) {
+  parser->state = PsbtState_Error;
+  parser->error = error;
+  return false;
+}
+
+/// Feeds one byte of a compact size uint.
+/// \returns true once the value is complete
+static bool varint_feed(PsbtVarInt *varint, uint8_t byte) {
+  if (varint->size == 0) {
+    if (byte < 0xfd) {
+      varint->value = byte;
+      return true;
+    }
+    varint->size = byte == 0xfd ? 2 : byte == 0xfe ? 4 : 8;
+    varint->shift = 0;
+    varint->value = 0;
+    return false;
+  }
+  varint->value |= (uint64_t)byte << varint->shift;
+  varint->shift += 8;
+  return --varint->size == 0;
+}
+
+/// Accumulates a little endian integer of \p size bytes into tx_amount.
+/// \returns true once the value is complete
+static bool tx_int(PsbtParser *parser, uint8_t byte, uint32_t size) {
+  if (parser->tx_pos == 0) {
+    parser->tx_amount = 0;
+  }
+  parser->tx_amount |= (uint64_t)byte << (8 * parser->tx_pos);
+  if (++parser->tx_pos < size) {
+    return false;
+  }
+  parser->tx_pos = 0;
+  return true;
+}
+
+static bool tx_emitOutput(PsbtParser *parser) {
+  if (parser->callbacks->tx_output &&
+      !parser->callbacks->tx_output(parser->ctx, parser->tx_index,
+                                    parser->tx_amount, parser->tx_script,
+                                    parser->tx_len)) {
+    return psbt_fail(parser, "Output rejected");
+  }
+  parser->tx_index++;
+  parser->tx_state = parser->tx_index == parser->outputs_count
+                         ? TxState_LockTime
+                         : TxState_OutAmount;
+  return true;
+}
+
+/// Feeds one byte of the global unsigned transaction, which must be in the
+/// non-witness serialization with empty scriptSigs.
+static bool tx_feed(PsbtParser *parser, uint8_t byte) {
+  switch (parser->tx_state) {
+    case TxState_Version:
+      if (tx_int(parser, byte, 4)) {
+        parser->version = (uint32_t)parser->tx_amount;
+        parser->tx_state = TxState_InCount;
+      }
+      return true;
+
+    case TxState_InCount:
+      if (!varint_feed(&parser->varint, byte)) return true;
+      if (parser->varint.value == 0 || parser->varint.value > UINT32_MAX) {
+        return psbt_fail(parser, "Invalid input count");
+      }
+      parser->inputs_count = (uint32_t)parser->varint.value;
+      parser->tx_index = 0;
+      parser->tx_state = TxState_InHash;
+      return true;
+
+    case TxState_InHash:
+      parser->tx_buf[parser->tx_pos++] = byte;
+      if (parser->tx_pos == sizeof(parser->tx_buf)) {
+        parser->tx_pos = 0;
+        parser->tx_state = TxState_InIndex;
+      }
+      return true;
+
+    case TxState_InIndex:
+      if (tx_int(parser, byte, 4)) {
+        parser->tx_prev_index = (uint32_t)parser->tx_amount;
+        parser->tx_state = TxState_InScriptLen;
+      }
+      return true;
+
+    case TxState_InScriptLen:
+      if (!varint_feed(&parser->varint, byte)) return true;
+      if (parser->varint.value != 0) {
+        return psbt_fail(parser, "Unsigned transaction has a scriptSig");
+      }
+      parser->tx_state = TxState_InSequence;
+      return true;
+
+    case TxState_InSequence:
+      if (!tx_int(parser, byte, 4)) return true;
+      if (parser->callbacks->tx_input &&
+          !parser->callbacks->tx_input(parser->ctx, parser->tx_index,
+                                       parser->tx_buf, parser->tx_prev_index,
+                                       (uint32_t)parser->tx_amount)) {
+        return psbt_fail(parser, "Input rejected");
+      }
+      parser->tx_index++;
+      parser->tx_state = parser->tx_index == parser->inputs_count
+                             ? TxState_OutCount
+                             : TxState_InHash;
+      return true;
+
+    case TxState_OutCount:
+      if (!varint_feed(&parser->varint, byte)) return true;
+      if (parser->varint.value == 0 || parser->varint.value > UINT32_MAX) {
+        return psbt_fail(parser, "Invalid output count");
+      }
+      parser->outputs_count = (uint32_t)parser->varint.value;
+      parser->tx_index = 0;
+      parser->tx_state = TxState_OutAmount;
+      return true;
+
+    case TxState_OutAmount:
+      if (tx_int(parser, byte, 8)) {
+        parser->tx_state = TxState_OutScriptLen;
+      }
+      return true;
+
+    case TxState_OutScriptLen:
+      if (!varint_feed(&parser->varint, byte)) return true;
+      if (parser->varint.value > PSBT_SCRIPT_MAX) {
+        return psbt_fail(parser, "Output script too long");
+      }
+      parser->tx_len = (uint32_t)parser->varint.value;
+      parser->tx_pos = 0;
+      if (parser->tx_len == 0) {
+        return tx_emitOutput(parser);
+      }
+      parser->tx_state = TxState_OutScript;
+      return true;
+
+    case TxState_OutScript:
+      parser->tx_script[parser->tx_pos++] = byte;
+      if (parser->tx_pos < parser->tx_len) return true;
+      parser->tx_pos = 0;
+      return tx_emitOutput(parser);
+
+    case TxState_LockTime:
+      if (tx_int(parser, byte, 4)) {
+        parser->lock_time = (uint32_t)parser->tx_amount;
+        parser->tx_state = TxState_Done;
+      }
+      return true;
+
+    case TxState_Done:
+    default:
+      return psbt_fail(parser, "Unsigned transaction too long");
+  }
+}
+
+static bool psbt_isUnsignedTx(const PsbtRecord *record) {
+  return record->map == PsbtMap_Global &&
+         record->key[0] == PSBT_GLOBAL_UNSIGNED_TX;
+}
+
+static bool psbt_beginValue(PsbtParser *parser) {
+  if (!psbt_isUnsignedTx(&parser->record)) {
+    return true;
+  }
+  if (parser->record.key_len != 1) {
+    return psbt_fail(parser, "Invalid unsigned transaction key");
+  }
+  if (parser->has_tx) {
+    return psbt_fail(parser, "Duplicate unsigned transaction");
+  }
+  parser->has_tx = true;
+  parser->tx_state = TxState_Version;
+  parser->tx_pos = 0;
+  parser->varint.size = 0;
+  return true;
+}
+
+static bool psbt_value(PsbtParser *parser, const uint8_t *data, size_t len) {
+  if (psbt_isUnsignedTx(&parser->record)) {
+    for (size_t i = 0; i < len; i++) {
+      if (!tx_feed(parser, data[i])) {
+        return false;
+      }
+    }
+  }
+  if (parser->callbacks->value &&
+      !parser->callbacks->value(parser->ctx, &parser->record,
+                                parser->value_pos, data, len)) {
+    return psbt_fail(parser, "Value rejected");
+  }
+  return true;
+}
+
+static bool psbt_endValue(PsbtParser *parser) {
+  if (psbt_isUnsignedTx(&parser->record) &&
+      parser->tx_state != TxState_Done) {
+    return psbt_fail(parser, "Unsigned transaction truncated");
+  }
+  parser->state = PsbtState_KeyLen;
+  return true;
+}
+
+static bool psbt_endMap(PsbtParser *parser) {
+  PsbtRecord *record = &parser->record;
+  switch (record->map) {
+    case PsbtMap_Global:
+      if (!parser->has_tx) {
+        return psbt_fail(parser, "Missing unsigned transaction");
+      }
+      record->map = PsbtMap_Input;
+      record->index = 0;
+      return true;
+    case PsbtMap_Input:
+      if (++record->index == parser->inputs_count) {
+        record->map = PsbtMap_Output;
+        record->index = 0;
+      }
+      return true;
+    case PsbtMap_Output:
+      if (++record->index == parser->outputs_count) {
+        parser->state = PsbtState_Done;
+      }
+      return true;
+  }
+  return psbt_fail(parser, "Invalid map");
+}
+
+void psbt_init(PsbtParser *parser, const PsbtCallbacks *callbacks, void *ctx) {
+  memset(parser, 0, sizeof(*parser));
+  parser->state = PsbtState_Magic;
+  parser->callbacks = callbacks;
+  parser->ctx = ctx;
+  parser->record.map = PsbtMap_Global;
+}
+
+bool psbt_update(PsbtParser *parser, const uint8_t *data, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    PsbtRecord *record = &parser->record;
+    switch (parser->state) {
+      case PsbtState_Magic:
+        if (data[i++] != psbt_magic[parser->magic_pos++]) {
+          return psbt_fail(parser, "Invalid PSBT magic");
+        }
+        if (parser->magic_pos == sizeof(psbt_magic)) {
+          parser->state = PsbtState_KeyLen;
+        }
+        break;
+
+      case PsbtState_KeyLen:
+        if (!varint_feed(&parser->varint, data[i++])) break;
+        if (parser->varint.value == 0) {
+          if (!psbt_endMap(parser)) return false;
+          break;
+        }
+        if (parser->varint.value > UINT32_MAX) {
+          return psbt_fail(parser, "Key too long");
+        }
+        memset(record->key, 0, sizeof(record->key));
+        record->key_len = (uint32_t)parser->varint.value;
+        parser->key_pos = 0;
+        parser->state = PsbtState_Key;
+        break;
+
+      case PsbtState_Key:
+        if (parser->key_pos < PSBT_KEY_MAX) {
+          record->key[parser->key_pos] = data[i];
+        }
+        i++;
+        if (++parser->key_pos == record->key_len) {
+          parser->state = PsbtState_ValueLen;
+        }
+        break;
+
+      case PsbtState_ValueLen:
+        if (!varint_feed(&parser->varint, data[i++])) break;
+        if (parser->varint.value > UINT32_MAX) {
+          return psbt_fail(parser, "Value too long");
+        }
+        record->value_len = (uint32_t)parser->varint.value;
+        parser->value_pos = 0;
+        if (!psbt_beginValue(parser)) return false;
+        if (record->value_len == 0) {
+          if (!psbt_value(parser, data + i, 0) || !psbt_endValue(parser)) {
+            return false;
+          }
+        } else {
+          parser->state = PsbtState_Value;
+        }
+        break;
+
+      case PsbtState_Value: {
+        size_t n = MIN(len - i, (size_t)(record->value_len - parser->value_pos));
+        if (!psbt_value(parser, data + i, n)) return false;
+        i += n;
+        parser->value_pos += n;
+        if (parser->value_pos == record->value_len &&
+            !psbt_endValue(parser)) {
+          return false;
+        }
+        break;
+      }
+
+      case PsbtState_Done:
+        return psbt_fail(parser, "Data after the last output");
+
+      case PsbtState_Error:
+      default:
+        return false;
+    }
+  }
+  return parser->state != PsbtState_Error;
+}
+
+bool psbt_isComplete(const PsbtParser *parser) {
+  return parser->state == PsbtState_Done;
+}
+
+bool psbt_decodeBip32Path(const uint8_t *value, size_t len,
+                          uint32_t *fingerprint, uint32_t *address_n,
+                          size_t max_count, size_t *address_n_count) {
+  if (len < 4 || len % 4 != 0 || len / 4 - 1 > max_count) {
+    return false;
+  }
+  *fingerprint = ((uint32_t)value[0] << 24) | ((uint32_t)value[1] << 16) |
+                 ((uint32_t)value[2] << 8) | value[3];
+  *address_n_count = len / 4 - 1;
+  for (size_t i = 0; i < *address_n_count; i++) {
+    const uint8_t *p = value + 4 + 4 * i;
+    address_n[i] = p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+                   ((uint32_t)p[3] << 24);
+  }
+  return true;
+}
+
+bool psbt_decodeWitnessUtxo(const uint8_t *value, size_t len,
+                            uint64_t *amount, const uint8_t **script,
+                            size_t *script_len) {
+  if (len < 9) {
+    return false;
+  }
+  *amount = 0;
+  for (int i = 7; i >= 0; i--) {
+    *amount = (*amount << 8) | value[i];
+  }
+
+  PsbtVarInt varint = {0};
+  size_t pos = 8;
+  while (!varint_feed(&varint, value[pos++])) {
+    if (pos == len) return false;
+  }
+  if (varint.value != len - pos) {
+    return false;
+  }
+  *script = value + pos;
+  *script_len = len - pos;
+  return true;
+}
@@ -21,6 +21,7 @@
 
 #include "keepkey/firmware/ripple_base58.h"
 #include "trezor/crypto/base58.h"
+#include "trezor/crypto/memzero.h"
 #include "trezor/crypto/secp256k1.h"
 
 #include <assert.h>
@@ -62,55 +63,72 @@ void ripple_formatAmount(char *buf, size_t len, uint64_t amount) {
   bn_format(&val, NULL, " XRP", RIPPLE_DECIMALS, 0, false, buf, len);
 }
 
-static void append_u8(bool *ok, uint8_t **buf, const uint8_t *end,
-                      uint8_t val) {
-  if (!*ok) {
+void ripple_sinkInitBuffer(RippleSink *sink, uint8_t *buf, size_t len) {
+  sink->ok = true;
+  sink->buf = buf;
+  sink->end = buf + len;
+  sink->ctx = NULL;
+}
+
+void ripple_sinkInitHash(RippleSink *sink, SHA512_CTX *ctx) {
+  sink->ok = true;
+  sink->buf = NULL;
+  sink->end = NULL;
+  sink->ctx = ctx;
+}
+
+void ripple_sinkWrite(RippleSink *sink, const uint8_t *bytes, size_t len) {
+  if (!sink->ok) {
     return;
   }
 
-  if (*buf + 1 > end) {
-    *ok = false;
+  if (sink->ctx) {
+    sha512_Update(sink->ctx, bytes, len);
     return;
   }
 
-  **buf = val;
-  *buf += 1;
+  if ((size_t)(sink->end - sink->buf) < len) {
+    sink->ok = false;
+    return;
+  }
+
+  memcpy(sink->buf, bytes, len);
+  sink->buf += len;
 }
 
-void ripple_serializeType(bool *ok, uint8_t **buf, const uint8_t *end,
-                          const RippleFieldMapping *m) {
+void ripple_serializeType(RippleSink *sink, const RippleFieldMapping *m) {
   if (m->key <= 0xf) {
-    append_u8(ok, buf, end, m->type << 4 | m->key);
+    uint8_t header = m->type << 4 | m->key;
+    ripple_sinkWrite(sink, &header, 1);
     return;
   }
 
-  append_u8(ok, buf, end, m->type << 4);
-  append_u8(ok, buf, end, m->key);
+  uint8_t header[2] = {m->type << 4, m->key};
+  ripple_sinkWrite(sink, header, sizeof(header));
 }
 
-void ripple_serializeInt16(bool *ok, uint8_t **buf, const uint8_t *end,
-                           const RippleFieldMapping *m, int16_t val) {
+void ripple_serializeInt16(RippleSink *sink, const RippleFieldMapping *m,
+                           int16_t val) {
   assert(m->type == RFT_INT16 && "wrong type?");
 
-  ripple_serializeType(ok, buf, end, m);
-  append_u8(ok, buf, end, (val >> 8) & 0xff);
-  append_u8(ok, buf, end, val & 0xff);
+  ripple_serializeType(sink, m);
+  uint8_t bytes[2] = {(val >> 8) & 0xff, val & 0xff};
+  ripple_sinkWrite(sink, bytes, sizeof(bytes));
 }
 
-void ripple_serializeInt32(bool *ok, uint8_t **buf, const uint8_t *end,
-                           const RippleFieldMapping *m, int32_t val) {
+void ripple_serializeInt32(RippleSink *sink, const RippleFieldMapping *m,
+                           int32_t val) {
   assert(m->type == RFT_INT32 && "wrong type?");
 
-  ripple_serializeType(ok, buf, end, m);
-  append_u8(ok, buf, end, (val >> 24) & 0xff);
-  append_u8(ok, buf, end, (val >> 16) & 0xff);
-  append_u8(ok, buf, end, (val >> 8) & 0xff);
-  append_u8(ok, buf, end, val & 0xff);
+  ripple_serializeType(sink, m);
+  uint8_t bytes[4] = {(val >> 24) & 0xff, (val >> 16) & 0xff,
+                      (val >> 8) & 0xff, val & 0xff};
+  ripple_sinkWrite(sink, bytes, sizeof(bytes));
 }
 
-void ripple_serializeAmount(bool *ok, uint8_t **buf, const uint8_t *end,
-                            const RippleFieldMapping *m, int64_t amount) {
-  ripple_serializeType(ok, buf, end, m);
+void ripple_serializeAmount(RippleSink *sink, const RippleFieldMapping *m,
+                            int64_t amount) {
+  ripple_serializeType(sink, m);
 
   assert(amount >= 0 && "amounts cannot be negative");
   assert(amount <= 100000000000 && "larger amounts not supported");
@@ -118,112 +136,99 @@ void ripple_serializeAmount(bool *ok, uint8_t **buf, const uint8_t *end,
   msb &= 0x7f;  // Clear first bit, indicating XRP
   msb |= 0x40;  // Clear second bit, indicating value is positive
 
-  append_u8(ok, buf, end, msb);
-  append_u8(ok, buf, end, (amount >> (6 * 8)) & 0xff);
-  append_u8(ok, buf, end, (amount >> (5 * 8)) & 0xff);
-  append_u8(ok, buf, end, (amount >> (4 * 8)) & 0xff);
-  append_u8(ok, buf, end, (amount >> (3 * 8)) & 0xff);
-  append_u8(ok, buf, end, (amount >> (2 * 8)) & 0xff);
-  append_u8(ok, buf, end, (amount >> (1 * 8)) & 0xff);
-  append_u8(ok, buf, end, amount & 0xff);
+  uint8_t bytes[8] = {msb,
+                      (amount >> (6 * 8)) & 0xff,
+                      (amount >> (5 * 8)) & 0xff,
+                      (amount >> (4 * 8)) & 0xff,
+                      (amount >> (3 * 8)) & 0xff,
+                      (amount >> (2 * 8)) & 0xff,
+                      (amount >> (1 * 8)) & 0xff,
+                      amount & 0xff};
+  ripple_sinkWrite(sink, bytes, sizeof(bytes));
 }
 
-void ripple_serializeVarint(bool *ok, uint8_t **buf, const uint8_t *end,
-                            int val) {
+void ripple_serializeVarint(RippleSink *sink, int val) {
   if (val < 0) {
     assert(false && "can't serialize 0-valued varint");
-    *ok = false;
+    sink->ok = false;
     return;
   }
 
   if (val < 192) {
-    append_u8(ok, buf, end, val);
+    uint8_t byte = val;
+    ripple_sinkWrite(sink, &byte, 1);
     return;
   }
 
   if (val <= 12480) {
     val -= 193;
-    append_u8(ok, buf, end, 193 + (val >> 8));
-    append_u8(ok, buf, end, val & 0xff);
+    uint8_t bytes[2] = {193 + (val >> 8), val & 0xff};
+    ripple_sinkWrite(sink, bytes, sizeof(bytes));
     return;
   }
 
   if (val < 918744) {
-    assert(*buf + 3 < end && "buffer not long enough");
     val -= 12481;
-    append_u8(ok, buf, end, 241 + (val >> 16));
-    append_u8(ok, buf, end, (val >> 8) & 0xff);
-    append_u8(ok, buf, end, val & 0xff);
+    uint8_t bytes[3] = {241 + (val >> 16), (val >> 8) & 0xff, val & 0xff};
+    ripple_sinkWrite(sink, bytes, sizeof(bytes));
     return;
   }
 
   assert(false && "value too large");
-  *ok = false;
+  sink->ok = false;
 }
 
-void ripple_serializeBytes(bool *ok, uint8_t **buf, const uint8_t *end,
-                           const uint8_t *bytes, size_t count) {
-  ripple_serializeVarint(ok, buf, end, count);
-
-  if (!*ok || *buf + count > end) {
-    *ok = false;
-    assert(false && "buffer not long enough");
-    return;
-  }
-
-  memcpy(*buf, bytes, count);
-  *buf += count;
+void ripple_serializeBytes(RippleSink *sink, const uint8_t *bytes,
+                           size_t count) {
+  ripple_serializeVarint(sink, count);
+  ripple_sinkWrite(sink, bytes, count);
 }
 
-void ripple_serializeAddress(bool *ok, uint8_t **buf, const uint8_t *end,
-                             const RippleFieldMapping *m, const char *address) {
-  ripple_serializeType(ok, buf, end, m);
+void ripple_serializeAddress(RippleSink *sink, const RippleFieldMapping *m,
+                             const char *address) {
+  ripple_serializeType(sink, m);
 
   uint8_t addr_raw[MAX_ADDR_RAW_SIZE];
   uint32_t addr_raw_len =
       ripple_decode_check(address, HASHER_SHA2D, addr_raw, MAX_ADDR_RAW_SIZE);
   if (addr_raw_len != 21) {
     assert(false && "address has wrong length?");
-    *ok = false;
+    sink->ok = false;
     return;
   }
 
-  ripple_serializeBytes(ok, buf, end, addr_raw + 1, addr_raw_len - 1);
+  ripple_serializeBytes(sink, addr_raw + 1, addr_raw_len - 1);
 }
 
-void ripple_serializeVL(bool *ok, uint8_t **buf, const uint8_t *end,
-                        const RippleFieldMapping *m, const uint8_t *bytes,
-                        size_t count) {
-  ripple_serializeType(ok, buf, end, m);
-  ripple_serializeBytes(ok, buf, end, bytes, count);
+void ripple_serializeVL(RippleSink *sink, const RippleFieldMapping *m,
+                        const uint8_t *bytes, size_t count) {
+  ripple_serializeType(sink, m);
+  ripple_serializeBytes(sink, bytes, count);
 }
 
-bool ripple_serialize(uint8_t **buf, const uint8_t *end, const RippleSignTx *tx,
+bool ripple_serialize(RippleSink *sink, const RippleSignTx *tx,
                       const char *source_address, const uint8_t *pubkey,
                       const uint8_t *sig, size_t sig_len) {
-  bool ok = true;
-  ripple_serializeInt16(&ok, buf, end, &RFM_type, /*Payment*/ 0);
-  if (tx->has_flags)
-    ripple_serializeInt32(&ok, buf, end, &RFM_flags, tx->flags);
+  ripple_serializeInt16(sink, &RFM_type, /*Payment*/ 0);
+  if (tx->has_flags) ripple_serializeInt32(sink, &RFM_flags, tx->flags);
   if (tx->has_sequence)
-    ripple_serializeInt32(&ok, buf, end, &RFM_sequence, tx->sequence);
+    ripple_serializeInt32(sink, &RFM_sequence, tx->sequence);
   if (tx->payment.has_destination_tag)
-    ripple_serializeInt32(&ok, buf, end, &RFM_destinationTag,
+    ripple_serializeInt32(sink, &RFM_destinationTag,
                           tx->payment.destination_tag);
   if (tx->has_last_ledger_sequence)
-    ripple_serializeInt32(&ok, buf, end, &RFM_lastLedgerSequence,
+    ripple_serializeInt32(sink, &RFM_lastLedgerSequence,
                           tx->last_ledger_sequence);
   if (tx->payment.has_amount)
-    ripple_serializeAmount(&ok, buf, end, &RFM_amount, tx->payment.amount);
-  if (tx->has_fee) ripple_serializeAmount(&ok, buf, end, &RFM_fee, tx->fee);
-  if (pubkey) ripple_serializeVL(&ok, buf, end, &RFM_signingPubKey, pubkey, 33);
-  if (sig) ripple_serializeVL(&ok, buf, end, &RFM_txnSignature, sig, sig_len);
+    ripple_serializeAmount(sink, &RFM_amount, tx->payment.amount);
+  if (tx->has_fee) ripple_serializeAmount(sink, &RFM_fee, tx->fee);
+  if (pubkey) ripple_serializeVL(sink, &RFM_signingPubKey, pubkey, 33);
+  if (sig) ripple_serializeVL(sink, &RFM_txnSignature, sig, sig_len);
   if (source_address)
-    ripple_serializeAddress(&ok, buf, end, &RFM_account, source_address);
+    ripple_serializeAddress(sink, &RFM_account, source_address);
   if (tx->payment.has_destination)
-    ripple_serializeAddress(&ok, buf, end, &RFM_destination,
-                            tx->payment.destination);
-  return ok;
+    ripple_serializeAddress(sink, &RFM_destination, tx->payment.destination);
+  return sink->ok;
 }
 
 void ripple_signTx(const HDNode *node, RippleSignTx *tx, RippleSignedTx *resp) {
@@ -241,23 +246,26 @@ void ripple_signTx(const HDNode *node, RippleSignTx *tx, RippleSignedTx *resp) {
   }
   tx->flags |= RIPPLE_FLAG_FULLY_CANONICAL;
 
-  memset(resp->serialized_tx.bytes, 0, sizeof(resp->serialized_tx.bytes));
-
-  // 'STX'
-  memcpy(resp->serialized_tx.bytes, "\x53\x54\x58\x00", 4);
-
   char source_address[MAX_ADDR_SIZE];
   if (!ripple_getAddress(node->public_key, source_address)) return;
 
-  uint8_t *buf = resp->serialized_tx.bytes + 4;
-  size_t len = sizeof(resp->serialized_tx.bytes) - 4;
-  if (!ripple_serialize(&buf, buf + len, tx, source_address, node->public_key,
-                        NULL, 0))
+  // The signing preimage is hashed as it is serialized; it never exists as
+  // a whole in memory.
+  SHA512_CTX ctx;
+  sha512_Init(&ctx);
+  sha512_Update(&ctx, (const uint8_t *)"\x53\x54\x58\x00", 4);  // 'STX'
+
+  RippleSink sink;
+  ripple_sinkInitHash(&sink, &ctx);
+  if (!ripple_serialize(&sink, tx, source_address, node->public_key, NULL,
+                        0)) {
+    memzero(&ctx, sizeof(ctx));
     return;
+  }
 
   // Ripple uses the first half of SHA512
   uint8_t hash[64];
-  sha512_Raw(resp->serialized_tx.bytes, buf - resp->serialized_tx.bytes, hash);
+  sha512_Final(&ctx, hash);
 
   uint8_t sig[64];
   if (ecdsa_sign_digest(&secp256k1, node->private_key, hash, sig, NULL, NULL) !=
@@ -271,12 +279,12 @@ void ripple_signTx(const HDNode *node, RippleSignTx *tx, RippleSignedTx *resp) {
 
   memset(resp->serialized_tx.bytes, 0, sizeof(resp->serialized_tx.bytes));
 
-  buf = resp->serialized_tx.bytes;
-  len = sizeof(resp->serialized_tx);
-  if (!ripple_serialize(&buf, buf + len, tx, source_address, node->public_key,
+  ripple_sinkInitBuffer(&sink, resp->serialized_tx.bytes,
+                        sizeof(resp->serialized_tx.bytes));
+  if (!ripple_serialize(&sink, tx, source_address, node->public_key,
                         resp->signature.bytes, resp->signature.size))
     return;
 
   resp->has_serialized_tx = true;
-  resp->serialized_tx.size = buf - resp->serialized_tx.bytes;
+  resp->serialized_tx.size = sink.buf - resp->serialized_tx.bytes;
 }
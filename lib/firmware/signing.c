@@ -29,12 +29,18 @@
 #include "keepkey/firmware/crypto.h"
 #include "keepkey/firmware/fsm.h"
 #include "keepkey/firmware/home_sm.h"
+#include "keepkey/firmware/merkle.h"
 #include "keepkey/firmware/policy.h"
 #include "keepkey/firmware/signing.h"
+#include "keepkey/firmware/storage.h"
+#include "keepkey/firmware/taproot.h"
 #include "keepkey/firmware/txin_check.h"
 #include "keepkey/firmware/transaction.h"
+#include "keepkey/firmware/zip244.h"
 #include "trezor/crypto/ecdsa.h"
 #include "trezor/crypto/memzero.h"
+#include "trezor/crypto/rand.h"
+#include "trezor/crypto/ripemd160.h"
 #include "trezor/crypto/secp256k1.h"
 
 #include "types.pb.h"
@@ -86,6 +92,19 @@ static uint8_t pubkey[33], sig[64];
 static uint8_t hash_prevouts[32], hash_sequence[32], hash_outputs[32];
 static uint8_t hash_prefix[32];
 static uint8_t hash_check[32];
+/* BIP341 midstates. When taproot_hashes is set, hasher_prevouts,
+   hasher_sequence and hasher_outputs are single SHA-256 and the BIP143
+   hashes are their double SHA-256. */
+static bool taproot_hashes;
+static uint32_t taproot_inputs;
+static uint8_t tr_prevouts[32], tr_sequences[32], tr_outputs[32];
+/* Amounts and scriptPubKeys of all inputs, for BIP341 and ZIP-244 */
+static Hasher hasher_amounts, hasher_scriptpubkeys;
+static uint8_t hash_amounts[32], hash_scriptpubkeys[32];
+/* ZIP-244 (Zcash v5) digests shared by all inputs: the transparent digest
+   up to txin_sig_digest, and the signature digest up to header_digest */
+static bool zip244;
+static Zip244 zip244_state;
 static uint64_t to_spend, authorized_bip143_in, spending, change_spend;
 static uint32_t version = 1;
 static uint32_t lock_time = 0;
@@ -100,6 +119,29 @@ static uint8_t multisig_fp[32];
 static uint32_t in_address_n[8];
 static size_t in_address_n_count;
 static uint32_t tx_weight;
+static uint64_t prev_amount;
+
+/* Previous outputs whose amount was checked against their transaction hash
+   earlier in this session. Signing them again, e.g. for a fee bump, does
+   not need the previous transaction streamed a second time. */
+typedef struct {
+  const CoinType *coin;
+  uint8_t prev_hash[32];
+  uint32_t prev_index;
+  uint64_t amount;
+} VerifiedUtxo;
+
+static VerifiedUtxo utxo_cache[SIGNING_UTXO_CACHE_SIZE];
+static uint32_t utxo_cache_count, utxo_cache_next;
+
+/* Summary review of large payouts. Outputs to external addresses are not
+   shown one by one; the user confirms their count, total and the Merkle
+   root of the serialized outputs, which the host can show alongside its
+   recipient list. Offered in advanced mode only. */
+#define SIGNING_SUMMARY_MIN_OUTPUTS 10
+static bool summarizing;
+static uint64_t summary_amount;
+static MerkleTree summary_tree;
 
 /* A marker for in_address_n_count to indicate a mismatch in bip32 paths in
    input */
@@ -399,14 +441,30 @@ void send_req_finished(void) {
   msg_write(MessageType_MessageType_TxRequest, &resp);
 }
 
+/// Finishes a segwit midstate. With BIP341 hashing the hasher holds the
+/// single SHA-256, kept in \p tr_hash, and BIP143 commits to its hash.
+static void signing_hasher_final(Hasher *hasher, uint8_t *tr_hash,
+                                 uint8_t *hash) {
+  if (taproot_hashes) {
+    hasher_Final(hasher, tr_hash);
+    sha256_Raw(tr_hash, 32, hash);
+  } else {
+    hasher_Final(hasher, hash);
+  }
+}
+
 void phase1_request_next_input(void) {
   if (idx1 < inputs_count - 1) {
     idx1++;
     send_req_1_input();
   } else {
     //  compute segwit hashPrevouts & hashSequence
-    hasher_Final(&hasher_prevouts, hash_prevouts);
-    hasher_Final(&hasher_sequence, hash_sequence);
+    signing_hasher_final(&hasher_prevouts, tr_prevouts, hash_prevouts);
+    signing_hasher_final(&hasher_sequence, tr_sequences, hash_sequence);
+    if (taproot_inputs || zip244) {
+      hasher_Final(&hasher_amounts, hash_amounts);
+      hasher_Final(&hasher_scriptpubkeys, hash_scriptpubkeys);
+    }
     hasher_Final(&hasher_check, hash_check);
     // init hashOutputs
     hasher_Reset(&hasher_outputs);
@@ -563,7 +621,9 @@ bool check_change_bip32_path(const TxOutputType *toutput) {
           toutput->address_n[count - 1] <= BIP32_MAX_LAST_ELEMENT);
 }
 
-bool compile_input_script_sig(TxInputType *tinput) {
+/// Derives the signing node of an input, checking that the input still
+/// matches the ones seen in phase 1.
+static bool derive_input_node(const TxInputType *tinput) {
   if (!multisig_fp_mismatch) {
     // check that this is still multisig
     uint8_t h[32];
@@ -593,6 +653,13 @@ bool compile_input_script_sig(TxInputType *tinput) {
     return false;
   }
   hdnode_fill_public_key(&node);
+  return true;
+}
+
+bool compile_input_script_sig(TxInputType *tinput) {
+  if (!derive_input_node(tinput)) {
+    return false;
+  }
   if (tinput->has_multisig) {
     tinput->script_sig.size = compile_script_multisig(coin, &(tinput->multisig),
                                                       tinput->script_sig.bytes);
@@ -607,6 +674,7 @@ bool compile_input_script_sig(TxInputType *tinput) {
 
 void signing_init(const SignTx *msg, const CoinType *_coin,
                   const HDNode *_root) {
+  cryptoCosignerCacheClear();
   inputs_count = msg->inputs_count;
   outputs_count = msg->outputs_count;
   coin = _coin;
@@ -626,8 +694,12 @@ void signing_init(const SignTx *msg, const CoinType *_coin,
       case 4:
         branch_id = 0x76B809BB;  // Sapling
         break;
+      case 5:
+        branch_id = 0xC2D6D0B4;  // NU5
+        break;
     }
   }
+  zip244 = overwintered && version == 5;
 
   uint32_t size = TXSIZE_HEADER + TXSIZE_FOOTER +
                   ser_length_size(inputs_count) +
@@ -644,6 +716,9 @@ void signing_init(const SignTx *msg, const CoinType *_coin,
   to_spend = 0;
   spending = 0;
   change_spend = 0;
+  summarizing = false;
+  summary_amount = 0;
+  merkle_init(&summary_tree);
   authorized_bip143_in = 0;
   memset(&input, 0, sizeof(TxInputType));
   memset(&resp, 0, sizeof(TxRequest));
@@ -658,12 +733,14 @@ void signing_init(const SignTx *msg, const CoinType *_coin,
   multisig_fp_set = false;
   multisig_fp_mismatch = false;
   next_nonsegwit_input = 0xffffffff;
+  taproot_inputs = 0;
 
   curve = get_curve_by_name(coin->curve_name);
   if (!curve) curve = get_curve_by_name(SECP256K1_NAME);
 
   tx_init(&to, inputs_count, outputs_count, version, lock_time, expiry, 0,
           curve->hasher_sign, overwintered, version_group_id);
+  to.branch_id = branch_id;
 
   if (coin->decred) {
     to.version |= (DECRED_SERIALIZE_FULL << 16);
@@ -675,8 +752,23 @@ void signing_init(const SignTx *msg, const CoinType *_coin,
     ti.is_decred = true;
   }
 
+  taproot_hashes = coin->has_taproot && coin->taproot && !overwintered &&
+                   curve->hasher_sign == HASHER_SHA2D;
+
   // segwit hashes for hashPrevouts and hashSequence
-  if (overwintered) {
+  if (zip244) {
+    hasher_InitParam(&hasher_prevouts, HASHER_BLAKE2B_PERSONAL,
+                     "ZTxIdPrevoutHash", 16);
+    hasher_InitParam(&hasher_sequence, HASHER_BLAKE2B_PERSONAL,
+                     "ZTxIdSequencHash", 16);
+    hasher_InitParam(&hasher_outputs, HASHER_BLAKE2B_PERSONAL,
+                     "ZTxIdOutputsHash", 16);
+    hasher_Init(&hasher_check, curve->hasher_sign);
+    hasher_InitParam(&hasher_amounts, HASHER_BLAKE2B_PERSONAL,
+                     "ZTxTrAmountsHash", 16);
+    hasher_InitParam(&hasher_scriptpubkeys, HASHER_BLAKE2B_PERSONAL,
+                     "ZTxTrScriptsHash", 16);
+  } else if (overwintered) {
     hasher_InitParam(&hasher_prevouts, HASHER_BLAKE2B_PERSONAL,
                      "ZcashPrevoutHash", 16);
     hasher_InitParam(&hasher_sequence, HASHER_BLAKE2B_PERSONAL,
@@ -684,6 +776,13 @@ void signing_init(const SignTx *msg, const CoinType *_coin,
     hasher_InitParam(&hasher_outputs, HASHER_BLAKE2B_PERSONAL,
                      "ZcashOutputsHash", 16);
     hasher_Init(&hasher_check, curve->hasher_sign);
+  } else if (taproot_hashes) {
+    hasher_Init(&hasher_prevouts, HASHER_SHA2);
+    hasher_Init(&hasher_sequence, HASHER_SHA2);
+    hasher_Init(&hasher_outputs, HASHER_SHA2);
+    hasher_Init(&hasher_check, curve->hasher_sign);
+    hasher_Init(&hasher_amounts, HASHER_SHA2);
+    hasher_Init(&hasher_scriptpubkeys, HASHER_SHA2);
   } else {
     hasher_Init(&hasher_prevouts, curve->hasher_sign);
     hasher_Init(&hasher_sequence, curve->hasher_sign);
@@ -718,7 +817,8 @@ static bool is_internal_input_script_type(const TxInputType *txinput) {
   if (txinput->script_type == InputScriptType_SPENDADDRESS ||
       txinput->script_type == InputScriptType_SPENDMULTISIG ||
       txinput->script_type == InputScriptType_SPENDP2SHWITNESS ||
-      txinput->script_type == InputScriptType_SPENDWITNESS) {
+      txinput->script_type == InputScriptType_SPENDWITNESS ||
+      txinput->script_type == InputScriptType_SPENDTAPROOT) {
     return true;
   }
   return false;
@@ -793,6 +893,21 @@ static bool signing_validate_input(const TxInputType *txinput) {
     }
   }
 
+  if (txinput->script_type == InputScriptType_SPENDTAPROOT) {
+    if (!taproot_hashes) {
+      fsm_sendFailure(FailureType_Failure_Other,
+                      _("Taproot not enabled on this coin"));
+      signing_abort();
+      return false;
+    }
+    if (!txinput->has_amount) {
+      fsm_sendFailure(FailureType_Failure_Other,
+                      _("Taproot input without amount"));
+      signing_abort();
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -922,6 +1037,130 @@ static bool signing_check_input(TxInputType *txinput) {
   return true;
 }
 
+/// Writes the scriptPubKey spent by one of our non-segwit inputs, with its
+/// length prefix. Single signature inputs need \p node derived.
+static uint32_t signing_input_script_pubkey(const TxInputType *txinput,
+                                            uint8_t *out) {
+  if (txinput->has_multisig) {
+    uint8_t hash[32];
+    if (compile_script_multisig_hash(coin, &txinput->multisig, hash) == 0) {
+      return 0;
+    }
+    out[0] = 23;
+    out[1] = 0xA9;  // OP_HASH160
+    out[2] = 0x14;  // push 20 bytes
+    ripemd160(hash, 32, out + 3);
+    out[23] = 0x87;  // OP_EQUAL
+    return 24;
+  }
+  out[0] = 25;
+  out[1] = 0x76;  // OP_DUP
+  out[2] = 0xA9;  // OP_HASH160
+  out[3] = 0x14;  // push 20 bytes
+  ecdsa_get_pubkeyhash(node.public_key, curve->hasher_pubkey, out + 4);
+  out[24] = 0x88;  // OP_EQUALVERIFY
+  out[25] = 0xAC;  // OP_CHECKSIG
+  return 26;
+}
+
+/// Phase 1 of a ZIP-244 input: adds its amount and scriptPubKey to the
+/// digests every signature commits to.
+static bool signing_zip244_input(const TxInputType *txinput) {
+  uint8_t script_pubkey[26];
+  if (!txinput->has_multisig) {
+    memcpy(&node, root, sizeof(HDNode));
+    if (hdnode_private_ckd_cached(&node, txinput->address_n,
+                                  txinput->address_n_count, NULL) == 0) {
+      fsm_sendFailure(FailureType_Failure_Other,
+                      _("Failed to derive private key"));
+      signing_abort();
+      return false;
+    }
+    hdnode_fill_public_key(&node);
+  }
+  uint32_t size = signing_input_script_pubkey(txinput, script_pubkey);
+  if (size == 0) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to compile input"));
+    signing_abort();
+    return false;
+  }
+  hasher_Update(&hasher_scriptpubkeys, script_pubkey, size);
+  hasher_Update(&hasher_amounts, (const uint8_t *)&txinput->amount, 8);
+  return true;
+}
+
+/// Phase 1 of a key-path taproot input: its amount and output script go
+/// into the BIP341 midstates, so phase 2 needs nothing but the input.
+static bool signing_check_taproot_input(const TxInputType *txinput) {
+  if (to_spend + txinput->amount < to_spend) {
+    fsm_sendFailure(FailureType_Failure_SyntaxError, _("Value overflow"));
+    signing_abort();
+    return false;
+  }
+
+  // P2TR scriptPubKey, with its length: OP_1 <32 byte output key>
+  uint8_t script_pubkey[35] = {34, 0x51, 32};
+  memcpy(&node, root, sizeof(HDNode));
+  if (hdnode_private_ckd_cached(&node, txinput->address_n,
+                                txinput->address_n_count, NULL) == 0) {
+    fsm_sendFailure(FailureType_Failure_Other,
+                    _("Failed to derive private key"));
+    signing_abort();
+    return false;
+  }
+  hdnode_fill_public_key(&node);
+  if (!taproot_tweakPublicKey(node.public_key, script_pubkey + 3)) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to compile input"));
+    signing_abort();
+    return false;
+  }
+  hasher_Update(&hasher_scriptpubkeys, script_pubkey, sizeof(script_pubkey));
+  hasher_Update(&hasher_amounts, (const uint8_t *)&txinput->amount, 8);
+
+  if (!to.is_segwit) {
+    tx_weight += TXSIZE_SEGWIT_OVERHEAD + to.inputs_len;
+  }
+  to.is_segwit = true;
+  to_spend += txinput->amount;
+  authorized_bip143_in += txinput->amount;
+  txin_dgst_addto(txinput->prev_hash.bytes, sizeof(TxInputType_prev_hash_t));
+  return true;
+}
+
+void signing_utxoCacheClear(void) {
+  memzero(utxo_cache, sizeof(utxo_cache));
+  utxo_cache_count = 0;
+  utxo_cache_next = 0;
+}
+
+static const VerifiedUtxo *signing_utxoCacheFind(const TxInputType *txinput) {
+  for (uint32_t i = 0; i < utxo_cache_count; i++) {
+    const VerifiedUtxo *utxo = &utxo_cache[i];
+    if (utxo->coin == coin && utxo->prev_index == txinput->prev_index &&
+        memcmp(utxo->prev_hash, txinput->prev_hash.bytes, 32) == 0) {
+      return utxo;
+    }
+  }
+  return NULL;
+}
+
+/// Remembers the output spent by the current input once its previous
+/// transaction has been verified. The oldest entry is evicted when full.
+static void signing_utxoCacheAdd(void) {
+  if (signing_utxoCacheFind(&input)) {
+    return;
+  }
+  VerifiedUtxo *utxo = &utxo_cache[utxo_cache_next];
+  utxo->coin = coin;
+  memcpy(utxo->prev_hash, input.prev_hash.bytes, 32);
+  utxo->prev_index = input.prev_index;
+  utxo->amount = prev_amount;
+  utxo_cache_next = (utxo_cache_next + 1) % SIGNING_UTXO_CACHE_SIZE;
+  if (utxo_cache_count < SIGNING_UTXO_CACHE_SIZE) {
+    utxo_cache_count++;
+  }
+}
+
 // check if the hash of the prevtx matches
 static bool signing_check_prevtx_hash(void) {
   uint8_t hash[32];
@@ -932,10 +1171,59 @@ static bool signing_check_prevtx_hash(void) {
     signing_abort();
     return false;
   }
+  signing_utxoCacheAdd();
   phase1_request_next_input();
   return true;
 }
 
+/// Adds a leaf to the Merkle tree of summarized outputs.
+static bool signing_summary_add(const TxOutputBinType *bin) {
+  Hasher hasher;
+  uint8_t leaf[32];
+  hasher_Init(&hasher, HASHER_SHA2D);
+  tx_output_hash(&hasher, bin, false);
+  hasher_Final(&hasher, leaf);
+  return merkle_add(&summary_tree, leaf);
+}
+
+static bool signing_summary_confirm(void) {
+  uint8_t root[32];
+  if (!merkle_root(&summary_tree, root)) {
+    return true;
+  }
+
+  // Sized for txin_dgst_save_and_reset, which copies the full buffers
+  char amount_str[AMT_STR_LEN], root_str[ADDR_STR_LEN];
+  memset(amount_str, 0, sizeof(amount_str));
+  memset(root_str, 0, sizeof(root_str));
+  data2hex(root, sizeof(root), root_str);
+  kk_strlwr(root_str);
+  coin_amnt_to_str(coin, summary_amount, amount_str, sizeof(amount_str));
+  if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, "Summary",
+               "Send %s in total to %" PRIu32
+               " outputs? Recipient list root %s",
+               amount_str, summary_tree.count, root_str)) {
+    fsm_sendFailure(FailureType_Failure_ActionCancelled,
+                    "Signing cancelled by user.");
+    signing_abort();
+    return false;
+  }
+
+  // Same duplicate transaction check as for individually confirmed outputs
+  if (txin_dgst_compare(amount_str, root_str)) {
+    review(ButtonRequestType_ButtonRequest_Other,
+           "WARNING: Duplicate Transaction!",
+           "Already signed a tx with the same outputs\n"
+           "To try again, unplug/replug KeepKey.");
+    txin_dgst_save_and_reset(amount_str, root_str);
+    fsm_sendFailure(FailureType_Failure_ActionCancelled, NULL);
+    signing_abort();
+    return false;
+  }
+  txin_dgst_save_and_reset(amount_str, root_str);
+  return true;
+}
+
 static bool signing_check_output(TxOutputType *txoutput) {
   // Phase1: Check outputs
   //   add it to hash_outputs
@@ -973,14 +1261,31 @@ static bool signing_check_output(TxOutputType *txoutput) {
     }
   }
 
+  if (idx1 == 0 && outputs_count >= SIGNING_SUMMARY_MIN_OUTPUTS &&
+      outputs_count < (1u << MERKLE_LEVELS) &&
+      storage_isPolicyEnabled("AdvancedMode")) {
+    summarizing = confirm(ButtonRequestType_ButtonRequest_Other,
+                          "Review Summary",
+                          "Review %" PRIu32
+                          " outputs as one summary? Reject to review each "
+                          "output.",
+                          outputs_count);
+  }
+
+  // Payments to external addresses go into the summary. Change to other
+  // accounts and OP_RETURN data are still shown on their own.
+  bool summarized = summarizing && !is_change &&
+                    txoutput->address_n_count == 0 &&
+                    txoutput->script_type != OutputScriptType_PAYTOOPRETURN;
+
   if (spending + txoutput->amount < spending) {
     fsm_sendFailure(FailureType_Failure_SyntaxError, _("Value overflow"));
     signing_abort();
     return false;
   }
   spending += txoutput->amount;
-  int co =
-      run_policy_compile_output(coin, root, txoutput, &bin_output, !is_change);
+  int co = run_policy_compile_output(coin, root, txoutput, &bin_output,
+                                     !is_change && !summarized);
   if (!is_change) {
     layoutProgress(_("Signing transaction"), progress);
   }
@@ -989,6 +1294,14 @@ static bool signing_check_output(TxOutputType *txoutput) {
     signing_abort();
     return false;
   }
+  if (summarized) {
+    if (!signing_summary_add(&bin_output)) {
+      fsm_sendFailure(FailureType_Failure_Other, _("Too many outputs"));
+      signing_abort();
+      return false;
+    }
+    summary_amount += txoutput->amount;
+  }
   if (coin->decred) {
     // serialize Decred prefix in Phase 1
     resp.has_serialized = true;
@@ -1050,6 +1363,16 @@ static uint32_t signing_hash_type(void) {
   return hash_type;
 }
 
+/// Computes everything in the ZIP-244 signature digest that does not depend
+/// on the input being signed, once all outputs are known.
+static void signing_zip244_precompute(void) {
+  zip244_init(&zip244_state, version, version_group_id, branch_id, lock_time,
+              expiry);
+  zip244_transparent(&zip244_state, signing_hash_type() & 0xff, hash_prevouts,
+                     hash_amounts, hash_scriptpubkeys, hash_sequence,
+                     hash_outputs);
+}
+
 static void phase1_request_next_output(void) {
   if (idx1 < outputs_count - 1) {
     idx1++;
@@ -1059,10 +1382,16 @@ static void phase1_request_next_output(void) {
       // compute Decred hashPrefix
       tx_hash_final(&ti, hash_prefix, false);
     }
-    hasher_Final(&hasher_outputs, hash_outputs);
+    signing_hasher_final(&hasher_outputs, tr_outputs, hash_outputs);
+    if (!signing_summary_confirm()) {
+      return;
+    }
     if (!signing_check_fee()) {
       return;
     }
+    if (zip244) {
+      signing_zip244_precompute();
+    }
     // Everything was checked, now phase 2 begins and the transaction is signed.
     progress_meta_step = progress_step / (inputs_count + outputs_count);
     layoutProgress(_("Signing transaction"), progress);
@@ -1170,6 +1499,44 @@ static void signing_hash_zip243(const TxInputType *txinput, uint8_t *hash) {
   hasher_Final(&hasher_preimage, hash);
 }
 
+/// BIP341 signature message of key-path input idx1, with SIGHASH_DEFAULT.
+static void signing_hash_bip341(uint8_t *hash) {
+  static const uint8_t epoch_and_hash_type[2] = {0x00, 0x00};
+  static const uint8_t spend_type = 0x00;  // key path, no annex
+  SHA256_CTX ctx;
+  taproot_taggedHashInit(&ctx, "TapSighash");
+  sha256_Update(&ctx, epoch_and_hash_type, sizeof(epoch_and_hash_type));
+  sha256_Update(&ctx, (const uint8_t *)&version, 4);    // nVersion
+  sha256_Update(&ctx, (const uint8_t *)&lock_time, 4);  // nLockTime
+  sha256_Update(&ctx, tr_prevouts, 32);
+  sha256_Update(&ctx, hash_amounts, 32);
+  sha256_Update(&ctx, hash_scriptpubkeys, 32);
+  sha256_Update(&ctx, tr_sequences, 32);
+  sha256_Update(&ctx, tr_outputs, 32);
+  sha256_Update(&ctx, &spend_type, 1);
+  sha256_Update(&ctx, (const uint8_t *)&idx1, 4);  // input_index
+  sha256_Final(&ctx, hash);
+}
+
+/// ZIP-244 signature digest of a transparent input, from the midstates of
+/// signing_zip244_precompute. Expects \p node derived for the input.
+static bool signing_hash_zip244(const TxInputType *txinput, uint8_t *hash) {
+  uint8_t script_pubkey[26], hash_txin[32];
+  uint32_t size = signing_input_script_pubkey(txinput, script_pubkey);
+  if (size == 0) {
+    return false;
+  }
+
+  uint8_t prev_hash[32];
+  for (int i = 0; i < 32; i++) {
+    prev_hash[i] = txinput->prev_hash.bytes[31 - i];
+  }
+  zip244_txin(prev_hash, txinput->prev_index, txinput->amount, script_pubkey,
+              size, txinput->sequence, hash_txin);
+  zip244_sigDigest(&zip244_state, hash_txin, hash);
+  return true;
+}
+
 static void signing_hash_decred(const uint8_t *hash_witness, uint8_t *hash) {
   uint32_t hash_type = signing_hash_type();
   Hasher hasher_preimage;
@@ -1246,11 +1613,55 @@ static bool signing_sign_input(void) {
   return true;
 }
 
+static bool signing_sign_taproot_input(TxInputType *txinput) {
+  if (!derive_input_node(txinput)) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to compile input"));
+    signing_abort();
+    return false;
+  }
+  if (txinput->amount > authorized_bip143_in) {
+    fsm_sendFailure(FailureType_Failure_SyntaxError,
+                    _("Transaction has changed during signing"));
+    signing_abort();
+    return false;
+  }
+  authorized_bip143_in -= txinput->amount;
+
+  uint8_t hash[32], aux[32];
+  signing_hash_bip341(hash);
+  random_buffer(aux, sizeof(aux));
+  bool ok = taproot_tweakPrivateKey(node.private_key, privkey) &&
+            taproot_schnorrSign(privkey, hash, aux, sig);
+  memzero(privkey, sizeof(privkey));
+  if (!ok) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Signing failed"));
+    signing_abort();
+    return false;
+  }
+
+  resp.has_serialized = true;
+  resp.serialized.has_signature_index = true;
+  resp.serialized.signature_index = idx1;
+  resp.serialized.has_signature = true;
+  memcpy(resp.serialized.signature.bytes, sig, 64);
+  resp.serialized.signature.size = 64;
+  resp.serialized.has_serialized_tx = true;
+  uint32_t r = 0;
+  r += ser_length(1, resp.serialized.serialized_tx.bytes + r);
+  r += tx_serialize_script(64, sig, resp.serialized.serialized_tx.bytes + r);
+  resp.serialized.serialized_tx.size = r;
+  return true;
+}
+
 static bool signing_sign_segwit_input(TxInputType *txinput) {
   // idx1: index to sign
   uint8_t hash[32];
 
-  if (is_segwit_input_script_type(txinput)) {
+  if (txinput->script_type == InputScriptType_SPENDTAPROOT) {
+    if (!signing_sign_taproot_input(txinput)) {
+      return false;
+    }
+  } else if (is_segwit_input_script_type(txinput)) {
     if (!compile_input_script_sig(txinput)) {
       fsm_sendFailure(FailureType_Failure_Other, _("Failed to compile input"));
       signing_abort();
@@ -1337,6 +1748,154 @@ static bool signing_sign_decred_input(TxInputType *txinput) {
 
 #define ENABLE_SEGWIT_NONSEGWIT_MIXING 1
 
+/// Rejects a TxAck carrying items the current stage does not take.
+static void signing_unexpected_items(void) {
+  fsm_sendFailure(FailureType_Failure_UnexpectedMessage,
+                  _("Unexpected items in TxAck"));
+  signing_abort();
+}
+
+/// Hashes input idx2 of the previous transaction being checked.
+static bool signing_prev_input(TxInputType *txinput) {
+  if (!signing_validate_input(txinput)) {
+    return false;
+  }
+  progress = (idx1 * progress_step + idx2 * progress_meta_step) >>
+             PROGRESS_PRECISION;
+  if (!tx_serialize_input_hash(&tp, txinput)) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to serialize input"));
+    signing_abort();
+    return false;
+  }
+  return true;
+}
+
+/// Hashes output idx2 of the previous transaction being checked, and adds
+/// it to the amount spent if it is the one being spent.
+static bool signing_prev_output(TxOutputBinType *bin_output) {
+  if (!signing_validate_bin_output(bin_output)) {
+    return false;
+  }
+  progress = (idx1 * progress_step +
+              (tp.inputs_len + idx2) * progress_meta_step) >>
+             PROGRESS_PRECISION;
+  if (!tx_serialize_output_hash(&tp, bin_output)) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to serialize output"));
+    signing_abort();
+    return false;
+  }
+  if (idx2 == input.prev_index) {
+    if (to_spend + bin_output->amount < to_spend) {
+      fsm_sendFailure(FailureType_Failure_SyntaxError, _("Value overflow"));
+      signing_abort();
+      return false;
+    }
+    if (coin->decred && bin_output->decred_script_version > 0) {
+      fsm_sendFailure(
+          FailureType_Failure_SyntaxError,
+          _("Decred script version does not match previous output"));
+      signing_abort();
+      return false;
+    }
+    to_spend += bin_output->amount;
+    prev_amount = bin_output->amount;
+  }
+  return true;
+}
+
+/// Hashes the prev tx outputs in \p tx, consecutive from idx2, and then
+/// requests the next one or finishes the prev tx.
+static void signing_prev_outputs(TransactionType *tx) {
+  const size_t count = MAX(tx->bin_outputs_count, 1);
+  if (count > tp.outputs_len - idx2) {
+    signing_unexpected_items();
+    return;
+  }
+  for (size_t k = 0; k < count; k++) {
+    if (k > 0) {
+      idx2++;
+    }
+    if (!signing_prev_output(&tx->bin_outputs[k])) {
+      return;
+    }
+  }
+  if (idx2 < tp.outputs_len - 1) {
+    /* Check prevtx of next input */
+    idx2++;
+    send_req_2_prev_output();
+  } else if (tp.extra_data_len > 0) {  // has extra data
+    send_req_2_prev_extradata(0, MIN(1024U, tp.extra_data_len));
+  } else {
+    /* prevtx is done */
+    signing_check_prevtx_hash();
+  }
+}
+
+/// Hashes input idx2 into the legacy sighash of input idx1.
+static bool signing_phase2_input(TxInputType *txinput) {
+  if (!signing_validate_input(txinput)) {
+    return false;
+  }
+  progress = 500 + ((signatures * progress_step + idx2 * progress_meta_step) >>
+                    PROGRESS_PRECISION);
+  if (idx2 == 0) {
+    tx_init(&ti, inputs_count, outputs_count, version, lock_time, expiry, 0,
+            curve->hasher_sign, overwintered, version_group_id);
+    hasher_Reset(&hasher_check);
+  }
+  // check prevouts and script type
+  tx_prevout_hash(&hasher_check, txinput);
+  hasher_Update(&hasher_check, (const uint8_t *)&txinput->script_type,
+                sizeof(&txinput->script_type));
+  if (idx2 == idx1) {
+    if (!compile_input_script_sig(txinput)) {
+      fsm_sendFailure(FailureType_Failure_Other, _("Failed to compile input"));
+      signing_abort();
+      return false;
+    }
+    memcpy(&input, txinput, sizeof(input));
+    memcpy(privkey, node.private_key, 32);
+    memcpy(pubkey, node.public_key, 33);
+  } else {
+    if (next_nonsegwit_input == idx1 && idx2 > idx1 &&
+        (txinput->script_type == InputScriptType_SPENDADDRESS ||
+         txinput->script_type == InputScriptType_SPENDMULTISIG)) {
+      next_nonsegwit_input = idx2;
+    }
+    txinput->script_sig.size = 0;
+  }
+  if (!tx_serialize_input_hash(&ti, txinput)) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to serialize input"));
+    signing_abort();
+    return false;
+  }
+  return true;
+}
+
+/// Hashes output idx2 into the legacy sighash of input idx1.
+static bool signing_phase2_output(TxOutputType *txoutput) {
+  if (!signing_validate_output(txoutput)) {
+    return false;
+  }
+  progress = 500 + ((signatures * progress_step +
+                     (inputs_count + idx2) * progress_meta_step) >>
+                    PROGRESS_PRECISION);
+  int co = run_policy_compile_output(coin, root, txoutput, &bin_output, false);
+  if (co <= TXOUT_COMPILE_ERROR) {
+    send_fsm_co_error_message(co);
+    signing_abort();
+    return false;
+  }
+  //  check hashOutputs
+  tx_output_hash(&hasher_check, &bin_output, coin->decred);
+  if (!tx_serialize_output_hash(&ti, &bin_output)) {
+    fsm_sendFailure(FailureType_Failure_Other, _("Failed to serialize output"));
+    signing_abort();
+    return false;
+  }
+  return true;
+}
+
 void signing_txack(TransactionType *tx) {
   if (!signing) {
     fsm_sendFailure(FailureType_Failure_UnexpectedMessage,
@@ -1365,6 +1924,18 @@ void signing_txack(TransactionType *tx) {
         tx_weight += tx_decred_witness_weight(&tx->inputs[0]);
       }
 
+      // BIP341 commits to the scripts of all inputs, which are only known
+      // for our own taproot inputs
+      if (idx1 > 0 &&
+          (tx->inputs[0].script_type == InputScriptType_SPENDTAPROOT) !=
+              (taproot_inputs > 0)) {
+        fsm_sendFailure(
+            FailureType_Failure_SyntaxError,
+            _("Mixing taproot and non-taproot inputs is not supported"));
+        signing_abort();
+        return;
+      }
+
       if (tx->inputs[0].script_type == InputScriptType_SPENDMULTISIG ||
           tx->inputs[0].script_type == InputScriptType_SPENDADDRESS) {
         memcpy(&input, tx->inputs, sizeof(TxInputType));
@@ -1392,6 +1963,9 @@ void signing_txack(TransactionType *tx) {
             signing_abort();
             return;
           }
+          if (zip244 && !signing_zip244_input(&tx->inputs[0])) {
+            return;
+          }
           to_spend += tx->inputs[0].amount;
           authorized_bip143_in += tx->inputs[0].amount;
           phase1_request_next_input();
@@ -1399,7 +1973,20 @@ void signing_txack(TransactionType *tx) {
           // remember the first non-segwit input -- this is the first input
           // we need to sign during phase2
           if (next_nonsegwit_input == 0xffffffff) next_nonsegwit_input = idx1;
-          send_req_2_prev_meta();
+          const VerifiedUtxo *utxo = signing_utxoCacheFind(&tx->inputs[0]);
+          if (utxo && (!tx->inputs[0].has_amount ||
+                       tx->inputs[0].amount == utxo->amount)) {
+            if (to_spend + utxo->amount < to_spend) {
+              fsm_sendFailure(FailureType_Failure_SyntaxError,
+                              _("Value overflow"));
+              signing_abort();
+              return;
+            }
+            to_spend += utxo->amount;
+            phase1_request_next_input();
+          } else {
+            send_req_2_prev_meta();
+          }
         }
       } else if (tx->inputs[0].script_type == InputScriptType_SPENDWITNESS ||
                  tx->inputs[0].script_type ==
@@ -1450,6 +2037,12 @@ void signing_txack(TransactionType *tx) {
         txin_dgst_addto(tx->inputs[0].prev_hash.bytes,
                         sizeof(TxInputType_prev_hash_t));
 
+        phase1_request_next_input();
+      } else if (tx->inputs[0].script_type == InputScriptType_SPENDTAPROOT) {
+        taproot_inputs++;
+        if (!signing_check_taproot_input(&tx->inputs[0])) {
+          return;
+        }
         phase1_request_next_input();
       } else {
         fsm_sendFailure(FailureType_Failure_SyntaxError,
@@ -1489,64 +2082,37 @@ void signing_txack(TransactionType *tx) {
       }
       return;
     case STAGE_REQUEST_2_PREV_INPUT:
-      if (!signing_validate_input(&tx->inputs[0])) {
+      if (tx->outputs_count > 0) {
+        signing_unexpected_items();
         return;
       }
-      progress = (idx1 * progress_step + idx2 * progress_meta_step) >>
-                 PROGRESS_PRECISION;
-      if (!tx_serialize_input_hash(&tp, tx->inputs)) {
-        fsm_sendFailure(FailureType_Failure_Other,
-                        _("Failed to serialize input"));
-        signing_abort();
+      if (!signing_prev_input(&tx->inputs[0])) {
         return;
       }
       if (idx2 < tp.inputs_len - 1) {
+        // Outputs of the prev tx may only follow its last input
+        if (tx->bin_outputs_count > 0) {
+          signing_unexpected_items();
+          return;
+        }
         idx2++;
         send_req_2_prev_input();
-      } else {
-        idx2 = 0;
-        send_req_2_prev_output();
-      }
-      return;
-    case STAGE_REQUEST_2_PREV_OUTPUT:
-      if (!signing_validate_bin_output(&tx->bin_outputs[0])) {
         return;
       }
-      progress = (idx1 * progress_step +
-                  (tp.inputs_len + idx2) * progress_meta_step) >>
-                 PROGRESS_PRECISION;
-      if (!tx_serialize_output_hash(&tp, tx->bin_outputs)) {
-        fsm_sendFailure(FailureType_Failure_Other,
-                        _("Failed to serialize output"));
-        signing_abort();
+      idx2 = 0;
+      if (tx->bin_outputs_count == 0) {
+        send_req_2_prev_output();
         return;
       }
-      if (idx2 == input.prev_index) {
-        if (to_spend + tx->bin_outputs[0].amount < to_spend) {
-          fsm_sendFailure(FailureType_Failure_SyntaxError, _("Value overflow"));
-          signing_abort();
-          return;
-        }
-        if (coin->decred && tx->bin_outputs[0].decred_script_version > 0) {
-          fsm_sendFailure(
-              FailureType_Failure_SyntaxError,
-              _("Decred script version does not match previous output"));
-          signing_abort();
-          return;
-        }
-        to_spend += tx->bin_outputs[0].amount;
-      }
-      if (idx2 < tp.outputs_len - 1) {
-        /* Check prevtx of next input */
-        idx2++;
-        send_req_2_prev_output();
-      } else if (tp.extra_data_len > 0) {  // has extra data
-        send_req_2_prev_extradata(0, MIN(1024U, tp.extra_data_len));
+      // Its outputs, when they follow in the same ack
+      signing_prev_outputs(tx);
+      return;
+    case STAGE_REQUEST_2_PREV_OUTPUT:
+      if (tx->inputs_count > 0 || tx->outputs_count > 0) {
+        signing_unexpected_items();
         return;
-      } else {
-        /* prevtx is done */
-        signing_check_prevtx_hash();
       }
+      signing_prev_outputs(tx);
       return;
     case STAGE_REQUEST_2_PREV_EXTRADATA:
       if (!tx_serialize_extra_data_hash(&tp, tx->extra_data.bytes,
@@ -1566,8 +2132,10 @@ void signing_txack(TransactionType *tx) {
       }
       return;
     case STAGE_REQUEST_3_OUTPUT:
-
-      txin_dgst_final();
+      // All inputs have been hashed once the first output arrives
+      if (idx1 == 0) {
+        txin_dgst_final();
+      }
 
       if (!signing_validate_output(&tx->outputs[0]) ||
           !signing_check_output(&tx->outputs[0])) {
@@ -1577,43 +2145,11 @@ void signing_txack(TransactionType *tx) {
       phase1_request_next_output();
       return;
     case STAGE_REQUEST_4_INPUT:
-      if (!signing_validate_input(&tx->inputs[0])) {
+      if (tx->bin_outputs_count > 0 || tx->outputs_count > 0) {
+        signing_unexpected_items();
         return;
       }
-      progress =
-          500 + ((signatures * progress_step + idx2 * progress_meta_step) >>
-                 PROGRESS_PRECISION);
-      if (idx2 == 0) {
-        tx_init(&ti, inputs_count, outputs_count, version, lock_time, expiry, 0,
-                curve->hasher_sign, overwintered, version_group_id);
-        hasher_Reset(&hasher_check);
-      }
-      // check prevouts and script type
-      tx_prevout_hash(&hasher_check, tx->inputs);
-      hasher_Update(&hasher_check, (const uint8_t *)&tx->inputs[0].script_type,
-                    sizeof(&tx->inputs[0].script_type));
-      if (idx2 == idx1) {
-        if (!compile_input_script_sig(&tx->inputs[0])) {
-          fsm_sendFailure(FailureType_Failure_Other,
-                          _("Failed to compile input"));
-          signing_abort();
-          return;
-        }
-        memcpy(&input, &tx->inputs[0], sizeof(input));
-        memcpy(privkey, node.private_key, 32);
-        memcpy(pubkey, node.public_key, 33);
-      } else {
-        if (next_nonsegwit_input == idx1 && idx2 > idx1 &&
-            (tx->inputs[0].script_type == InputScriptType_SPENDADDRESS ||
-             tx->inputs[0].script_type == InputScriptType_SPENDMULTISIG)) {
-          next_nonsegwit_input = idx2;
-        }
-        tx->inputs[0].script_sig.size = 0;
-      }
-      if (!tx_serialize_input_hash(&ti, tx->inputs)) {
-        fsm_sendFailure(FailureType_Failure_Other,
-                        _("Failed to serialize input"));
-        signing_abort();
+      if (!signing_phase2_input(&tx->inputs[0])) {
         return;
       }
       if (idx2 < inputs_count - 1) {
@@ -1634,25 +2170,11 @@ void signing_txack(TransactionType *tx) {
       }
       return;
     case STAGE_REQUEST_4_OUTPUT:
-      if (!signing_validate_output(&tx->outputs[0])) {
+      if (tx->inputs_count > 0 || tx->bin_outputs_count > 0) {
+        signing_unexpected_items();
         return;
       }
-      progress = 500 + ((signatures * progress_step +
-                         (inputs_count + idx2) * progress_meta_step) >>
-                        PROGRESS_PRECISION);
-      int co = run_policy_compile_output(coin, root, tx->outputs, &bin_output,
-                                         false);
-      if (co <= TXOUT_COMPILE_ERROR) {
-        send_fsm_co_error_message(co);
-        signing_abort();
-        return;
-      }
-      //  check hashOutputs
-      tx_output_hash(&hasher_check, &bin_output, coin->decred);
-      if (!tx_serialize_output_hash(&ti, &bin_output)) {
-        fsm_sendFailure(FailureType_Failure_Other,
-                        _("Failed to serialize output"));
-        signing_abort();
+      if (!signing_phase2_output(&tx->outputs[0])) {
         return;
       }
       if (idx2 < outputs_count - 1) {
@@ -1716,6 +2238,14 @@ void signing_txack(TransactionType *tx) {
             case 4:
               signing_hash_zip243(&tx->inputs[0], hash);
               break;
+            case 5:
+              if (!signing_hash_zip244(&tx->inputs[0], hash)) {
+                fsm_sendFailure(FailureType_Failure_Other,
+                                _("Failed to compile input"));
+                signing_abort();
+                return;
+              }
+              break;
             default:
               fsm_sendFailure(
                   FailureType_Failure_SyntaxError,
@@ -1901,4 +2431,5 @@ void signing_abort(void) {
   }
   memzero(&root, sizeof(root));
   memzero(&node, sizeof(node));
+  cryptoCosignerCacheClear();
 }
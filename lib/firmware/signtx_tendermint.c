@@ -20,6 +20,7 @@
 #include "keepkey/firmware/cosmos.h"
 #include "keepkey/board/confirm_sm.h"
 #include "keepkey/board/util.h"
+#include "keepkey/firmware/crypto.h"
 #include "keepkey/firmware/home_sm.h"
 #include "keepkey/firmware/signtx_tendermint.h"
 #include "keepkey/firmware/storage.h"
@@ -33,22 +34,31 @@
 #include <time.h>
 
 static CONFIDENTIAL HDNode node;
-static SHA256_CTX ctx;
+static TendermintJsonHasher json;
+static TendermintAddressCache addresses;
 static bool has_message;
 static bool initialized;
 static uint32_t msgs_remaining;
 static TendermintSignTx tmsg;
+static uint8_t digest[SHA256_DIGEST_LENGTH];
+static bool has_digest;
 
 const void *tendermint_getSignTx(void) { return (void *)&tmsg; }
 
+const char *tendermint_signerAddress(const char *prefix) {
+  return tendermint_cachedAddress(&addresses, prefix);
+}
+
 bool tendermint_signTxInit(const HDNode *_node, const void *_msg,
                            const size_t msgsize, const char *denom) {
   initialized = true;
   msgs_remaining = ((TendermintSignTx *)_msg)->msg_count;
   has_message = false;
+  has_digest = false;
 
   memzero(&node, sizeof(node));
   memcpy(&node, _node, sizeof(node));
+  tendermint_addressCacheInit(&addresses, &node);
 
   /*
     _msg is expected to be of type TendermintSignTx, CosmosSignTx or
@@ -67,55 +77,44 @@ bool tendermint_signTxInit(const HDNode *_node, const void *_msg,
 
   memcpy((void *)&tmsg, _msg, msgsize);
 
-  bool success = true;
-  char buffer[128];
-
-  sha256_Init(&ctx);
+  tendermint_jsonInit(&json);
 
-  // Each segment guaranteed to be less than or equal to 64 bytes
-  // 19 + ^20 + 1 = ^40
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"account_number\":\"%" PRIu64 "\"",
-                                 tmsg.account_number);
+  tendermint_jsonWriteStr(&json, "{\"account_number\":\"");
+  tendermint_jsonWriteUint(&json, tmsg.account_number);
+  tendermint_jsonWriteStr(&json, "\"");
 
   // <escape chain_id>
   const char *const chainid_prefix = ",\"chain_id\":\"";
-  sha256_Update(&ctx, (uint8_t *)chainid_prefix, strlen(chainid_prefix));
-  tendermint_sha256UpdateEscaped(&ctx, tmsg.chain_id, strlen(tmsg.chain_id));
+  tendermint_jsonWrite(&json, chainid_prefix, strlen(chainid_prefix));
+  tendermint_jsonWriteEscaped(&json, tmsg.chain_id, strlen(tmsg.chain_id));
 
-  // 30 + ^10 + 11 + ^9 + 3 = ^63
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "\",\"fee\":{\"amount\":[{\"amount\":\"%" PRIu32 "\",\"denom\":\"%s\"}]",
-      tmsg.fee_amount, denom);
+  tendermint_jsonWriteStr(&json, "\",\"fee\":{\"amount\":[{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, tmsg.fee_amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}]");
 
-  // 8 + ^10 + 2 = ^20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"gas\":\"%" PRIu32 "\"}", tmsg.gas);
+  tendermint_jsonWriteStr(&json, ",\"gas\":\"");
+  tendermint_jsonWriteUint(&json, tmsg.gas);
+  tendermint_jsonWriteStr(&json, "\"}");
 
   // <escape memo>
   const char *const memo_prefix = ",\"memo\":\"";
-  sha256_Update(&ctx, (uint8_t *)memo_prefix, strlen(memo_prefix));
+  tendermint_jsonWrite(&json, memo_prefix, strlen(memo_prefix));
   if (tmsg.has_memo) {
-    tendermint_sha256UpdateEscaped(&ctx, tmsg.memo, strlen(tmsg.memo));
+    tendermint_jsonWriteEscaped(&json, tmsg.memo, strlen(tmsg.memo));
   }
 
-  // 10
-  sha256_Update(&ctx, (uint8_t *)"\",\"msgs\":[", 10);
+  tendermint_jsonWrite(&json, "\",\"msgs\":[", 10);
 
-  return success;
+  return true;
 }
 
 bool tendermint_signTxUpdateMsgSend(const uint64_t amount,
                                     const char *to_address,
                                     const char *chainstr, const char *denom,
                                     const char *msgTypePrefix) {
-  char buffer[128];
-  size_t decoded_len;
-  char hrp[45];
-  uint8_t decoded[38];
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, to_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, to_address)) {
     return false;
   }
 
@@ -124,48 +123,38 @@ bool tendermint_signTxUpdateMsgSend(const uint64_t amount,
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54];
-  if (!tendermint_getAddress(&node, chainstr, from_address)) {
+  const char *from_address = tendermint_cachedAddress(&addresses, chainstr);
+  if (!from_address) {
     return false;
   }
 
   if (has_message) {
-    sha256_Update(&ctx, (uint8_t *)",", 1);
+    tendermint_jsonWrite(&json, ",", 1);
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 19 = ^52
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"type\":\"%s/MsgSend\",\"value\":{",
-                                 msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "{\"type\":\"");
+  tendermint_jsonWriteStr(&json, msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "/MsgSend\",\"value\":{");
 
-  // 21 + ^20 + 11 + ^9 + 3 = ^64
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"amount\":[{\"amount\":\"%" PRIu64
-                                 "\",\"denom\":\"%s\"}]",
-                                 amount, denom);
+  tendermint_jsonWriteStr(&json, "\"amount\":[{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}]");
 
-  // 17
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), ",\"from_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"from_address\":\"");
 
-  // ^53 + 1 = ^54
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"", from_address);
+  tendermint_jsonWriteStr(&json, from_address);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 15
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), ",\"to_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"to_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}", to_address);
+  tendermint_jsonWriteStr(&json, to_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool tendermint_signTxUpdateMsgDelegate(const uint64_t amount,
@@ -173,12 +162,7 @@ bool tendermint_signTxUpdateMsgDelegate(const uint64_t amount,
                                         const char *validator_address,
                                         const char *chainstr, const char *denom,
                                         const char *msgTypePrefix) {
-  char buffer[128];
-  size_t decoded_len;
-  char hrp[45];
-  uint8_t decoded[38];
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
@@ -187,48 +171,38 @@ bool tendermint_signTxUpdateMsgDelegate(const uint64_t amount,
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54];
-  if (!tendermint_getAddress(&node, chainstr, from_address)) {
+  const char *from_address = tendermint_cachedAddress(&addresses, chainstr);
+  if (!from_address) {
     return false;
   }
 
   if (has_message) {
-    sha256_Update(&ctx, (uint8_t *)",", 1);
+    tendermint_jsonWrite(&json, ",", 1);
   }
 
-  bool success = true;
+  tendermint_jsonWriteStr(&json, "{\"type\":\"");
+  tendermint_jsonWriteStr(&json, msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "/MsgDelegate\",\"value\":{");
 
-  // 9 + ^24 + 23 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"type\":\"%s/MsgDelegate\",\"value\":{",
-                                 msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "\"amount\":{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  // 20 + ^20 + 11 + ^9 + 2 = ^62
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"amount\":{\"amount\":\"%" PRIu64
-                                 "\",\"denom\":\"%s\"}",
-                                 amount, denom);
+  tendermint_jsonWriteStr(&json, ",\"delegator_address\":\"");
 
-  // 22
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, delegator_address);
+  tendermint_jsonWriteStr(&json, "\",\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\",\"",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, "validator_address\":\"");
 
-  // 20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "validator_address\":\"");
-
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_address);
+  tendermint_jsonWriteStr(&json, validator_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 bool tendermint_signTxUpdateMsgUndelegate(const uint64_t amount,
                                           const char *delegator_address,
@@ -236,12 +210,7 @@ bool tendermint_signTxUpdateMsgUndelegate(const uint64_t amount,
                                           const char *chainstr,
                                           const char *denom,
                                           const char *msgTypePrefix) {
-  char buffer[128];
-  size_t decoded_len;
-  char hrp[45];
-  uint8_t decoded[38];
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
@@ -250,60 +219,45 @@ bool tendermint_signTxUpdateMsgUndelegate(const uint64_t amount,
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54];
-  if (!tendermint_getAddress(&node, chainstr, from_address)) {
+  const char *from_address = tendermint_cachedAddress(&addresses, chainstr);
+  if (!from_address) {
     return false;
   }
 
   if (has_message) {
-    sha256_Update(&ctx, (uint8_t *)",", 1);
+    tendermint_jsonWrite(&json, ",", 1);
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 25 = ^58
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"type\":\"%s/MsgUndelegate\",\"value\":{",
-                                 msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "{\"type\":\"");
+  tendermint_jsonWriteStr(&json, msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "/MsgUndelegate\",\"value\":{");
 
-  // 20 + ^20 + 11 + ^9 + 2 = ^62
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"amount\":{\"amount\":\"%" PRIu64
-                                 "\",\"denom\":\"%s\"}",
-                                 amount, denom);
+  tendermint_jsonWriteStr(&json, "\"amount\":{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  // 22
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"delegator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\",\"",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
+  tendermint_jsonWriteStr(&json, "\",\"");
 
-  // 20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "validator_address\":\"");
+  tendermint_jsonWriteStr(&json, "validator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_address);
+  tendermint_jsonWriteStr(&json, validator_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool tendermint_signTxUpdateMsgRedelegate(
     const uint64_t amount, const char *delegator_address,
     const char *validator_src_address, const char *validator_dst_address,
     const char *chainstr, const char *denom, const char *msgTypePrefix) {
-  char buffer[128];
-  size_t decoded_len;
-  char hrp[45];
-  uint8_t decoded[38];
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
@@ -312,56 +266,41 @@ bool tendermint_signTxUpdateMsgRedelegate(
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54];
-  if (!tendermint_getAddress(&node, chainstr, from_address)) {
+  const char *from_address = tendermint_cachedAddress(&addresses, chainstr);
+  if (!from_address) {
     return false;
   }
 
   if (has_message) {
-    sha256_Update(&ctx, (uint8_t *)",", 1);
+    tendermint_jsonWrite(&json, ",", 1);
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 28 = ^64
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "{\"type\":\"%s/MsgBeginRedelegate\",\"value\"", msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "{\"type\":\"");
+  tendermint_jsonWriteStr(&json, msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "/MsgBeginRedelegate\",\"value\"");
 
-  // 22 + ^20 + 11 + ^9 + 2 = ^64
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ":{\"amount\":{\"amount\":\"%" PRIu64
-                                 "\",\"denom\":\"%s\"}",
-                                 amount, denom);
+  tendermint_jsonWriteStr(&json, ":{\"amount\":{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}");
 
-  // 22
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, ",\"delegator_address\":\"");
 
-  // ^53 + 1 = ^54
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
 
-  // 27
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\",\"validator_dst_address\":\"");
+  tendermint_jsonWriteStr(&json, "\",\"validator_dst_address\":\"");
 
-  // ^53
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s",
-                                 validator_dst_address);
+  tendermint_jsonWriteStr(&json, validator_dst_address);
 
-  // 27
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\",\"validator_src_address\":\"");
+  tendermint_jsonWriteStr(&json, "\",\"validator_src_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_src_address);
+  tendermint_jsonWriteStr(&json, validator_src_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool tendermint_signTxUpdateMsgRewards(const uint64_t *amount,
@@ -369,12 +308,7 @@ bool tendermint_signTxUpdateMsgRewards(const uint64_t *amount,
                                        const char *validator_address,
                                        const char *chainstr, const char *denom,
                                        const char *msgTypePrefix) {
-  char buffer[128];
-  size_t decoded_len;
-  char hrp[45];
-  uint8_t decoded[38];
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, delegator_address)) {
+  if (!tendermint_cachedValidateAddress(&addresses, delegator_address)) {
     return false;
   }
 
@@ -383,51 +317,40 @@ bool tendermint_signTxUpdateMsgRewards(const uint64_t *amount,
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54];
-  if (!tendermint_getAddress(&node, chainstr, from_address)) {
+  const char *from_address = tendermint_cachedAddress(&addresses, chainstr);
+  if (!from_address) {
     return false;
   }
 
   if (has_message) {
-    sha256_Update(&ctx, (uint8_t *)",", 1);
+    tendermint_jsonWrite(&json, ",", 1);
   }
 
-  bool success = true;
+  tendermint_jsonWriteStr(&json, "{\"type\":\"");
+  tendermint_jsonWriteStr(&json, msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "/MsgWithdrawDelegationReward\",\"value\":{");
 
-  // 9 + ^24 + 38 = ^72
-  success &= tendermint_snprintf(
-      &ctx, buffer, sizeof(buffer),
-      "{\"type\":\"%s/MsgWithdrawDelegationReward\",\"value\":{",
-      msgTypePrefix);
-
-  // 20 + ^20 + 11 + ^9 + 3 = ^65
   if (amount != NULL) {
-    success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                   "\"amount\":{\"amount\":\"%" PRIu64
-                                   "\",\"denom\":\"%s\"},",
-                                   *amount, denom);
+    tendermint_jsonWriteStr(&json, "\"amount\":{\"amount\":\"");
+    tendermint_jsonWriteUint(&json, *amount);
+    tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+    tendermint_jsonWriteStr(&json, denom);
+    tendermint_jsonWriteStr(&json, "\"},");
   }
 
-  // 21
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"delegator_address\":\"");
+  tendermint_jsonWriteStr(&json, "\"delegator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\",\"",
-                                 delegator_address);
+  tendermint_jsonWriteStr(&json, delegator_address);
+  tendermint_jsonWriteStr(&json, "\",\"");
 
-  // 20
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "validator_address\":\"");
+  tendermint_jsonWriteStr(&json, "validator_address\":\"");
 
-  // ^53 + 3 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"}}",
-                                 validator_address);
+  tendermint_jsonWriteStr(&json, validator_address);
+  tendermint_jsonWriteStr(&json, "\"}}");
 
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 
 bool tendermint_signTxUpdateMsgIBCTransfer(
@@ -435,12 +358,7 @@ bool tendermint_signTxUpdateMsgIBCTransfer(
     const char *source_channel, const char *source_port,
     const char *revision_number, const char *revision_height,
     const char *chainstr, const char *denom, const char *msgTypePrefix) {
-  char buffer[128];
-  size_t decoded_len;
-  char hrp[45];
-  uint8_t decoded[38];
-
-  if (!bech32_decode(hrp, decoded, &decoded_len, receiver)) {
+  if (!tendermint_cachedValidateAddress(&addresses, receiver)) {
     return false;
   }
 
@@ -449,83 +367,80 @@ bool tendermint_signTxUpdateMsgIBCTransfer(
     return false;
   }
 
-  // ^14 + 39 + 1 = ^54
-  char from_address[54];
-  if (!tendermint_getAddress(&node, chainstr, from_address)) {
+  const char *from_address = tendermint_cachedAddress(&addresses, chainstr);
+  if (!from_address) {
     return false;
   }
 
   if (has_message) {
-    sha256_Update(&ctx, (uint8_t *)",", 1);
+    tendermint_jsonWrite(&json, ",", 1);
   }
 
-  bool success = true;
-
-  // 9 + ^24 + 23 = ^56
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "{\"type\":\"%s/MsgTransfer\",\"value\":{",
-                                 msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "{\"type\":\"");
+  tendermint_jsonWriteStr(&json, msgTypePrefix);
+  tendermint_jsonWriteStr(&json, "/MsgTransfer\",\"value\":{");
 
-  // 13
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "\"receiver\":\"");
+  tendermint_jsonWriteStr(&json, "\"receiver\":\"");
 
-  // ^53 + 1 = ^54
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"", receiver);
+  tendermint_jsonWriteStr(&json, receiver);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 11
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer), ",\"sender\":\"");
+  tendermint_jsonWriteStr(&json, ",\"sender\":\"");
 
-  // ^53 + 1 = ^54
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer), "%s\"", sender);
+  tendermint_jsonWriteStr(&json, sender);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 19 + ^32 + 1 = ^52
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"source_channel\":\"%s\"", source_channel);
+  tendermint_jsonWriteStr(&json, ",\"source_channel\":\"");
+  tendermint_jsonWriteStr(&json, source_channel);
+  tendermint_jsonWriteStr(&json, "\"");
 
-  // 16 + ^32 + 2 = ^40
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 ",\"source_port\":\"%s\",", source_port);
+  tendermint_jsonWriteStr(&json, ",\"source_port\":\"");
+  tendermint_jsonWriteStr(&json, source_port);
+  tendermint_jsonWriteStr(&json, "\",");
 
-  // 37 + ^16 = ^53
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"timeout_height\":{\"revision_height\":\"%s",
-                                 revision_height);
+  tendermint_jsonWriteStr(&json, "\"timeout_height\":{\"revision_height\":\"");
+  tendermint_jsonWriteStr(&json, revision_height);
 
-  // 21 + ^9 + 3 = ^33
-  success &=
-      tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                          "\",\"revision_number\":\"%s\"},", revision_number);
+  tendermint_jsonWriteStr(&json, "\",\"revision_number\":\"");
+  tendermint_jsonWriteStr(&json, revision_number);
+  tendermint_jsonWriteStr(&json, "\"},");
 
-  // 20 + ^20 + 11 + ^9 + 3 = ^63
-  success &= tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                                 "\"token\":{\"amount\":\"%" PRIu64
-                                 "\",\"denom\":\"%s\"}}}",
-                                 amount, denom);
+  tendermint_jsonWriteStr(&json, "\"token\":{\"amount\":\"");
+  tendermint_jsonWriteUint(&json, amount);
+  tendermint_jsonWriteStr(&json, "\",\"denom\":\"");
+  tendermint_jsonWriteStr(&json, denom);
+  tendermint_jsonWriteStr(&json, "\"}}}");
 
   has_message = true;
   msgs_remaining--;
-  return success;
+  return true;
 }
 
-bool tendermint_signTxFinalize(uint8_t *public_key, uint8_t *signature) {
-  char buffer[128];
+/// Closes the sign doc. No messages can be added afterwards.
+static void tendermint_signTxDigest(void) {
+  if (has_digest) return;
 
-  // 14 + ^20 + 2 = ^36
-  if (!tendermint_snprintf(&ctx, buffer, sizeof(buffer),
-                           "],\"sequence\":\"%" PRIu64 "\"}", tmsg.sequence)) {
-    return false;
-  }
+  tendermint_jsonWriteStr(&json, "],\"sequence\":\"");
+  tendermint_jsonWriteUint(&json, tmsg.sequence);
+  tendermint_jsonWriteStr(&json, "\"}");
+
+  tendermint_jsonFinal(&json, digest);
+  has_digest = true;
+}
+
+void tendermint_signTxPresign(void) {
+  tendermint_signTxDigest();
+  cryptoPresignDigest(&secp256k1, node.private_key, digest, NULL);
+}
+
+bool tendermint_signTxFinalize(uint8_t *public_key, uint8_t *signature) {
+  tendermint_signTxDigest();
 
   hdnode_fill_public_key(&node);
   memcpy(public_key, node.public_key, 33);
 
-  uint8_t hash[SHA256_DIGEST_LENGTH];
-  sha256_Final(&ctx, hash);
-  return ecdsa_sign_digest(&secp256k1, node.private_key, hash, signature, NULL,
-                           NULL) == 0;
+  return cryptoSignDigest(&secp256k1, node.private_key, digest, signature,
+                          NULL, NULL) == 0;
 }
 
 bool tendermint_signingIsInited(void) { return initialized; }
@@ -536,6 +451,10 @@ void tendermint_signAbort(void) {
   initialized = false;
   has_message = false;
   msgs_remaining = 0;
+  has_digest = false;
+  cryptoPresignClear();
+  memzero(digest, sizeof(digest));
   memzero(&tmsg, sizeof(tmsg));
   memzero(&node, sizeof(node));
+  memzero(&addresses, sizeof(addresses));
 }
\ No newline at end of file
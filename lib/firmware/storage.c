@@ -42,9 +42,12 @@
 #include "keepkey/board/memory.h"
 #include "keepkey/board/util.h"
 #include "keepkey/board/variant.h"
+#include "keepkey/firmware/crypto.h"
 #include "keepkey/firmware/fsm.h"
+#include "keepkey/firmware/nano.h"
 #include "keepkey/firmware/passphrase_sm.h"
 #include "keepkey/firmware/policy.h"
+#include "keepkey/firmware/signing.h"
 #include "keepkey/firmware/u2f.h"
 #include "keepkey/rand/rng.h"
 #include "keepkey/transport/interface.h"
@@ -1376,6 +1379,9 @@ void storage_clearKeys(void) {
 }
 
 void session_clear(bool clear_pin) {
+  signing_utxoCacheClear();
+  cryptoPresignClear();
+  nano_clearCache();
   if (PIN_REWRAP ==
       session_clear_impl(&session, &shadow_config.storage, clear_pin)) {
     storage_commit();
@@ -1950,6 +1956,11 @@ void session_cachePassphrase(const char *passphrase) {
 
 bool session_isPassphraseCached(void) { return session.passphraseCached; }
 
+bool session_isSeedCached(void) {
+  return session.seedCached &&
+         (!storage_getPassphraseProtected() || session.passphraseCached);
+}
+
 void storage_setMnemonicFromWords(const char (*words)[12],
                                   unsigned int word_count) {
   strlcpy(shadow_config.storage.sec.mnemonic, words[0],
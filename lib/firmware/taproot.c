@@ -0,0 +1,158 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2024 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/taproot.h"
+
+#include "trezor/crypto/bignum.h"
+#include "trezor/crypto/ecdsa.h"
+#include "trezor/crypto/memzero.h"
+#include "trezor/crypto/secp256k1.h"
+
+#include <string.h>
+
+void taproot_taggedHashInit(SHA256_CTX *ctx, const char *tag) {
+  uint8_t tag_hash[SHA256_DIGEST_LENGTH];
+  sha256_Raw((const uint8_t *)tag, strlen(tag), tag_hash);
+  sha256_Init(ctx);
+  sha256_Update(ctx, tag_hash, sizeof(tag_hash));
+  sha256_Update(ctx, tag_hash, sizeof(tag_hash));
+}
+
+/// Reads tagged_hash(tag, data) as a scalar. Fails for the (negligibly
+/// unlikely) values that are not below the group order.
+static bool taproot_taggedScalar(const char *tag, const uint8_t *data,
+                                 size_t len, bignum256 *out) {
+  SHA256_CTX ctx;
+  uint8_t hash[SHA256_DIGEST_LENGTH];
+  taproot_taggedHashInit(&ctx, tag);
+  sha256_Update(&ctx, data, len);
+  sha256_Final(&ctx, hash);
+  bn_read_be(hash, out);
+  return bn_is_less(out, &secp256k1.order);
+}
+
+bool taproot_tweakPublicKey(const uint8_t *public_key, uint8_t *output_key) {
+  curve_point point, tweak_point;
+  bignum256 tweak;
+  if (public_key[0] != 0x02 && public_key[0] != 0x03) return false;
+  if (!ecdsa_read_pubkey(&secp256k1, public_key, &point)) return false;
+  if (!taproot_taggedScalar("TapTweak", public_key + 1, 32, &tweak)) {
+    return false;
+  }
+
+  // The internal key is used x-only, i.e. with even y
+  if (bn_is_odd(&point.y)) {
+    bn_subtract(&secp256k1.prime, &point.y, &point.y);
+  }
+
+  scalar_multiply(&secp256k1, &tweak, &tweak_point);
+  point_add(&secp256k1, &point, &tweak_point);
+  if (point_is_infinity(&tweak_point)) return false;
+
+  bn_write_be(&tweak_point.x, output_key);
+  return true;
+}
+
+/// Reads a private key, negated if needed so that its point has even y.
+static bool taproot_readEvenKey(const uint8_t *private_key, bignum256 *key,
+                                uint8_t *x_only) {
+  curve_point point;
+  bn_read_be(private_key, key);
+  if (bn_is_zero(key) || !bn_is_less(key, &secp256k1.order)) return false;
+
+  scalar_multiply(&secp256k1, key, &point);
+  if (bn_is_odd(&point.y)) {
+    bn_subtract(&secp256k1.order, key, key);
+  }
+  bn_write_be(&point.x, x_only);
+  return true;
+}
+
+bool taproot_tweakPrivateKey(const uint8_t *private_key, uint8_t *tweaked) {
+  bignum256 key, tweak;
+  uint8_t x_only[32];
+  bool ok = taproot_readEvenKey(private_key, &key, x_only) &&
+            taproot_taggedScalar("TapTweak", x_only, sizeof(x_only), &tweak);
+  if (ok) {
+    bn_addmod(&key, &tweak, &secp256k1.order);
+    bn_mod(&key, &secp256k1.order);
+    ok = !bn_is_zero(&key);
+    bn_write_be(&key, tweaked);
+  }
+  memzero(&key, sizeof(key));
+  return ok;
+}
+
+bool taproot_schnorrSign(const uint8_t *private_key, const uint8_t *digest,
+                         const uint8_t *aux, uint8_t *sig) {
+  SHA256_CTX ctx;
+  bignum256 key, nonce, challenge;
+  curve_point nonce_point;
+  uint8_t public_key[32], nonce_input[32], hash[SHA256_DIGEST_LENGTH];
+  bool ok = false;
+
+  if (!taproot_readEvenKey(private_key, &key, public_key)) goto cleanup;
+
+  // t = key xor tagged_hash("BIP0340/aux", aux)
+  taproot_taggedHashInit(&ctx, "BIP0340/aux");
+  sha256_Update(&ctx, aux, 32);
+  sha256_Final(&ctx, hash);
+  bn_write_be(&key, nonce_input);
+  for (size_t i = 0; i < sizeof(nonce_input); i++) {
+    nonce_input[i] ^= hash[i];
+  }
+
+  taproot_taggedHashInit(&ctx, "BIP0340/nonce");
+  sha256_Update(&ctx, nonce_input, sizeof(nonce_input));
+  sha256_Update(&ctx, public_key, sizeof(public_key));
+  sha256_Update(&ctx, digest, 32);
+  sha256_Final(&ctx, hash);
+  bn_read_be(hash, &nonce);
+  bn_mod(&nonce, &secp256k1.order);
+  if (bn_is_zero(&nonce)) goto cleanup;
+
+  scalar_multiply(&secp256k1, &nonce, &nonce_point);
+  if (bn_is_odd(&nonce_point.y)) {
+    bn_subtract(&secp256k1.order, &nonce, &nonce);
+  }
+  bn_write_be(&nonce_point.x, sig);
+
+  taproot_taggedHashInit(&ctx, "BIP0340/challenge");
+  sha256_Update(&ctx, sig, 32);
+  sha256_Update(&ctx, public_key, sizeof(public_key));
+  sha256_Update(&ctx, digest, 32);
+  sha256_Final(&ctx, hash);
+  bn_read_be(hash, &challenge);
+  bn_mod(&challenge, &secp256k1.order);
+
+  // s = nonce + challenge * key
+  bn_multiply(&key, &challenge, &secp256k1.order);
+  bn_mod(&challenge, &secp256k1.order);
+  bn_addmod(&challenge, &nonce, &secp256k1.order);
+  bn_mod(&challenge, &secp256k1.order);
+  bn_write_be(&challenge, sig + 32);
+  ok = true;
+
+cleanup:
+  memzero(&key, sizeof(key));
+  memzero(&nonce, sizeof(nonce));
+  memzero(nonce_input, sizeof(nonce_input));
+  memzero(&ctx, sizeof(ctx));
+  return ok;
+}
@@ -1,11 +1,11 @@
 #include "keepkey/firmware/tendermint.h"
 
 #include "keepkey/firmware/fsm.h"
+#include "trezor/crypto/memzero.h"
 #include "trezor/crypto/segwit_addr.h"
 #include "trezor/crypto/sha2.h"
 
-#include <stdarg.h>
-#include <stdio.h>
+#include <string.h>
 
 static int convert_bits(uint8_t* out, size_t* outlen, int outbits, const uint8_t* in, size_t inlen, int inbits, int pad) {
     uint32_t val = 0;
@@ -43,6 +43,14 @@ bool tendermint_pathMismatched(const CoinType *coin, const uint32_t *address_n,
   return mismatch;
 }
 
+static bool encode_address(const uint8_t hash160[RIPEMD160_DIGEST_LENGTH],
+                           const char *prefix, char *address) {
+  uint8_t fiveBitExpanded[RIPEMD160_DIGEST_LENGTH * 8 / 5];
+  size_t len = 0;
+  convert_bits(fiveBitExpanded, &len, 5, hash160, 20, 8, 1);
+  return bech32_encode(address, prefix, fiveBitExpanded, len, BECH32_ENCODING_BECH32) == 1;
+}
+
 /**
  * Gets the address
  *
@@ -56,40 +64,208 @@ bool tendermint_getAddress(const HDNode *node, const char *prefix,
                            char *address) {
   uint8_t hash160Buf[RIPEMD160_DIGEST_LENGTH];
   ecdsa_get_pubkeyhash(node->public_key, HASHER_SHA2_RIPEMD, hash160Buf);
+  return encode_address(hash160Buf, prefix, address);
+}
 
-  uint8_t fiveBitExpanded[RIPEMD160_DIGEST_LENGTH * 8 / 5];
-  size_t len = 0;
-  convert_bits(fiveBitExpanded, &len, 5, hash160Buf, 20, 8, 1);
-  return bech32_encode(address, prefix, fiveBitExpanded, len, BECH32_ENCODING_BECH32) == 1;
+void tendermint_addressCacheInit(TendermintAddressCache *cache,
+                                 const HDNode *node) {
+  memzero(cache, sizeof(*cache));
+  ecdsa_get_pubkeyhash(node->public_key, HASHER_SHA2_RIPEMD, cache->hash160);
 }
 
-void tendermint_sha256UpdateEscaped(SHA256_CTX *ctx, const char *s,
-                                    size_t len) {
-  for (size_t i = 0; i != len; i++) {
-    if (s[i] == '"') {
-      sha256_Update(ctx, (const uint8_t *)"\\\"", 2);
-    } else if (s[i] == '\\') {
-      sha256_Update(ctx, (const uint8_t *)"\\\\", 2);
-    } else {
-      // The copy here is required (as opposed to a cast), since the
-      // source is a character array, and sha256_Update uses it as if it
-      // were an array of uint8_t, which would violate the strict aliasing
-      // rule.
-      const uint8_t c = s[i];
-      sha256_Update(ctx, &c, 1);
+const char *tendermint_cachedAddress(TendermintAddressCache *cache,
+                                     const char *prefix) {
+  if (cache->has_address && strcmp(cache->prefix, prefix) == 0) {
+    return cache->address;
+  }
+
+  cache->has_address = false;
+  if (strlen(prefix) >= sizeof(cache->prefix)) {
+    return NULL;
+  }
+
+  if (!encode_address(cache->hash160, prefix, cache->address)) {
+    return NULL;
+  }
+
+  strlcpy(cache->prefix, prefix, sizeof(cache->prefix));
+  cache->has_address = true;
+  return cache->address;
+}
+
+bool tendermint_cachedValidateAddress(TendermintAddressCache *cache,
+                                      const char *address) {
+  for (size_t i = 0; i < TENDERMINT_VALIDATED_ADDRESSES; i++) {
+    if (cache->validated[i][0] != '\0' &&
+        strncmp(cache->validated[i], address, TENDERMINT_ADDRESS_MAX) == 0) {
+      return true;
+    }
+  }
+
+  size_t decoded_len;
+  char hrp[TENDERMINT_ADDRESS_MAX];
+  uint8_t decoded[TENDERMINT_ADDRESS_MAX];
+  if (!bech32_decode(hrp, decoded, &decoded_len, address)) {
+    return false;
+  }
+
+  // bech32_decode rejects anything longer than 90 characters, so this fits.
+  strlcpy(cache->validated[cache->next_validated], address,
+          TENDERMINT_ADDRESS_MAX);
+  cache->next_validated =
+      (cache->next_validated + 1) % TENDERMINT_VALIDATED_ADDRESSES;
+  return true;
+}
+
+const TendermintMsgHandler *tendermint_findMsgHandler(
+    const TendermintMsgRegistry *registry, const void *ack) {
+  for (size_t i = 0; i < registry->handler_count; i++) {
+    const TendermintMsgHandler *handler = &registry->handlers[i];
+    if (*(const bool *)((const uint8_t *)ack + handler->has_offset)) {
+      return handler;
+    }
+  }
+  return NULL;
+}
+
+bool tendermint_parseUint(const char *str, uint64_t *value) {
+  if (*str == '\0') {
+    return false;
+  }
+
+  uint64_t result = 0;
+  for (; *str; str++) {
+    if (*str < '0' || *str > '9') {
+      return false;
+    }
+    uint64_t digit = *str - '0';
+    if (result > (UINT64_MAX - digit) / 10) {
+      return false;
+    }
+    result = result * 10 + digit;
+  }
+
+  *value = result;
+  return true;
+}
+
+void tendermint_summaryInit(TendermintSummary *summary) {
+  memzero(summary, sizeof(*summary));
+}
+
+bool tendermint_summaryAddAmount(TendermintSummary *summary,
+                                 const char *action, const char *denom,
+                                 uint8_t decimals, const char *symbol,
+                                 uint64_t amount) {
+  for (size_t i = 0; i < summary->total_count; i++) {
+    TendermintSummaryTotal *total = &summary->totals[i];
+    if (strcmp(total->action, action) == 0 &&
+        strcmp(total->denom, denom) == 0) {
+      if (total->amount > UINT64_MAX - amount) {
+        return false;
+      }
+      total->amount += amount;
+      return true;
     }
   }
+
+  if (summary->total_count == TENDERMINT_SUMMARY_TOTALS ||
+      strlen(denom) >= sizeof(summary->totals[0].denom)) {
+    return false;
+  }
+
+  TendermintSummaryTotal *total = &summary->totals[summary->total_count++];
+  total->action = action;
+  strlcpy(total->denom, denom, sizeof(total->denom));
+  total->decimals = decimals;
+  total->symbol = symbol;
+  total->amount = amount;
+  return true;
 }
 
-bool tendermint_snprintf(SHA256_CTX *ctx, char *temp, size_t len,
-                         const char *format, ...) {
-  va_list vl;
-  va_start(vl, format);
-  int n = vsnprintf(temp, len, format, vl);
-  va_end(vl);
+bool tendermint_summaryAddValidator(TendermintSummary *summary,
+                                    const char *address) {
+  for (size_t i = 0; i < summary->validator_count; i++) {
+    if (strcmp(summary->validators[i], address) == 0) {
+      return true;
+    }
+  }
 
-  if (n < 0 || (size_t)n >= len) return false;
+  if (summary->validator_count == TENDERMINT_SUMMARY_VALIDATORS ||
+      strlen(address) >= sizeof(summary->validators[0])) {
+    return false;
+  }
 
-  sha256_Update(ctx, (const uint8_t *)temp, n);
+  strlcpy(summary->validators[summary->validator_count++], address,
+          sizeof(summary->validators[0]));
   return true;
 }
+
+void tendermint_jsonInit(TendermintJsonHasher *w) {
+  sha256_Init(&w->ctx);
+  w->len = 0;
+}
+
+/* Stages len bytes, handing SHA-256 only whole blocks. */
+void tendermint_jsonWrite(TendermintJsonHasher *w, const char *s,
+                          size_t len) {
+  while (len != 0) {
+    if (w->len == 0 && len >= SHA256_BLOCK_LENGTH) {
+      // Nothing staged, so whole blocks can be hashed straight from the source.
+      size_t n = len - len % SHA256_BLOCK_LENGTH;
+      sha256_Update(&w->ctx, (const uint8_t *)s, n);
+      s += n;
+      len -= n;
+      continue;
+    }
+
+    size_t n = SHA256_BLOCK_LENGTH - w->len;
+    if (n > len) n = len;
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+    s += n;
+    len -= n;
+
+    if (w->len == SHA256_BLOCK_LENGTH) {
+      sha256_Update(&w->ctx, w->buf, SHA256_BLOCK_LENGTH);
+      w->len = 0;
+    }
+  }
+}
+
+void tendermint_jsonWriteStr(TendermintJsonHasher *w, const char *s) {
+  tendermint_jsonWrite(w, s, strlen(s));
+}
+
+void tendermint_jsonWriteEscaped(TendermintJsonHasher *w, const char *s,
+                                 size_t len) {
+  size_t run = 0;
+  for (size_t i = 0; i != len; i++) {
+    if (s[i] == '"' || s[i] == '\\') {
+      // Flush the unescaped run in one go, then the escape pair.
+      tendermint_jsonWrite(w, s + run, i - run);
+      const char esc[2] = {'\\', s[i]};
+      tendermint_jsonWrite(w, esc, sizeof(esc));
+      run = i + 1;
+    }
+  }
+  tendermint_jsonWrite(w, s + run, len - run);
+}
+
+void tendermint_jsonWriteUint(TendermintJsonHasher *w, uint64_t value) {
+  // UINT64_MAX has 20 decimal digits
+  char digits[20];
+  size_t pos = sizeof(digits);
+  do {
+    digits[--pos] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  tendermint_jsonWrite(w, digits + pos, sizeof(digits) - pos);
+}
+
+void tendermint_jsonFinal(TendermintJsonHasher *w,
+                          uint8_t hash[SHA256_DIGEST_LENGTH]) {
+  sha256_Update(&w->ctx, w->buf, w->len);
+  sha256_Final(&w->ctx, hash);
+  memzero(w, sizeof(*w));
+}
@@ -0,0 +1,295 @@
+/*
+ * This file is part of the Keepkey project.
+ *
+ * Copyright (C) 2021 Shapeshift
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/thorchain_memo.h"
+
+#include "keepkey/board/confirm_sm.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MEMO_FIELDS_MAX 6
+/* Longer memos are not parsed, so callers show them raw instead */
+#define MEMO_SIZE_MAX 256
+
+/* Withdrawals are in basis points */
+#define MEMO_BASIS_POINTS_MAX 10000
+
+typedef struct {
+  const char *keyword;
+  ThorchainMemoAction action;
+  size_t fields_max;  // fields the confirm screens can show, keyword included
+} MemoKeyword;
+
+static const MemoKeyword keywords[] = {
+    {"SWAP", ThorchainMemo_Swap, 6},
+    {"s", ThorchainMemo_Swap, 6},
+    {"=", ThorchainMemo_Swap, 6},
+    {"ADD", ThorchainMemo_Add, 5},
+    {"a", ThorchainMemo_Add, 5},
+    {"+", ThorchainMemo_Add, 5},
+    {"WITHDRAW", ThorchainMemo_Withdraw, 4},
+    {"wd", ThorchainMemo_Withdraw, 4},
+    {"-", ThorchainMemo_Withdraw, 4},
+    {"LOAN+", ThorchainMemo_LoanOpen, 6},
+    {"$+", ThorchainMemo_LoanOpen, 6},
+    {"LOAN-", ThorchainMemo_LoanRepay, 4},
+    {"$-", ThorchainMemo_LoanRepay, 4},
+};
+
+static bool view_equalsKeyword(MemoView view, const char *keyword) {
+  size_t len = strlen(keyword);
+  if (view.len != len) return false;
+  for (size_t i = 0; i < len; i++) {
+    char c = view.ptr[i];
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    char k = keyword[i];
+    if (k >= 'a' && k <= 'z') k -= 'a' - 'A';
+    if (c != k) return false;
+  }
+  return true;
+}
+
+/// Reads \p view as a decimal number.
+/// \returns false unless it is all digits and fits in a uint32_t
+static bool view_toUint(MemoView view, uint32_t *value) {
+  if (view.len == 0) return false;
+  *value = 0;
+  for (size_t i = 0; i < view.len; i++) {
+    if (view.ptr[i] < '0' || view.ptr[i] > '9') return false;
+    uint32_t digit = view.ptr[i] - '0';
+    if (*value > (UINT32_MAX - digit) / 10) return false;
+    *value = *value * 10 + digit;
+  }
+  return true;
+}
+
+static bool view_contains(MemoView view, char c) {
+  return memchr(view.ptr, c, view.len) != NULL;
+}
+
+/// Splits \p view at the first occurrence of any of \p seps. The separator
+/// itself belongs to neither half.
+static bool view_split(MemoView view, const char *seps, MemoView *head,
+                       MemoView *tail) {
+  for (size_t i = 0; i < view.len; i++) {
+    if (strchr(seps, view.ptr[i])) {
+      head->ptr = view.ptr;
+      head->len = i;
+      tail->ptr = view.ptr + i + 1;
+      tail->len = view.len - i - 1;
+      return true;
+    }
+  }
+  *head = view;
+  tail->ptr = view.ptr + view.len;
+  tail->len = 0;
+  return false;
+}
+
+bool thorchain_memoParse(const char *memo, size_t size, ThorchainMemo *out) {
+  memset(out, 0, sizeof(*out));
+
+  MemoView fields[MEMO_FIELDS_MAX];
+  size_t count = 0;
+  size_t start = 0;
+  size_t i = 0;
+  for (; i < size && memo[i] != '\0'; i++) {
+    if (i == MEMO_SIZE_MAX) return false;  // memo[MEMO_SIZE_MAX] is not NUL
+    if (memo[i] != ':') continue;
+    if (count < MEMO_FIELDS_MAX) {
+      fields[count].ptr = memo + start;
+      fields[count].len = i - start;
+    }
+    count++;
+    start = i + 1;
+  }
+  if (count < MEMO_FIELDS_MAX) {
+    fields[count].ptr = memo + start;
+    fields[count].len = i - start;
+  }
+  count++;
+
+  // Fields the memo leaves out are empty views at its end.
+  for (size_t f = count; f < MEMO_FIELDS_MAX; f++) {
+    fields[f].ptr = memo + i;
+    fields[f].len = 0;
+  }
+
+  size_t k = 0;
+  for (; k < sizeof(keywords) / sizeof(keywords[0]); k++) {
+    if (view_equalsKeyword(fields[0], keywords[k].keyword)) break;
+  }
+  if (k == sizeof(keywords) / sizeof(keywords[0])) return false;
+  out->action = keywords[k].action;
+
+  // Anything the confirm screens would not show means the raw memo has to
+  // be confirmed instead.
+  if (count > keywords[k].fields_max) return false;
+
+  // CHAIN.SYMBOL, or the synth (/) and trade (~) asset notations
+  if (!view_split(fields[1], "./~", &out->chain, &out->asset) ||
+      out->chain.len == 0 || out->asset.len == 0) {
+    return false;
+  }
+
+  switch (out->action) {
+    case ThorchainMemo_Swap: {
+      out->dest = fields[2];
+      MemoView rest;
+      view_split(fields[3], "/", &out->limit, &rest);
+      view_split(rest, "/", &out->interval, &out->quantity);
+      out->affiliate = fields[4];
+      out->fee = fields[5];
+      return !view_contains(out->quantity, '/') &&
+             (out->fee.len == 0 || out->affiliate.len != 0);
+    }
+    case ThorchainMemo_Add:
+      out->dest = fields[2];
+      out->affiliate = fields[3];
+      out->fee = fields[4];
+      return out->fee.len == 0 || out->affiliate.len != 0;
+    case ThorchainMemo_Withdraw: {
+      out->limit = fields[2];
+      out->withdraw_asset = fields[3];
+      uint32_t basis_points;
+      return view_toUint(out->limit, &basis_points) &&
+             basis_points <= MEMO_BASIS_POINTS_MAX;
+    }
+    case ThorchainMemo_LoanOpen:
+      out->dest = fields[2];
+      out->limit = fields[3];
+      out->affiliate = fields[4];
+      out->fee = fields[5];
+      return out->fee.len == 0 || out->affiliate.len != 0;
+    case ThorchainMemo_LoanRepay:
+      out->dest = fields[2];
+      out->limit = fields[3];
+      return out->dest.len != 0;
+  }
+
+  return false;
+}
+
+#define VIEW_ARG(view) (int)(view).len, (view).ptr
+#define VIEW_OR(view, fallback) \
+  (view).len ? (int)(view).len : (int)strlen(fallback), \
+      (view).len ? (view).ptr : (fallback)
+
+static bool confirm_affiliate(const ThorchainMemo *memo, const char *title) {
+  if (memo->affiliate.len == 0) return true;
+  return confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                 "Confirm affiliate %.*s fee %.*s bps",
+                 VIEW_ARG(memo->affiliate), VIEW_OR(memo->fee, "0"));
+}
+
+bool thorchain_memoConfirm(const ThorchainMemo *memo, const char *network) {
+  char title[40];
+
+  switch (memo->action) {
+    case ThorchainMemo_Swap:
+      snprintf(title, sizeof(title), "%s swap", network);
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm swap asset %.*s\n on chain %.*s",
+                   VIEW_ARG(memo->asset), VIEW_ARG(memo->chain))) {
+        return false;
+      }
+      // A blank destination means swap to self
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm to %.*s", VIEW_OR(memo->dest, "self"))) {
+        return false;
+      }
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm limit %.*s", VIEW_OR(memo->limit, "none"))) {
+        return false;
+      }
+      if ((memo->interval.len || memo->quantity.len) &&
+          !confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm streaming swap every %.*s blocks, %.*s sub-swaps",
+                   VIEW_OR(memo->interval, "1"),
+                   VIEW_OR(memo->quantity, "0"))) {
+        return false;
+      }
+      return confirm_affiliate(memo, title);
+
+    case ThorchainMemo_Add:
+      snprintf(title, sizeof(title), "%s add liquidity", network);
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm add asset %.*s\n on chain %.*s pool",
+                   VIEW_ARG(memo->asset), VIEW_ARG(memo->chain))) {
+        return false;
+      }
+      if (memo->dest.len &&
+          !confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm to %.*s", VIEW_ARG(memo->dest))) {
+        return false;
+      }
+      return confirm_affiliate(memo, title);
+
+    case ThorchainMemo_Withdraw: {
+      snprintf(title, sizeof(title), "%s withdraw liquidity", network);
+      uint32_t basis_points;
+      if (!view_toUint(memo->limit, &basis_points)) return false;
+      float percent = (float)basis_points / 100;
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm withdraw %3.2f%% of asset %.*s on chain %.*s",
+                   percent, VIEW_ARG(memo->asset), VIEW_ARG(memo->chain))) {
+        return false;
+      }
+      return memo->withdraw_asset.len == 0 ||
+             confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                     "Confirm withdraw as %.*s",
+                     VIEW_ARG(memo->withdraw_asset));
+    }
+
+    case ThorchainMemo_LoanOpen:
+      snprintf(title, sizeof(title), "%s open loan", network);
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm borrow asset %.*s\n on chain %.*s",
+                   VIEW_ARG(memo->asset), VIEW_ARG(memo->chain))) {
+        return false;
+      }
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm to %.*s", VIEW_OR(memo->dest, "self"))) {
+        return false;
+      }
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm minimum out %.*s", VIEW_OR(memo->limit, "none"))) {
+        return false;
+      }
+      return confirm_affiliate(memo, title);
+
+    case ThorchainMemo_LoanRepay:
+      snprintf(title, sizeof(title), "%s repay loan", network);
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm repay loan on collateral %.*s\n on chain %.*s",
+                   VIEW_ARG(memo->asset), VIEW_ARG(memo->chain))) {
+        return false;
+      }
+      if (!confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                   "Confirm collateral owner %.*s", VIEW_ARG(memo->dest))) {
+        return false;
+      }
+      return confirm(ButtonRequestType_ButtonRequest_ConfirmOutput, title,
+                     "Confirm minimum out %.*s", VIEW_OR(memo->limit, "none"));
+  }
+
+  return false;
+}
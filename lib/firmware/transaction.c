@@ -636,6 +636,12 @@ uint32_t tx_serialize_header(TxStruct *tx, uint8_t *out) {
     memcpy(out, &ver, 4);
     memcpy(out + 4, &(tx->version_group_id), 4);
     r += 4;
+    if (tx->version == 5) {
+      memcpy(out + r, &(tx->branch_id), 4);
+      memcpy(out + r + 4, &(tx->lock_time), 4);
+      memcpy(out + r + 8, &(tx->expiry), 4);
+      r += 12;
+    }
   } else {
     memcpy(out, &(tx->version), 4);
     if (tx->is_segwit) {
@@ -795,6 +801,12 @@ uint32_t tx_serialize_footer(TxStruct *tx, uint8_t *out) {
       out[17] = 0x00;         // nShieldedOutput
       out[18] = 0x00;         // nJoinSplit
       return 19;
+    } else if (tx->version == 5) {
+      // nLockTime and nExpiryHeight are in the header
+      out[0] = 0x00;  // nSpendsSapling
+      out[1] = 0x00;  // nOutputsSapling
+      out[2] = 0x00;  // nActionsOrchard
+      return 3;
     }
   }
   if (tx->is_decred) {
@@ -959,6 +971,9 @@ uint32_t tx_input_weight(const CoinType *coin, const TxInputType *txinput) {
       weight += 4;  // empty input script
     }
     weight += input_script_size;  // discounted witness
+  } else if (txinput->script_type == InputScriptType_SPENDTAPROOT) {
+    weight += 4;  // empty input script
+    weight += 1 + 1 + TXSIZE_SCHNORR_SIGNATURE;  // discounted witness
   }
   return weight;
 }
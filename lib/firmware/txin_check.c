@@ -84,12 +84,13 @@ void txin_dgst_getstrs(char *prev, char *cur, size_t len) {
   return;
 }
 
-// save last state and reset for next tx request
+// save last state and reset for next tx request. The inputs digest is
+// finalized once per tx, so it is kept for the remaining outputs of the tx
+// and replaced when the next tx is finalized.
 void txin_dgst_save_and_reset(char *amt_str, char *addr_str) {
   memcpy(txin_last_digest, txin_current_digest, SHA256_DIGEST_LENGTH);
   memcpy(last_amount_str, amt_str, AMT_STR_LEN);
   memcpy(last_addr_str, addr_str, ADDR_STR_LEN);
-  memzero(txin_current_digest, SHA256_DIGEST_LENGTH);
   sha256_Init(&txin_hash_ctx);
   return;
 }
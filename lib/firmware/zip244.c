@@ -0,0 +1,95 @@
+/*
+ * This file is part of the KeepKey project.
+ *
+ * Copyright (C) 2024 KeepKey
+ *
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keepkey/firmware/zip244.h"
+
+#include "keepkey/firmware/transaction.h"
+
+#include <string.h>
+
+void zip244_init(Zip244 *zip244, uint32_t version, uint32_t version_group_id,
+                 uint32_t branch_id, uint32_t lock_time, uint32_t expiry) {
+  uint8_t hash_header[32];
+  uint32_t ver = version | TX_OVERWINTERED;
+  Hasher hasher;
+  hasher_InitParam(&hasher, HASHER_BLAKE2B_PERSONAL, "ZTxIdHeadersHash", 16);
+  hasher_Update(&hasher, (const uint8_t *)&ver, 4);
+  hasher_Update(&hasher, (const uint8_t *)&version_group_id, 4);
+  hasher_Update(&hasher, (const uint8_t *)&branch_id, 4);
+  hasher_Update(&hasher, (const uint8_t *)&lock_time, 4);
+  hasher_Update(&hasher, (const uint8_t *)&expiry, 4);
+  hasher_Final(&hasher, hash_header);
+
+  uint8_t personal[16];
+  memcpy(personal, "ZcashTxHash_", 12);
+  memcpy(personal + 12, &branch_id, 4);
+  hasher_InitParam(&zip244->sig, HASHER_BLAKE2B_PERSONAL, personal,
+                   sizeof(personal));
+  hasher_Update(&zip244->sig, hash_header, 32);
+
+  // No shielded spends, outputs or actions: digests of empty input
+  hasher_InitParam(&hasher, HASHER_BLAKE2B_PERSONAL, "ZTxIdSaplingHash", 16);
+  hasher_Final(&hasher, zip244->sapling);
+  hasher_InitParam(&hasher, HASHER_BLAKE2B_PERSONAL, "ZTxIdOrchardHash", 16);
+  hasher_Final(&hasher, zip244->orchard);
+}
+
+void zip244_transparent(Zip244 *zip244, uint8_t hash_type,
+                        const uint8_t prevouts[32], const uint8_t amounts[32],
+                        const uint8_t scriptpubkeys[32],
+                        const uint8_t sequences[32],
+                        const uint8_t outputs[32]) {
+  hasher_InitParam(&zip244->transparent, HASHER_BLAKE2B_PERSONAL,
+                   "ZTxIdTranspaHash", 16);
+  hasher_Update(&zip244->transparent, &hash_type, 1);
+  hasher_Update(&zip244->transparent, prevouts, 32);
+  hasher_Update(&zip244->transparent, amounts, 32);
+  hasher_Update(&zip244->transparent, scriptpubkeys, 32);
+  hasher_Update(&zip244->transparent, sequences, 32);
+  hasher_Update(&zip244->transparent, outputs, 32);
+}
+
+void zip244_txin(const uint8_t prev_hash[32], uint32_t prev_index,
+                 uint64_t amount, const uint8_t *script_pubkey,
+                 uint32_t script_pubkey_len, uint32_t sequence,
+                 uint8_t hash[32]) {
+  Hasher hasher;
+  hasher_InitParam(&hasher, HASHER_BLAKE2B_PERSONAL, "Zcash___TxInHash", 16);
+  hasher_Update(&hasher, prev_hash, 32);
+  hasher_Update(&hasher, (const uint8_t *)&prev_index, 4);
+  hasher_Update(&hasher, (const uint8_t *)&amount, 8);
+  hasher_Update(&hasher, script_pubkey, script_pubkey_len);
+  hasher_Update(&hasher, (const uint8_t *)&sequence, 4);
+  hasher_Final(&hasher, hash);
+}
+
+void zip244_sigDigest(const Zip244 *zip244, const uint8_t txin[32],
+                      uint8_t hash[32]) {
+  uint8_t hash_transparent[32];
+  Hasher hasher;
+  memcpy(&hasher, &zip244->transparent, sizeof(hasher));
+  hasher_Update(&hasher, txin, 32);
+  hasher_Final(&hasher, hash_transparent);
+
+  memcpy(&hasher, &zip244->sig, sizeof(hasher));
+  hasher_Update(&hasher, hash_transparent, 32);
+  hasher_Update(&hasher, zip244->sapling, 32);
+  hasher_Update(&hasher, zip244->orchard, 32);
+  hasher_Final(&hasher, hash);
+}
@@ -1,6 +1,6 @@
 #!/bin/sh
 
 mkdir -p /kkemu/test-reports/firmware-unit
-make xunit
+ctest -j"$(nproc)" --output-on-failure
 echo "$?" > /kkemu/test-reports/firmware-unit/status
 cp -r unittests/*.xml /kkemu/test-reports/firmware-unit
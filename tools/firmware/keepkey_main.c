@@ -22,6 +22,7 @@
 #include <stdbool.h>
 #include <libopencm3/cm3/cortex.h>
 #include <libopencm3/stm32/desig.h>
+#include <libopencm3/stm32/flash.h>
 #endif
 
 #include "keepkey/board/common.h"
@@ -178,6 +179,13 @@ int main(void) {
     sigRet = signatures_ok();
     flash_collectHWEntropy(SIG_OK == sigRet);
 
+#if USE_PRECOMPUTED_CP
+    /* k*G indexes the generator tables in flash by secret nibbles. With the
+     * ART data cache off, every one of those reads costs the same flash wait
+     * states instead of depending on which table lines are cached. */
+    flash_dcache_disable();
+#endif
+
     /* Drop privileges */
     drop_privs();
 
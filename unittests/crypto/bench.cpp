@@ -0,0 +1,90 @@
+extern "C" {
+#include "trezor/crypto/bip32.h"
+#include "trezor/crypto/curves.h"
+#include "trezor/crypto/ecdsa.h"
+#include "trezor/crypto/memzero.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+// Throughput of the operations the generator tables speed up. Disabled by
+// default; run them with `make bench`, once with and once without
+// -DKK_PRECOMPUTED_CP=ON, to compare.
+
+static const int kIterations = 100;
+
+static void report(const char *curve, const char *what,
+                   const std::function<void(int)> &op) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; i++) {
+    op(i);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  printf("%-10s %-20s %10.1f ops/s (USE_PRECOMPUTED_CP=%d)\n", curve, what,
+         kIterations / elapsed.count(), USE_PRECOMPUTED_CP);
+}
+
+static void rootNode(const char *curve, HDNode *node) {
+  static const uint8_t seed[32] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_EQ(hdnode_from_seed(seed, sizeof(seed), curve, node), 1);
+}
+
+static void benchEcdsa(const char *curve_name) {
+  HDNode root;
+  rootNode(curve_name, &root);
+  const ecdsa_curve *curve = (const ecdsa_curve *)root.curve->params;
+
+  report(curve_name, "sign", [&](int i) {
+    uint8_t digest[32] = {0}, sig[64];
+    digest[0] = i;
+    ASSERT_EQ(ecdsa_sign_digest(curve, root.private_key, digest, sig, NULL,
+                                NULL),
+              0);
+  });
+
+  report(curve_name, "private derivation", [&](int i) {
+    HDNode node = root;
+    ASSERT_EQ(hdnode_private_ckd(&node, i), 1);
+    hdnode_fill_public_key(&node);
+  });
+
+  HDNode xpub = root;
+  hdnode_fill_public_key(&xpub);
+  memzero(xpub.private_key, sizeof(xpub.private_key));
+  report(curve_name, "public derivation", [&](int i) {
+    HDNode node = xpub;
+    ASSERT_EQ(hdnode_public_ckd(&node, i), 1);
+  });
+
+  report(curve_name, "address", [&](int i) {
+    HDNode node = root;
+    char address[40];
+    ASSERT_EQ(hdnode_private_ckd(&node, i), 1);
+    hdnode_fill_public_key(&node);
+    hdnode_get_address(&node, 0, address, sizeof(address));
+  });
+
+  memzero(&root, sizeof(root));
+}
+
+TEST(CryptoBench, DISABLED_Secp256k1) { benchEcdsa(SECP256K1_NAME); }
+
+TEST(CryptoBench, DISABLED_Nist256p1) { benchEcdsa(NIST256P1_NAME); }
+
+TEST(CryptoBench, DISABLED_Ed25519) {
+  HDNode root;
+  rootNode(ED25519_NAME, &root);
+
+  report(ED25519_NAME, "private derivation", [&](int i) {
+    HDNode node = root;
+    ASSERT_EQ(hdnode_private_ckd(&node, i | 0x80000000), 1);
+    hdnode_fill_public_key(&node);
+  });
+
+  memzero(&root, sizeof(root));
+}
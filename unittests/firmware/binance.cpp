@@ -0,0 +1,116 @@
+extern "C" {
+#include "keepkey/firmware/binance.h"
+#include "messages-binance.pb.h"
+#include "trezor/crypto/curves.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+// Not derived from the test seed
+static const char *other = "bnb1hgm0p7khfk85zpz5v0j8wnej3a90w709vhkdfu";
+static char address[sizeof(((BinanceInputOutput *)0)->address)];
+
+static void init(uint32_t msg_count) {
+  const uint8_t seed[32] = {1};
+  HDNode node;
+  ASSERT_EQ(hdnode_from_seed(seed, sizeof(seed), SECP256K1_NAME, &node), 1);
+  hdnode_fill_public_key(&node);
+  BinanceSignTx msg;
+  memset(&msg, 0, sizeof(msg));
+  strcpy(msg.chain_id, "Binance-Chain-Tigris");
+  msg.msg_count = msg_count;
+  ASSERT_TRUE(binance_signTxInit(&node, &msg));
+
+  const char *signer = binance_signerAddress();
+  ASSERT_NE(signer, nullptr);
+  ASSERT_STRNE(signer, other);
+  strncpy(address, signer, sizeof(address) - 1);
+}
+
+static BinanceInputOutput io(const char *denom, uint64_t amount) {
+  BinanceInputOutput io;
+  memset(&io, 0, sizeof(io));
+  strcpy(io.address, address);
+  io.coins_count = 1;
+  io.coins[0].amount = amount;
+  strcpy(io.coins[0].denom, denom);
+  return io;
+}
+
+TEST(Binance, TransferMultiDenomBalance) {
+  init(1);
+
+  BinanceInputOutput bnb_in = io("BNB", 1000), xyz_in = io("XYZ-000", 500);
+  ASSERT_TRUE(binance_signTxTransferInput(&bnb_in));
+  ASSERT_TRUE(binance_signTxTransferInput(&xyz_in));
+
+  // Covering one denom does not balance the transfer
+  BinanceInputOutput bnb_out = io("BNB", 1000);
+  ASSERT_TRUE(binance_signTxTransferOutput(&bnb_out));
+  EXPECT_FALSE(binance_signTxTransferIsBalanced());
+  EXPECT_FALSE(binance_signTxTransferEnd());
+
+  // Nor does spending the other denom's amount in the wrong denom
+  BinanceInputOutput wrong = io("BNB", 500);
+  EXPECT_FALSE(binance_signTxTransferOutput(&wrong));
+
+  binance_signAbort();
+  init(1);
+  ASSERT_TRUE(binance_signTxTransferInput(&bnb_in));
+  ASSERT_TRUE(binance_signTxTransferInput(&xyz_in));
+  ASSERT_TRUE(binance_signTxTransferOutput(&bnb_out));
+  BinanceInputOutput xyz_out = io("XYZ-000", 500);
+  ASSERT_TRUE(binance_signTxTransferOutput(&xyz_out));
+  EXPECT_TRUE(binance_signTxTransferIsBalanced());
+  EXPECT_TRUE(binance_signTxTransferEnd());
+
+  // Inputs may not follow outputs
+  EXPECT_FALSE(binance_signTxTransferInput(&bnb_in));
+  binance_signAbort();
+}
+
+TEST(Binance, TransferLongDenoms) {
+  init(1);
+
+  // Longest denoms that fit, differing only in their last character
+  char a[sizeof(((BinanceCoin *)0)->denom)], b[sizeof(a)];
+  memset(a, 'A', sizeof(a) - 1);
+  a[sizeof(a) - 1] = '\0';
+  memcpy(b, a, sizeof(b));
+  b[sizeof(b) - 2] = 'B';
+
+  BinanceInputOutput in = io(a, 100);
+  ASSERT_TRUE(binance_signTxTransferInput(&in));
+
+  // Must not be mistaken for the input's denom
+  BinanceInputOutput out = io(b, 100);
+  EXPECT_FALSE(binance_signTxTransferOutput(&out));
+  binance_signAbort();
+
+  init(1);
+  ASSERT_TRUE(binance_signTxTransferInput(&in));
+  out = io(a, 100);
+  ASSERT_TRUE(binance_signTxTransferOutput(&out));
+  EXPECT_TRUE(binance_signTxTransferEnd());
+  binance_signAbort();
+}
+
+TEST(Binance, TransferInputFromSigner) {
+  init(1);
+
+  BinanceInputOutput in = io("BNB", 100);
+  strcpy(in.address, other);
+  EXPECT_FALSE(binance_signTxTransferInput(&in));
+
+  strcpy(in.address, address);
+  ASSERT_TRUE(binance_signTxTransferInput(&in));
+
+  // Outputs may pay anyone
+  BinanceInputOutput out = io("BNB", 100);
+  strcpy(out.address, other);
+  ASSERT_TRUE(binance_signTxTransferOutput(&out));
+  EXPECT_TRUE(binance_signTxTransferEnd());
+  binance_signAbort();
+}
@@ -1,12 +1,14 @@
 extern "C" {
 #include "keepkey/firmware/coins.h"
 #include "keepkey/firmware/cosmos.h"
+#include "keepkey/firmware/cosmos_direct.h"
 #include "keepkey/firmware/signtx_tendermint.h"
 #include "keepkey/firmware/tendermint.h"
 #include "trezor/crypto/secp256k1.h"
 }
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <cstring>
 
 TEST(Cosmos, CosmosGetAddress) {
@@ -26,6 +28,18 @@ TEST(Cosmos, CosmosGetAddress) {
   char addr[46];
   ASSERT_TRUE(tendermint_getAddress(&node, "cosmos", addr));
   EXPECT_EQ(std::string("cosmos1am058pdux3hyulcmfgj4m3hhrlfn8nzm88u80q"), addr);
+
+  TendermintAddressCache cache;
+  tendermint_addressCacheInit(&cache, &node);
+  const char *cached = tendermint_cachedAddress(&cache, "cosmos");
+  ASSERT_NE(cached, nullptr);
+  EXPECT_EQ(std::string(addr), cached);
+  EXPECT_EQ(tendermint_cachedAddress(&cache, "cosmos"), cached);
+
+  EXPECT_TRUE(tendermint_cachedValidateAddress(&cache, addr));
+  EXPECT_TRUE(tendermint_cachedValidateAddress(&cache, addr));
+  EXPECT_FALSE(tendermint_cachedValidateAddress(
+      &cache, "cosmos1am058pdux3hyulcmfgj4m3hhrlfn8nzm88u80r"));
 }
 
 TEST(Cosmos, CosmosSignTx) {
@@ -72,3 +86,228 @@ TEST(Cosmos, CosmosSignTx) {
                         "\x47\x56\x43\xca\x33\xc7\xad\x2c\x8a\x53\x2b\x39",
              64) == 0);
 }
+
+TEST(Cosmos, JsonHasherMatchesSha256) {
+  std::string memo;
+  for (int i = 0; i < 300; i++) {
+    memo += (i % 17 == 0) ? '"' : (i % 23 == 0) ? '\\' : (char)('a' + i % 26);
+  }
+
+  std::string expected = "{\"account_number\":\"18446744073709551615\"";
+  expected += ",\"memo\":\"";
+  for (char c : memo) {
+    if (c == '"' || c == '\\') expected += '\\';
+    expected += c;
+  }
+  expected += "\",\"sequence\":\"0\"}";
+
+  TendermintJsonHasher json;
+  tendermint_jsonInit(&json);
+  tendermint_jsonWriteStr(&json, "{\"account_number\":\"");
+  tendermint_jsonWriteUint(&json, UINT64_MAX);
+  tendermint_jsonWriteStr(&json, "\"");
+  tendermint_jsonWriteStr(&json, ",\"memo\":\"");
+  tendermint_jsonWriteEscaped(&json, memo.data(), memo.size());
+  tendermint_jsonWriteStr(&json, "\",\"sequence\":\"");
+  tendermint_jsonWriteUint(&json, 0);
+  tendermint_jsonWriteStr(&json, "\"}");
+
+  uint8_t actual_hash[SHA256_DIGEST_LENGTH];
+  tendermint_jsonFinal(&json, actual_hash);
+
+  uint8_t expected_hash[SHA256_DIGEST_LENGTH];
+  sha256_Raw((const uint8_t *)expected.data(), expected.size(), expected_hash);
+
+  EXPECT_EQ(memcmp(actual_hash, expected_hash, sizeof(expected_hash)), 0);
+}
+
+static std::string pbVarint(uint64_t value) {
+  std::string out;
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    if (value) byte |= 0x80;
+    out += (char)byte;
+  } while (value);
+  return out;
+}
+
+static std::string pbBytes(uint32_t field, const std::string &value) {
+  return pbVarint(field << 3 | 2) + pbVarint(value.size()) + value;
+}
+
+static int directMessages;
+static int directFees;
+
+static bool directReview(CosmosDirectField field, uint32_t offset,
+                         uint32_t total, const uint8_t *data, size_t len) {
+  EXPECT_EQ(offset, 0u);
+  EXPECT_EQ(total, len);
+  if (field == CosmosDirectField_Message) {
+    CosmosDirectAny any;
+    if (!cosmos_directDecodeAny(data, len, &any)) return false;
+    EXPECT_EQ(std::string(any.type_url, any.type_url_len),
+              "/cosmos.bank.v1beta1.MsgSend");
+    EXPECT_EQ(any.value_len, 300u);
+    directMessages++;
+  } else if (field == CosmosDirectField_Fee) {
+    CosmosDirectFee fee;
+    if (!cosmos_directDecodeFee(data, len, &fee)) return false;
+    EXPECT_EQ(std::string(fee.denom, fee.denom_len), "uatom");
+    EXPECT_EQ(std::string(fee.amount, fee.amount_len), "5000");
+    EXPECT_EQ(fee.gas_limit, 200000u);
+    directFees++;
+  }
+  return true;
+}
+
+TEST(Cosmos, DirectSignDocMatchesSha256) {
+  std::string any = pbBytes(1, "/cosmos.bank.v1beta1.MsgSend") +
+                    pbBytes(2, std::string(300, '\x5a'));
+  std::string body = pbBytes(1, any) + pbBytes(1, any) +
+                     pbBytes(2, "memo") + pbVarint(3 << 3) + pbVarint(123456);
+  std::string coin = pbBytes(1, "uatom") + pbBytes(2, "5000");
+  std::string fee = pbBytes(1, coin) + pbVarint(2 << 3) + pbVarint(200000);
+  std::string auth_info =
+      pbBytes(1, std::string(40, '\x01')) + pbBytes(2, fee);
+  std::string sign_doc = pbBytes(1, body) + pbBytes(2, auth_info) +
+                         pbBytes(3, "cosmoshub-4") + pbVarint(4 << 3) +
+                         pbVarint(52);
+
+  HDNode node;
+  memset(&node, 0, sizeof(node));
+  directMessages = directFees = 0;
+  ASSERT_TRUE(cosmos_directInit(&node, body.size(), auth_info.size(),
+                                "cosmoshub-4", 52, directReview));
+
+  // Odd sized chunks split tags, lengths and messages.
+  for (size_t i = 0; i < body.size(); i += 7) {
+    size_t len = std::min<size_t>(7, body.size() - i);
+    ASSERT_TRUE(cosmos_directUpdateBody((const uint8_t *)body.data() + i, len));
+  }
+  EXPECT_FALSE(cosmos_directIsComplete());
+  ASSERT_TRUE(cosmos_directUpdateAuthInfo((const uint8_t *)auth_info.data(),
+                                          auth_info.size()));
+  ASSERT_TRUE(cosmos_directIsComplete());
+
+  uint8_t actual_hash[SHA256_DIGEST_LENGTH];
+  ASSERT_TRUE(cosmos_directDigest(actual_hash));
+  cosmos_directAbort();
+
+  uint8_t expected_hash[SHA256_DIGEST_LENGTH];
+  sha256_Raw((const uint8_t *)sign_doc.data(), sign_doc.size(), expected_hash);
+
+  EXPECT_EQ(memcmp(actual_hash, expected_hash, sizeof(expected_hash)), 0);
+  EXPECT_EQ(directMessages, 2);
+  EXPECT_EQ(directFees, 1);
+
+  // Critical extension options can't be reviewed.
+  std::string extension = pbBytes(1023, any);
+  ASSERT_TRUE(cosmos_directInit(&node, extension.size(), auth_info.size(),
+                                "cosmoshub-4", 52, directReview));
+  EXPECT_FALSE(cosmos_directUpdateBody((const uint8_t *)extension.data(),
+                                       extension.size()));
+  cosmos_directAbort();
+}
+
+static std::string directLong;
+static int directPieces;
+
+static bool directReviewLong(CosmosDirectField field, uint32_t offset,
+                             uint32_t total, const uint8_t *data, size_t len) {
+  if (field != CosmosDirectField_Message) return true;
+  EXPECT_EQ(offset, directLong.size());
+  EXPECT_LE(len, (size_t)COSMOS_DIRECT_FIELD_MAX);
+  EXPECT_LE(offset + len, total);
+  directLong.append((const char *)data, len);
+  directPieces++;
+  return true;
+}
+
+TEST(Cosmos, DirectLongFieldIsPaged) {
+  std::string any = pbBytes(1, "/cosmwasm.wasm.v1.MsgExecuteContract") +
+                    pbBytes(2, std::string(2 * COSMOS_DIRECT_FIELD_MAX + 100,
+                                           '\x33'));
+  std::string body = pbBytes(1, any) + pbBytes(2, "memo");
+  std::string coin = pbBytes(1, "uatom") + pbBytes(2, "5000");
+  std::string auth_info = pbBytes(2, pbBytes(1, coin));
+  std::string sign_doc = pbBytes(1, body) + pbBytes(2, auth_info) +
+                         pbBytes(3, "cosmoshub-4") + pbVarint(4 << 3) +
+                         pbVarint(52);
+
+  HDNode node;
+  memset(&node, 0, sizeof(node));
+  directLong.clear();
+  directPieces = 0;
+  ASSERT_TRUE(cosmos_directInit(&node, body.size(), auth_info.size(),
+                                "cosmoshub-4", 52, directReviewLong));
+
+  for (size_t i = 0; i < body.size(); i += 333) {
+    size_t len = std::min<size_t>(333, body.size() - i);
+    ASSERT_TRUE(cosmos_directUpdateBody((const uint8_t *)body.data() + i, len));
+  }
+  ASSERT_TRUE(cosmos_directUpdateAuthInfo((const uint8_t *)auth_info.data(),
+                                          auth_info.size()));
+
+  uint8_t actual_hash[SHA256_DIGEST_LENGTH];
+  ASSERT_TRUE(cosmos_directDigest(actual_hash));
+  cosmos_directAbort();
+
+  uint8_t expected_hash[SHA256_DIGEST_LENGTH];
+  sha256_Raw((const uint8_t *)sign_doc.data(), sign_doc.size(), expected_hash);
+
+  EXPECT_EQ(memcmp(actual_hash, expected_hash, sizeof(expected_hash)), 0);
+  EXPECT_EQ(directLong, any);
+  EXPECT_EQ(directPieces, 3);
+}
+
+TEST(Cosmos, SummaryTotals) {
+  uint64_t value;
+  EXPECT_TRUE(tendermint_parseUint("18446744073709551615", &value));
+  EXPECT_EQ(value, UINT64_MAX);
+  EXPECT_FALSE(tendermint_parseUint("18446744073709551616", &value));
+  EXPECT_FALSE(tendermint_parseUint("", &value));
+  EXPECT_FALSE(tendermint_parseUint("12a", &value));
+
+  TendermintSummary summary;
+  tendermint_summaryInit(&summary);
+  EXPECT_TRUE(tendermint_summaryAddAmount(&summary, "Delegate", "uatom", 6,
+                                          " ATOM", 5));
+  EXPECT_TRUE(tendermint_summaryAddAmount(&summary, "Delegate", "uatom", 6,
+                                          " ATOM", 7));
+  EXPECT_TRUE(
+      tendermint_summaryAddAmount(&summary, "Claim", "uatom", 6, " ATOM", 1));
+  ASSERT_EQ(summary.total_count, 2);
+  EXPECT_EQ(summary.totals[0].amount, 12u);
+  EXPECT_EQ(summary.totals[0].decimals, 6);
+  EXPECT_STREQ(summary.totals[0].symbol, " ATOM");
+  EXPECT_EQ(summary.totals[1].amount, 1u);
+
+  EXPECT_FALSE(tendermint_summaryAddAmount(&summary, "Delegate", "uatom", 6,
+                                           " ATOM", UINT64_MAX));
+  EXPECT_EQ(summary.totals[0].amount, 12u);
+
+  for (int i = summary.total_count; i < TENDERMINT_SUMMARY_TOTALS; i++) {
+    std::string denom = "denom" + std::to_string(i);
+    EXPECT_TRUE(tendermint_summaryAddAmount(&summary, "Delegate",
+                                            denom.c_str(), 0, NULL, 1));
+  }
+  EXPECT_FALSE(tendermint_summaryAddAmount(&summary, "Delegate", "uosmo", 6,
+                                           " OSMO", 1));
+
+  // Each validator is kept once, for its own confirm screen
+  EXPECT_TRUE(tendermint_summaryAddValidator(&summary, "cosmosvaloper1a"));
+  EXPECT_TRUE(tendermint_summaryAddValidator(&summary, "cosmosvaloper1b"));
+  EXPECT_TRUE(tendermint_summaryAddValidator(&summary, "cosmosvaloper1a"));
+  ASSERT_EQ(summary.validator_count, 2);
+  EXPECT_STREQ(summary.validators[0], "cosmosvaloper1a");
+  EXPECT_STREQ(summary.validators[1], "cosmosvaloper1b");
+
+  for (int i = summary.validator_count; i < TENDERMINT_SUMMARY_VALIDATORS;
+       i++) {
+    std::string validator = "cosmosvaloper1" + std::to_string(i);
+    EXPECT_TRUE(tendermint_summaryAddValidator(&summary, validator.c_str()));
+  }
+  EXPECT_FALSE(tendermint_summaryAddValidator(&summary, "cosmosvaloper1z"));
+  EXPECT_EQ(summary.validator_count, TENDERMINT_SUMMARY_VALIDATORS);
+}
@@ -0,0 +1,173 @@
+extern "C" {
+#include "keepkey/firmware/coins.h"
+#include "keepkey/firmware/crypto.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+static std::string to_hex(const uint8_t *buf, size_t size) {
+  static const char *ALPHABET = "0123456789abcdef";
+  std::string hex;
+  for (size_t i = 0; i < size; i++) {
+    hex.push_back(ALPHABET[buf[i] >> 4]);
+    hex.push_back(ALPHABET[buf[i] & 15]);
+  }
+  return hex;
+}
+
+static void from_hex(const std::string &hex, uint8_t *out) {
+  for (size_t i = 0; i < hex.size() / 2; i++) {
+    out[i] = std::stoi(hex.substr(2 * i, 2), nullptr, 16);
+  }
+}
+
+static void messageHash(const CoinType *coin, const std::string &message,
+                        size_t chunk, uint8_t hash[HASHER_DIGEST_LENGTH]) {
+  CryptoMessageHasher ctx;
+  ASSERT_TRUE(cryptoMessageHashInit(&ctx, coin, message.size()));
+  for (size_t i = 0; i < message.size(); i += chunk) {
+    size_t len = std::min(chunk, message.size() - i);
+    ASSERT_TRUE(cryptoMessageHashUpdate(
+        &ctx, (const uint8_t *)message.data() + i, len));
+  }
+  ASSERT_TRUE(cryptoMessageHashFinal(&ctx, hash));
+}
+
+TEST(Crypto, MessageHashChunked) {
+  const CoinType *coin = coinByName("Bitcoin");
+  ASSERT_NE(coin, nullptr);
+
+  // SignMessage / VerifyMessage test vector
+  const std::string message = "This is an example of a signed message.";
+  const char *address = "14LmW5k4ssUrtbAB4255zdqv3b4w1TuX9e";
+  uint8_t signature[65];
+  from_hex(
+      "209e23edf0e4e47ff1dec27f32cd78c50e74ef018ee8a6adf35ae17c7a9b0dd96f"
+      "48b493fd7dbab03efb6f439c6383c9523b3bbc5f1a7d158a6af90ab154e9be80",
+      signature);
+
+  uint8_t whole[HASHER_DIGEST_LENGTH], chunked[HASHER_DIGEST_LENGTH];
+  messageHash(coin, message, message.size(), whole);
+  messageHash(coin, message, 7, chunked);
+  EXPECT_EQ("d0e5595ac689a1df9f0b13443e0efd876eeb762d50a05f7179b1506bfccfeec5",
+            to_hex(whole, sizeof(whole)));
+  EXPECT_EQ(to_hex(whole, sizeof(whole)), to_hex(chunked, sizeof(chunked)));
+
+  EXPECT_EQ(cryptoMessageVerifyDigest(coin, chunked, address, signature), 0);
+  EXPECT_EQ(cryptoMessageVerify(coin, (const uint8_t *)message.data(),
+                                message.size(), address, signature),
+            0);
+
+  // Past 252 bytes the length prefix takes three bytes.
+  std::string long_message;
+  for (int i = 0; i < 300; i++) long_message.push_back((char)(i % 251));
+  messageHash(coin, long_message, long_message.size(), whole);
+  messageHash(coin, long_message, 64, chunked);
+  EXPECT_EQ("09e25be8fcb130bb3d0d0964fafbc0ac92ba71ead74b568528e6b43f65d205a8",
+            to_hex(whole, sizeof(whole)));
+  EXPECT_EQ(to_hex(whole, sizeof(whole)), to_hex(chunked, sizeof(chunked)));
+}
+
+TEST(Crypto, MessageHashLength) {
+  const CoinType *coin = coinByName("Bitcoin");
+  ASSERT_NE(coin, nullptr);
+
+  const uint8_t data[4] = {1, 2, 3, 4};
+  uint8_t hash[HASHER_DIGEST_LENGTH];
+  CryptoMessageHasher ctx;
+
+  ASSERT_TRUE(cryptoMessageHashInit(&ctx, coin, 3));
+  EXPECT_FALSE(cryptoMessageHashUpdate(&ctx, data, 4));
+  ASSERT_TRUE(cryptoMessageHashUpdate(&ctx, data, 2));
+  EXPECT_FALSE(cryptoMessageHashFinal(&ctx, hash));
+  ASSERT_TRUE(cryptoMessageHashUpdate(&ctx, data, 1));
+  EXPECT_TRUE(cryptoMessageHashFinal(&ctx, hash));
+}
+
+static void cosignerPath(uint8_t seed_byte, uint32_t prefix, uint32_t leaf,
+                         HDNodePathType *path, uint8_t expected[33]) {
+  const CoinType *coin = coinByName("Bitcoin");
+  uint8_t seed[32];
+  memset(seed, seed_byte, sizeof(seed));
+  HDNode node;
+  ASSERT_EQ(hdnode_from_seed(seed, sizeof(seed), coin->curve_name, &node), 1);
+  hdnode_fill_public_key(&node);
+
+  memset(path, 0, sizeof(*path));
+  path->node.depth = node.depth;
+  path->node.child_num = node.child_num;
+  path->node.chain_code.size = 32;
+  memcpy(path->node.chain_code.bytes, node.chain_code, 32);
+  path->node.has_public_key = true;
+  path->node.public_key.size = 33;
+  memcpy(path->node.public_key.bytes, node.public_key, 33);
+  path->address_n_count = 2;
+  path->address_n[0] = prefix;
+  path->address_n[1] = leaf;
+
+  // The same derivation without the cache
+  ASSERT_EQ(hdnode_public_ckd(&node, prefix), 1);
+  ASSERT_EQ(hdnode_public_ckd(&node, leaf), 1);
+  memcpy(expected, node.public_key, 33);
+}
+
+static std::string cosignerPubkey(const HDNodePathType *path) {
+  const uint8_t *pubkey =
+      cryptoHDNodePathToPubkey(coinByName("Bitcoin"), path);
+  return pubkey ? to_hex(pubkey, 33) : "";
+}
+
+TEST(Crypto, CosignerCache) {
+  cryptoCosignerCacheClear();
+
+  HDNodePathType path;
+  uint8_t expected[33];
+  cosignerPath(0x01, 0, 5, &path, expected);
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+
+  // Another leaf under the cached prefix
+  cosignerPath(0x01, 0, 6, &path, expected);
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+
+  // Same path, different cosigner
+  cosignerPath(0x02, 0, 6, &path, expected);
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+
+  cosignerPath(0x01, 0, 5, &path, expected);
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+
+  cryptoCosignerCacheClear();
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+  cryptoCosignerCacheClear();
+}
+
+TEST(Crypto, CosignerCacheEviction) {
+  cryptoCosignerCacheClear();
+
+  HDNodePathType path;
+  uint8_t expected[33];
+  const uint8_t *slots[CRYPTO_COSIGNER_CACHE_SIZE + 1];
+  for (uint32_t i = 0; i <= CRYPTO_COSIGNER_CACHE_SIZE; i++) {
+    cosignerPath(0x01, i, 7, &path, expected);
+    slots[i] = cryptoHDNodePathToPubkey(coinByName("Bitcoin"), &path);
+    ASSERT_NE(slots[i], nullptr);
+    EXPECT_EQ(to_hex(expected, 33), to_hex(slots[i], 33));
+  }
+
+  // A full cache keeps one slot per cosigner, then reuses the oldest
+  for (size_t i = 1; i < CRYPTO_COSIGNER_CACHE_SIZE; i++) {
+    EXPECT_NE(slots[0], slots[i]);
+  }
+  EXPECT_EQ(slots[0], slots[CRYPTO_COSIGNER_CACHE_SIZE]);
+
+  // The evicted cosigner is derived again, not served stale
+  cosignerPath(0x01, 0, 7, &path, expected);
+  EXPECT_EQ(to_hex(expected, 33), cosignerPubkey(&path));
+
+  cryptoCosignerCacheClear();
+}
@@ -1,5 +1,6 @@
 extern "C" {
 #include "keepkey/firmware/eos.h"
+#include "keepkey/firmware/eos-contracts/abi.h"
 #include "messages-eos.pb.h"
 }
 
@@ -24,6 +25,7 @@ TEST(EOS, FormatNameVec) {
       {0xc2b263b800000000, "setabi", true},
       {0xa726ab8000000000, "owner", true},
       {EOS_Owner, "owner", true},
+      {EOS_Packed, "packed", true},
       {0x3232eda800000000, "active", true},
       {EOS_Active, "active", true},
       {0x5530002eea526920, "eos..freedom", true},
@@ -105,3 +107,103 @@ TEST(EOS, PublicKeyToWIF) {
   ASSERT_EQ(pubkey,
             std::string("EOS_K1_1111111111111111111111111111111114T1Anm"));
 }
+
+TEST(EOS, AbiValidate) {
+  // eosio.token::transfer, from eosio to eosio.token, 1.0000 EOS, memo "hi"
+  const uint8_t transfer[] = {
+      0x00, 0x00, 0x00, 0x00, 0x00, 0xea, 0x30, 0x55, 0x00, 0xa6, 0x82, 0x34,
+      0x03, 0xea, 0x30, 0x55, 0x10, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x04, 0x45, 0x4f, 0x53, 0x00, 0x00, 0x00, 0x00, 0x02, 'h',  'i'};
+
+  const EosAbiAction *abi = eos_abiFind(EOS_eosio_token, EOS_Transfer);
+  ASSERT_NE(abi, nullptr);
+  EXPECT_TRUE(eos_abiValidate(abi, transfer, sizeof(transfer)));
+  EXPECT_FALSE(eos_abiValidate(abi, transfer, sizeof(transfer) - 1));
+
+  // Only eosio.token implements transfer
+  EXPECT_EQ(eos_abiFind(EOS_eosio, EOS_Transfer), nullptr);
+
+  // eosio::voteproducer, producers must be sorted
+  uint8_t vote[8 + 8 + 1 + 2 * 8] = {0};
+  vote[16] = 2;
+  vote[17 + 7] = 1;
+  vote[25 + 7] = 2;
+  abi = eos_abiFind(EOS_eosio, EOS_VoteProducer);
+  ASSERT_NE(abi, nullptr);
+  EXPECT_TRUE(eos_abiValidate(abi, vote, sizeof(vote)));
+  vote[25 + 7] = 1;
+  EXPECT_FALSE(eos_abiValidate(abi, vote, sizeof(vote)));
+}
+
+TEST(EOS, DecodeUInt) {
+  for (uint64_t val : {0ULL, 1ULL, 127ULL, 128ULL, 624485ULL, UINT64_MAX}) {
+    uint8_t buf[10];
+    size_t len = 0;
+    uint64_t v = val;
+    do {
+      buf[len] = (v & 0x7f) | (v > 0x7f ? 0x80 : 0);
+      v >>= 7;
+      len++;
+    } while (v);
+    ASSERT_EQ(len, eos_hashUInt(nullptr, val));
+
+    const uint8_t *p = buf;
+    uint64_t out;
+    EXPECT_TRUE(eos_decodeUInt(&p, buf + len, &out));
+    EXPECT_EQ(out, val);
+    EXPECT_EQ(p, buf + len);
+
+    p = buf;
+    if (len > 1) EXPECT_FALSE(eos_decodeUInt(&p, buf + len - 1, &out));
+  }
+}
+
+TEST(EOS, PackedActionsMarker) {
+  EosActionCommon common;
+  memset(&common, 0, sizeof(common));
+
+  // An unset account must not select packed actions
+  EXPECT_FALSE(eos_isPackedActions(&common));
+
+  common.has_account = true;
+  common.account = EOS_PackedActions;
+  EXPECT_FALSE(eos_isPackedActions(&common));
+
+  common.has_name = true;
+  common.name = EOS_Packed;
+  EXPECT_TRUE(eos_isPackedActions(&common));
+
+  common.authorization_count = 1;
+  EXPECT_FALSE(eos_isPackedActions(&common));
+}
+
+TEST(EOS, PackedActionsSpanChunks) {
+  HDNode root;
+  memset(&root, 0, sizeof(root));
+  uint8_t chain_id[32] = {0};
+  uint32_t address_n[8] = {0};
+  EosTxHeader header;
+  memset(&header, 0, sizeof(header));
+  eos_signingInit(chain_id, 1, &header, &root, address_n, 0);
+
+  // eosio.token::transfer authorized by eosio@active, split after its
+  // authorization. Nothing is confirmed or hashed until the rest arrives.
+  EosActionUnknown chunk;
+  memset(&chunk, 0, sizeof(chunk));
+  const uint8_t head[] = {0x00, 0xa6, 0x82, 0x34, 0x03, 0xea, 0x30, 0x55,
+                          0x00, 0x00, 0x00, 0x57, 0x2d, 0x3c, 0xcd, 0xcd,
+                          0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xea, 0x30,
+                          0x55, 0x00, 0x00, 0x00, 0x00, 0xa8, 0xed, 0x32,
+                          0x32};
+  chunk.data_size = sizeof(head) + 1 + 35;
+  chunk.data_chunk.size = sizeof(head);
+  memcpy(chunk.data_chunk.bytes, head, sizeof(head));
+
+  EXPECT_TRUE(eos_compileActionsPacked(&chunk));
+  EXPECT_TRUE(eos_hasActionUnknownDataRemaining());
+  EXPECT_EQ(eos_actionsRemaining(), 1u);
+  EXPECT_FALSE(eos_signingIsFinished());
+
+  eos_signingAbort();
+  EXPECT_FALSE(eos_hasActionUnknownDataRemaining());
+}
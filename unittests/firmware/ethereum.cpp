@@ -1,10 +1,17 @@
 extern "C" {
+#include "keepkey/firmware/ethereum.h"
+#include "keepkey/firmware/ethereum_tokens.h"
 #include "trezor/crypto/address.h"
+#include "trezor/crypto/bignum.h"
+#include "trezor/crypto/sha3.h"
 }
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <vector>
 
 static uint8_t bin_from_ascii(char c) {
   if ('a' <= c && c <= 'f') return c - 'a' + 0xa;
@@ -38,3 +45,232 @@ TEST(Ethereum, AddressChecksum) {
   test_checksum("dbF03B407c01E7cD3CBea99509d93f8DDDC8C6FB");
   test_checksum("D1220A0cf47c7B9Be7A2E6BA89F429762e7b9aDb");
 }
+
+TEST(Ethereum, FormatFixedPointMatchesBnFormat) {
+  // Deterministic LCG so failures are reproducible.
+  uint64_t seed = 0x9e3779b97f4a7c15ULL;
+  auto next = [&seed]() {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint8_t)(seed >> 56);
+  };
+
+  const uint32_t decimals[] = {0, 1, 6, 8, 9, 10, 18, 19, 24, 30};
+  const char *suffixes[] = {NULL, " ETH", " MATIC"};
+  const size_t buflens[] = {8, 16, 25, 32, 128};
+
+  for (int n = 0; n < 200; n++) {
+    uint8_t be[32] = {0};
+    // Vary the width: zero, small, 64-bit and full 256-bit amounts.
+    int width = (n % 4 == 0) ? 0 : (n % 4 == 1) ? 4 : (n % 4 == 2) ? 8 : 32;
+    for (int i = 32 - width; i < 32; i++) be[i] = next();
+
+    bignum256 amnt;
+    bn_read_be(be, &amnt);
+
+    for (uint32_t dec : decimals) {
+      for (const char *suffix : suffixes) {
+        for (size_t len : buflens) {
+          char expected[128], actual[128];
+          memset(expected, 0, sizeof(expected));
+          memset(actual, 0, sizeof(actual));
+          bn_format(&amnt, NULL, suffix, dec, 0, false, expected, len);
+          ethereum_formatFixedPoint(&amnt, suffix, dec, actual, len);
+          ASSERT_EQ(std::string(expected), std::string(actual))
+              << "decimals=" << dec << " buflen=" << len;
+        }
+      }
+    }
+  }
+}
+
+TEST(Ethereum, MessageHashChunked) {
+  const std::string message =
+      "I control the addresses listed in this proof of reserves.";
+
+  EthereumMessageHasher ctx;
+  uint8_t whole[32];
+  ethereum_message_hashInit(&ctx, message.size());
+  ASSERT_TRUE(ethereum_message_hashUpdate(
+      &ctx, (const uint8_t *)message.data(), message.size()));
+  ASSERT_TRUE(ethereum_message_hashFinal(&ctx, whole));
+
+  uint8_t chunked[32];
+  ethereum_message_hashInit(&ctx, message.size());
+  for (size_t i = 0; i < message.size(); i += 7) {
+    size_t len = std::min<size_t>(7, message.size() - i);
+    ASSERT_TRUE(ethereum_message_hashUpdate(
+        &ctx, (const uint8_t *)message.data() + i, len));
+  }
+  ASSERT_TRUE(ethereum_message_hashFinal(&ctx, chunked));
+
+  EXPECT_EQ(memcmp(whole, chunked, 32), 0);
+}
+
+TEST(Ethereum, MessageHashLength) {
+  const uint8_t data[4] = {1, 2, 3, 4};
+  uint8_t hash[32];
+  EthereumMessageHasher ctx;
+
+  ethereum_message_hashInit(&ctx, 3);
+  EXPECT_FALSE(ethereum_message_hashUpdate(&ctx, data, 4));
+  ASSERT_TRUE(ethereum_message_hashUpdate(&ctx, data, 2));
+  EXPECT_FALSE(ethereum_message_hashFinal(&ctx, hash));
+  ASSERT_TRUE(ethereum_message_hashUpdate(&ctx, data, 1));
+  EXPECT_TRUE(ethereum_message_hashFinal(&ctx, hash));
+}
+
+static std::vector<uint8_t> from_hex(const std::string &hex) {
+  std::vector<uint8_t> out;
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    out.push_back(bin_from_ascii(hex[i]) << 4 | bin_from_ascii(hex[i + 1]));
+  }
+  return out;
+}
+
+#define SET_BYTES(msg, field, hex)                                      \
+  do {                                                                  \
+    std::vector<uint8_t> bytes = from_hex(hex);                         \
+    (msg).has_##field = true;                                           \
+    (msg).field.size = bytes.size();                                    \
+    memcpy((msg).field.bytes, bytes.data(), bytes.size());              \
+  } while (0)
+
+// Sends 1 ETH to 0x3535...35 for 21000 gas, fees left to the caller.
+static EthereumSignTx transfer(void) {
+  EthereumSignTx msg;
+  memset(&msg, 0, sizeof(msg));
+  SET_BYTES(msg, nonce, "01");
+  SET_BYTES(msg, gas_limit, "5208");
+  SET_BYTES(msg, to, "3535353535353535353535353535353535353535");
+  SET_BYTES(msg, value, "0de0b6b3a7640000");
+  return msg;
+}
+
+static void expect_preimage(EthereumSignTx *msg, const std::string &preimage) {
+  std::vector<uint8_t> bytes = from_hex(preimage);
+  uint8_t expected[32], hash[32];
+  keccak_256(bytes.data(), bytes.size(), expected);
+  ASSERT_TRUE(ethereum_signing_txHash(msg, hash));
+  EXPECT_EQ(memcmp(hash, expected, sizeof(hash)), 0);
+}
+
+TEST(Ethereum, Eip2930Preimage) {
+  EthereumSignTx msg = transfer();
+  SET_BYTES(msg, nonce, "09");
+  SET_BYTES(msg, gas_price, "04a817c800");
+  SET_BYTES(msg, data_initial_chunk, "deadbeef");
+  msg.has_data_length = true;
+  msg.data_length = 4;
+  msg.has_chain_id = true;
+  msg.chain_id = 1;
+  msg.has_type = true;
+  msg.type = 1;
+
+  // 0x01 || rlp([chain_id, nonce, gas_price, gas_limit, to, value, data, []])
+  expect_preimage(&msg,
+                  "01ef01098504a817c800825208943535353535353535353535353535"
+                  "353535353535880de0b6b3a764000084deadbeefc0");
+}
+
+TEST(Ethereum, Eip1559LargeChainId) {
+  EthereumSignTx msg = transfer();
+  SET_BYTES(msg, max_priority_fee_per_gas, "77359400");
+  SET_BYTES(msg, max_fee_per_gas, "0ba43b7400");
+  msg.has_chain_id = true;
+  msg.chain_id = 43114;
+  msg.has_type = true;
+  msg.type = 2;
+
+  // 0x02 || rlp([chain_id, nonce, max_priority_fee_per_gas, max_fee_per_gas,
+  //              gas_limit, to, value, data, []])
+  expect_preimage(&msg,
+                  "02f282a86a018477359400850ba43b7400825208943535353535353535"
+                  "353535353535353535353535880de0b6b3a764000080c0");
+}
+
+TEST(Ethereum, LegacyLargeChainId) {
+  EthereumSignTx msg = transfer();
+  SET_BYTES(msg, gas_price, "04a817c800");
+  msg.has_chain_id = true;
+  msg.chain_id = 43114;
+
+  // rlp([nonce, gas_price, gas_limit, to, value, data, chain_id, 0, 0])
+  expect_preimage(&msg,
+                  "ee018504a817c800825208943535353535353535353535353535353535"
+                  "353535880de0b6b3a76400008082a86a8080");
+}
+
+TEST(Ethereum, FeeFieldsMatchType) {
+  uint8_t hash[32];
+
+  // EIP-1559 needs both fee caps
+  EthereumSignTx msg = transfer();
+  SET_BYTES(msg, max_fee_per_gas, "0ba43b7400");
+  msg.has_chain_id = true;
+  msg.chain_id = 1;
+  msg.has_type = true;
+  msg.type = 2;
+  EXPECT_FALSE(ethereum_signing_txHash(&msg, hash));
+  SET_BYTES(msg, max_priority_fee_per_gas, "77359400");
+  EXPECT_TRUE(ethereum_signing_txHash(&msg, hash));
+
+  // EIP-1559 fee fields are rejected on legacy and EIP-2930 transactions
+  for (uint32_t type : {0, 1}) {
+    msg = transfer();
+    SET_BYTES(msg, gas_price, "04a817c800");
+    msg.has_chain_id = true;
+    msg.chain_id = 1;
+    msg.has_type = true;
+    msg.type = type;
+    EXPECT_TRUE(ethereum_signing_txHash(&msg, hash));
+
+    EthereumSignTx bad = msg;
+    SET_BYTES(bad, max_fee_per_gas, "0ba43b7400");
+    EXPECT_FALSE(ethereum_signing_txHash(&bad, hash));
+
+    bad = msg;
+    SET_BYTES(bad, max_priority_fee_per_gas, "77359400");
+    EXPECT_FALSE(ethereum_signing_txHash(&bad, hash));
+  }
+}
+
+// The table lookup tokenByChainAddress caches its last match in front of.
+static const TokenType *scan_tokens(uint8_t chain_id, const char *address) {
+  for (int i = 0; i < TOKENS_COUNT; i++) {
+    if (tokens[i].chain_id == chain_id &&
+        memcmp(tokens[i].address, address, 20) == 0) {
+      return &tokens[i];
+    }
+  }
+  return UnknownToken;
+}
+
+TEST(Ethereum, TokenLookupCache) {
+  ASSERT_GT(TOKENS_COUNT, 1);
+  const TokenType *a = &tokens[0];
+  const TokenType *b = NULL;
+  for (int i = 1; i < TOKENS_COUNT && !b; i++) {
+    if (tokens[i].chain_id != a->chain_id &&
+        memcmp(tokens[i].address, a->address, 20) != 0) {
+      b = &tokens[i];
+    }
+  }
+  ASSERT_NE(b, nullptr);
+
+  // Repeats, switches to another chain and address, and lookups sharing only
+  // the chain or only the address with the cached match
+  const struct {
+    uint8_t chain_id;
+    const char *address;
+  } lookups[] = {
+      {a->chain_id, a->address}, {a->chain_id, a->address},
+      {b->chain_id, b->address}, {a->chain_id, a->address},
+      {b->chain_id, a->address}, {a->chain_id, b->address},
+      {b->chain_id, b->address},
+  };
+  for (const auto &lookup : lookups) {
+    EXPECT_EQ(tokenByChainAddress(lookup.chain_id,
+                                  (const uint8_t *)lookup.address),
+              scan_tokens(lookup.chain_id, lookup.address));
+  }
+}
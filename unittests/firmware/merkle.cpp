@@ -0,0 +1,82 @@
+extern "C" {
+#include "keepkey/firmware/merkle.h"
+#include "trezor/crypto/hasher.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+
+static std::string hex(const uint8_t *data, size_t len) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out;
+  for (size_t i = 0; i < len; i++) {
+    out += digits[data[i] >> 4];
+    out += digits[data[i] & 0xf];
+  }
+  return out;
+}
+
+static void from_hex(const char *str, uint8_t *out, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    sscanf(str + 2 * i, "%2hhx", &out[i]);
+  }
+}
+
+// Leaves are SHA256d of a single byte 0, 1, 2, ...; roots computed with the
+// Bitcoin block merkle construction.
+TEST(Merkle, OddLeafCounts) {
+  const struct {
+    uint32_t count;
+    const char *root;
+  } vectors[] = {
+      {1, "1406e05881e299367766d313e26c05564ec91bf721d31726bd6e46e60689539a"},
+      {2, "4bbe83bc38ebe2bcc7520d234139df1c0eb9ffa51f83eab1c5129b5b906b7655"},
+      {3, "e129dfe02f567fc612d126596d43406144f40a771810ac7143421d2df3e5c1d0"},
+      {5, "f4113849d628f7c3bc91cc0ff785a6aee3ee236c1c912b28cc09c44f9f97b748"},
+      {10, "4b0f4161ae3030234ed2844047f83d63a2d9d25ff7c1849fc899aa907590c9b0"},
+      {12, "37177b227b4024dc6a726036f94d2740d2926f3d0d513dee315a06642cf4723a"},
+  };
+
+  for (const auto &vector : vectors) {
+    MerkleTree tree;
+    merkle_init(&tree);
+    for (uint32_t i = 0; i < vector.count; i++) {
+      uint8_t byte = i, leaf[32];
+      hasher_Raw(HASHER_SHA2D, &byte, 1, leaf);
+      ASSERT_TRUE(merkle_add(&tree, leaf));
+    }
+    uint8_t root[32];
+    ASSERT_TRUE(merkle_root(&tree, root));
+    EXPECT_EQ(hex(root, 32), vector.root) << "count=" << vector.count;
+  }
+}
+
+// Block 100000: its four txids and merkle root, in internal byte order.
+TEST(Merkle, Block100000) {
+  const char *txids[] = {
+      "876dd0a3ef4a2816ffd1c12ab649825a958b0ff3bb3d6f3e1250f13ddbf0148c",
+      "c40297f730dd7b5a99567eb8d27b78758f607507c52292d02d4031895b52f2ff",
+      "c46e239ab7d28e2c019b6d66ad8fae98a56ef1f21aeecb94d1b1718186f05963",
+      "1d0cb83721529a062d9675b98d6e5c587e4a770fc84ed00abc5a5de04568a6e9",
+  };
+  MerkleTree tree;
+  merkle_init(&tree);
+  for (const char *txid : txids) {
+    uint8_t leaf[32];
+    from_hex(txid, leaf, 32);
+    ASSERT_TRUE(merkle_add(&tree, leaf));
+  }
+  uint8_t root[32];
+  ASSERT_TRUE(merkle_root(&tree, root));
+  EXPECT_EQ(hex(root, 32),
+            "6657a9252aacd5c0b2940996ecff952228c3067cc38d4885efb5a4ac4247e9f3");
+}
+
+TEST(Merkle, Empty) {
+  MerkleTree tree;
+  uint8_t root[32];
+  merkle_init(&tree);
+  EXPECT_FALSE(merkle_root(&tree, root));
+}
@@ -23,6 +23,18 @@ TEST(Nano, GetKnownRepName) {
       nano_getKnownRepName(
           "xrb_3arg3asgtigae3xckabaaewkx3bzsh7nwz7jkmjos79ihyaxwphhm6qgjps4"));
   EXPECT_EQ(nullptr, nano_getKnownRepName("xrb_notarealrepresentative"));
+
+  // First and last entries of the sorted index
+  EXPECT_EQ(
+      std::string("NanoWallet Bot Rep "),
+      nano_getKnownRepName(
+          "xrb_16k5pimotz9zehjk795wa4qcx54mtusk8hc5mdsjgy57gnhbj3hj6zaib4ic"));
+  EXPECT_EQ(
+      std::string("Genesis "),
+      nano_getKnownRepName(
+          "xrb_3t6k35gi95xu6tergt6p69ck76ogmitsa8mnijtpxm9fkcm736xtoncuohr3"));
+  EXPECT_EQ(nullptr, nano_getKnownRepName(""));
+  EXPECT_EQ(nullptr, nano_getKnownRepName("xrb_zzz"));
 }
 
 TEST(Nano, TruncateAddress) {
@@ -144,3 +156,142 @@ TEST(Nano, Bip32ToString) {
         << "Unexpected string result";
   }
 }
+
+static const char *GENESIS_REP =
+    "xrb_3t6k35gi95xu6tergt6p69ck76ogmitsa8mnijtpxm9fkcm736xtoncuohr3";
+
+static void node_from_seed(const CoinType *coin, uint8_t fill, HDNode *node) {
+  uint8_t seed[32];
+  memset(seed, fill, sizeof(seed));
+  ASSERT_EQ(hdnode_from_seed(seed, sizeof(seed), coin->curve_name, node), 1);
+  hdnode_fill_public_key(node);
+}
+
+/// A receive on an account that already exists, keeping its representative,
+/// which nano_signTx signs without a confirmation.
+static void fill_receive(NanoSignTx *msg, const uint8_t parent_hash[32],
+                         uint8_t parent_link, uint8_t parent_balance,
+                         uint8_t link, uint8_t balance) {
+  memset(msg, 0, sizeof(*msg));
+  msg->has_parent_block = true;
+  msg->parent_block.has_parent_hash = true;
+  msg->parent_block.parent_hash.size = 32;
+  memcpy(msg->parent_block.parent_hash.bytes, parent_hash, 32);
+  msg->parent_block.has_link = true;
+  msg->parent_block.link.size = 32;
+  memset(msg->parent_block.link.bytes, parent_link, 32);
+  msg->parent_block.has_representative = true;
+  strcpy(msg->parent_block.representative, GENESIS_REP);
+  msg->parent_block.has_balance = true;
+  msg->parent_block.balance.size = 16;
+  msg->parent_block.balance.bytes[15] = parent_balance;
+
+  msg->has_link_hash = true;
+  msg->link_hash.size = 32;
+  memset(msg->link_hash.bytes, link, 32);
+  msg->has_representative = true;
+  strcpy(msg->representative, GENESIS_REP);
+  msg->has_balance = true;
+  msg->balance.size = 16;
+  msg->balance.bytes[15] = balance;
+}
+
+static void expected_hash(const HDNode *node, const uint8_t parent_hash[32],
+                          uint8_t link_byte, uint8_t balance_byte,
+                          uint8_t out_hash[32]) {
+  uint8_t rep_pk[32];
+  ASSERT_TRUE(nano_validate_address("xrb_", 4, GENESIS_REP,
+                                    strlen(GENESIS_REP), rep_pk));
+  uint8_t link[32];
+  memset(link, link_byte, sizeof(link));
+  uint8_t balance[16] = {0};
+  balance[15] = balance_byte;
+  nano_hash_block_data(&node->public_key[1], parent_hash, link, rep_pk,
+                       balance, out_hash);
+}
+
+static void sign_receive(const CoinType *coin, const HDNode *node,
+                         const NanoSignTx *msg, NanoSignedTx *resp) {
+  HDNode signer = *node;
+  memset(resp, 0, sizeof(*resp));
+  ASSERT_TRUE(nano_signingInit(msg, &signer, coin));
+  ASSERT_TRUE(nano_parentHash(msg));
+  ASSERT_TRUE(nano_currentHash(msg, NULL));
+  ASSERT_TRUE(nano_sanityCheck(msg));
+  ASSERT_TRUE(nano_signTx(msg, &signer, resp));
+  ASSERT_EQ(resp->block_hash.size, 32);
+}
+
+TEST(Nano, FrontierReuse) {
+  const CoinType *coin = coinByName("Nano");
+  HDNode node, other;
+  node_from_seed(coin, 0x01, &node);
+  node_from_seed(coin, 0x02, &other);
+  nano_clearCache();
+
+  const uint8_t root[32] = {0x11};
+  uint8_t h0[32], h1[32], h2[32], h1_other[32], h2_other[32];
+  expected_hash(&node, root, 0x22, 1, h0);
+  expected_hash(&node, h0, 0x33, 2, h1);
+  expected_hash(&node, h1, 0x44, 3, h2);
+
+  NanoSignTx msg;
+  NanoSignedTx resp;
+  fill_receive(&msg, root, 0x22, 1, 0x33, 2);
+  sign_receive(coin, &node, &msg, &resp);
+  EXPECT_EQ(bytes_to_hex(h1, 32), bytes_to_hex(resp.block_hash.bytes, 32));
+
+  // The next block's parent is the frontier just signed
+  fill_receive(&msg, h0, 0x33, 2, 0x44, 3);
+  sign_receive(coin, &node, &msg, &resp);
+  EXPECT_EQ(bytes_to_hex(h2, 32), bytes_to_hex(resp.block_hash.bytes, 32));
+
+  // Rewinding to the same parent after a clear hashes it from scratch
+  nano_clearCache();
+  fill_receive(&msg, h0, 0x33, 2, 0x44, 3);
+  sign_receive(coin, &node, &msg, &resp);
+  EXPECT_EQ(bytes_to_hex(h2, 32), bytes_to_hex(resp.block_hash.bytes, 32));
+
+  // The frontier of one account must not stand in for another's
+  expected_hash(&other, h0, 0x33, 2, h1_other);
+  expected_hash(&other, h1_other, 0x44, 3, h2_other);
+  sign_receive(coin, &other, &msg, &resp);
+  EXPECT_EQ(bytes_to_hex(h2_other, 32),
+            bytes_to_hex(resp.block_hash.bytes, 32));
+
+  nano_clearCache();
+}
+
+TEST(Nano, RecipientCache) {
+  const CoinType *coin = coinByName("Nano");
+  HDNode node, recip;
+  node_from_seed(coin, 0x01, &node);
+  node_from_seed(coin, 0x03, &recip);
+  nano_clearCache();
+
+  const uint8_t root[32] = {0x11};
+  NanoSignTx msg;
+  fill_receive(&msg, root, 0x22, 5, 0x00, 4);
+  msg.has_link_hash = false;
+  msg.link_recipient_n_count = 3;
+  msg.link_recipient_n[0] = 0x80000000 | 44;
+  msg.link_recipient_n[1] = 0x80000000 | 165;
+  msg.link_recipient_n[2] = 0x80000000 | 1;
+
+  ASSERT_TRUE(nano_signingInit(&msg, &node, coin));
+  ASSERT_TRUE(nano_parentHash(&msg));
+  EXPECT_FALSE(nano_recipientIsCached(&msg));
+  EXPECT_FALSE(nano_currentHash(&msg, NULL));
+  ASSERT_TRUE(nano_currentHash(&msg, &recip));
+  EXPECT_TRUE(nano_recipientIsCached(&msg));
+  EXPECT_TRUE(nano_currentHash(&msg, NULL));
+
+  // A different path is not served from the cache
+  msg.link_recipient_n[2] = 0x80000000 | 2;
+  EXPECT_FALSE(nano_recipientIsCached(&msg));
+  msg.link_recipient_n[2] = 0x80000000 | 1;
+
+  nano_clearCache();
+  EXPECT_FALSE(nano_recipientIsCached(&msg));
+  nano_signingAbort();
+}
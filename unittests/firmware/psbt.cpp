@@ -0,0 +1,220 @@
+extern "C" {
+#include "keepkey/firmware/psbt.h"
+}
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static void append(Bytes &out, const Bytes &data) {
+  out.insert(out.end(), data.begin(), data.end());
+}
+
+static void append_le(Bytes &out, uint64_t value, int size) {
+  for (int i = 0; i < size; i++) out.push_back((value >> (8 * i)) & 0xff);
+}
+
+static void append_kv(Bytes &out, const Bytes &key, const Bytes &value) {
+  out.push_back(key.size());
+  append(out, key);
+  if (value.size() < 0xfd) {
+    out.push_back(value.size());
+  } else {
+    out.push_back(0xfd);
+    append_le(out, value.size(), 2);
+  }
+  append(out, value);
+}
+
+static const Bytes p2wpkh = {0x00, 0x14, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                             0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                             0x11, 0x11, 0x11, 0x11, 0x11, 0x11};
+
+/// Two inputs, two outputs, a large proprietary global value and a BIP32
+/// derivation on the first input.
+static Bytes make_psbt() {
+  Bytes tx;
+  append_le(tx, 2, 4);
+  tx.push_back(2);
+  for (int i = 0; i < 2; i++) {
+    append(tx, Bytes(32, 0xaa + i));
+    append_le(tx, i, 4);
+    tx.push_back(0);
+    append_le(tx, 0xfffffffd, 4);
+  }
+  tx.push_back(2);
+  append_le(tx, 100000, 8);
+  tx.push_back(p2wpkh.size());
+  append(tx, p2wpkh);
+  append_le(tx, 250, 8);
+  tx.push_back(0);
+  append_le(tx, 0, 4);
+
+  Bytes witness_utxo;
+  append_le(witness_utxo, 150000, 8);
+  witness_utxo.push_back(p2wpkh.size());
+  append(witness_utxo, p2wpkh);
+
+  Bytes path = {0xd9, 0x0c, 0x6a, 0x4f};
+  for (uint32_t n : {0x80000054u, 0x80000000u, 0x80000000u, 0u, 3u}) {
+    append_le(path, n, 4);
+  }
+  Bytes pubkey_key(34, 0x33);
+  pubkey_key[0] = PSBT_IN_BIP32_DERIVATION;
+  pubkey_key[1] = 0x02;
+
+  Bytes psbt = {'p', 's', 'b', 't', 0xff};
+  append_kv(psbt, {PSBT_GLOBAL_UNSIGNED_TX}, tx);
+  append_kv(psbt, {0xfc, 'k', 'k'}, Bytes(300, 'x'));
+  psbt.push_back(0);
+  append_kv(psbt, {PSBT_IN_WITNESS_UTXO}, witness_utxo);
+  append_kv(psbt, pubkey_key, path);
+  psbt.push_back(0);
+  append_kv(psbt, {PSBT_IN_WITNESS_UTXO}, witness_utxo);
+  append_kv(psbt, {PSBT_IN_SIGHASH_TYPE}, {1, 0, 0, 0});
+  psbt.push_back(0);
+  psbt.push_back(0);
+  psbt.push_back(0);
+  return psbt;
+}
+
+struct Seen {
+  std::string log;
+  Bytes value;
+};
+
+static bool on_value(void *ctx, const PsbtRecord *record, uint32_t offset,
+                     const uint8_t *data, size_t len) {
+  Seen *seen = (Seen *)ctx;
+  if (offset == 0) seen->value.clear();
+  seen->value.insert(seen->value.end(), data, data + len);
+  if (seen->value.size() == record->value_len) {
+    seen->log += "v" + std::to_string(record->map) +
+                 std::to_string(record->index) + ":" +
+                 std::to_string(record->key[0]) + ";";
+  }
+  return true;
+}
+
+static bool on_input(void *ctx, uint32_t index, const uint8_t *prev_hash,
+                     uint32_t prev_index, uint32_t sequence) {
+  Seen *seen = (Seen *)ctx;
+  seen->log += "i" + std::to_string(index) + ":" +
+               std::to_string(prev_hash[0]) + "/" +
+               std::to_string(prev_index) + ";";
+  EXPECT_EQ(0xfffffffdu, sequence);
+  return true;
+}
+
+static bool on_output(void *ctx, uint32_t index, uint64_t amount,
+                      const uint8_t *script, uint32_t script_len) {
+  Seen *seen = (Seen *)ctx;
+  seen->log += "o" + std::to_string(index) + ":" + std::to_string(amount) +
+               "/" + std::to_string(script_len) + ";";
+  return true;
+}
+
+static const PsbtCallbacks callbacks = {on_value, on_input, on_output};
+
+TEST(Psbt, Parse) {
+  const Bytes psbt = make_psbt();
+  const std::string expected =
+      "i0:170/0;i1:171/1;o0:100000/22;o1:250/0;v00:0;v00:252;"
+      "v10:1;v10:6;v11:1;v11:3;";
+
+  // In one piece
+  Seen whole;
+  PsbtParser parser;
+  psbt_init(&parser, &callbacks, &whole);
+  ASSERT_TRUE(psbt_update(&parser, psbt.data(), psbt.size()));
+  EXPECT_TRUE(psbt_isComplete(&parser));
+  EXPECT_EQ(expected, whole.log);
+  EXPECT_EQ(2u, parser.inputs_count);
+  EXPECT_EQ(2u, parser.outputs_count);
+  EXPECT_EQ(2u, parser.version);
+
+  // A byte at a time
+  Seen bytewise;
+  psbt_init(&parser, &callbacks, &bytewise);
+  for (size_t i = 0; i < psbt.size(); i++) {
+    ASSERT_TRUE(psbt_update(&parser, &psbt[i], 1));
+    EXPECT_EQ(i + 1 == psbt.size(), psbt_isComplete(&parser));
+  }
+  EXPECT_EQ(expected, bytewise.log);
+}
+
+TEST(Psbt, Malformed) {
+  const Bytes psbt = make_psbt();
+  PsbtParser parser;
+  Seen seen;
+
+  Bytes bad = psbt;
+  bad[4] = 0xfe;
+  psbt_init(&parser, &callbacks, &seen);
+  EXPECT_FALSE(psbt_update(&parser, bad.data(), bad.size()));
+
+  // Trailing data
+  bad = psbt;
+  bad.push_back(0);
+  psbt_init(&parser, &callbacks, &seen);
+  EXPECT_FALSE(psbt_update(&parser, bad.data(), bad.size()));
+  EXPECT_STREQ("Data after the last output", parser.error);
+
+  // Global map without an unsigned transaction
+  bad = {'p', 's', 'b', 't', 0xff, 0x00};
+  psbt_init(&parser, &callbacks, &seen);
+  EXPECT_FALSE(psbt_update(&parser, bad.data(), bad.size()));
+  EXPECT_STREQ("Missing unsigned transaction", parser.error);
+
+  // Unsigned transaction value one byte short
+  bad = psbt;
+  bad[6] -= 1;
+  bad.erase(bad.begin() + 7);
+  psbt_init(&parser, &callbacks, &seen);
+  EXPECT_FALSE(psbt_update(&parser, bad.data(), bad.size()));
+
+  // A failed parser stays failed
+  EXPECT_FALSE(psbt_update(&parser, psbt.data(), psbt.size()));
+
+  // Every strict prefix is incomplete
+  for (size_t len = 0; len < psbt.size(); len++) {
+    psbt_init(&parser, &callbacks, &seen);
+    psbt_update(&parser, psbt.data(), len);
+    EXPECT_FALSE(psbt_isComplete(&parser));
+  }
+}
+
+TEST(Psbt, DecodeValues) {
+  const uint8_t path[] = {0xd9, 0x0c, 0x6a, 0x4f, 0x54, 0x00, 0x00,
+                          0x80, 0x03, 0x00, 0x00, 0x00};
+  uint32_t fingerprint, address_n[4];
+  size_t count;
+  ASSERT_TRUE(psbt_decodeBip32Path(path, sizeof(path), &fingerprint,
+                                   address_n, 4, &count));
+  EXPECT_EQ(0xd90c6a4fu, fingerprint);
+  ASSERT_EQ(2u, count);
+  EXPECT_EQ(0x80000054u, address_n[0]);
+  EXPECT_EQ(3u, address_n[1]);
+  EXPECT_FALSE(psbt_decodeBip32Path(path, sizeof(path), &fingerprint,
+                                    address_n, 1, &count));
+  EXPECT_FALSE(psbt_decodeBip32Path(path, 7, &fingerprint, address_n, 4,
+                                    &count));
+
+  Bytes utxo;
+  append_le(utxo, 150000, 8);
+  utxo.push_back(p2wpkh.size());
+  append(utxo, p2wpkh);
+  uint64_t amount;
+  const uint8_t *script;
+  size_t script_len;
+  ASSERT_TRUE(psbt_decodeWitnessUtxo(utxo.data(), utxo.size(), &amount,
+                                     &script, &script_len));
+  EXPECT_EQ(150000u, amount);
+  EXPECT_EQ(p2wpkh.size(), script_len);
+  EXPECT_EQ(0, memcmp(p2wpkh.data(), script, script_len));
+  EXPECT_FALSE(psbt_decodeWitnessUtxo(utxo.data(), utxo.size() - 1, &amount,
+                                      &script, &script_len));
+}
@@ -3,6 +3,7 @@ extern "C" {
 #include "keepkey/firmware/ripple.h"
 #include "keepkey/firmware/ripple_base58.h"
 #include "trezor/crypto/hasher.h"
+#include "trezor/crypto/sha2.h"
 }
 
 #include "gtest/gtest.h"
@@ -54,12 +55,12 @@ TEST(Ripple, SerializeAddress) {
   uint8_t buffer[22];
   memset(buffer, 0, sizeof(buffer));
 
-  uint8_t *buf = buffer;
-  bool ok = true;
-  ripple_serializeAddress(&ok, &buf, buf + sizeof(buffer), &RFM_account,
+  RippleSink sink;
+  ripple_sinkInitBuffer(&sink, buffer, sizeof(buffer));
+  ripple_serializeAddress(&sink, &RFM_account,
                           "rNaqKtKrMSwpwZSzRckPf7S96DkimjkF4H");
 
-  ASSERT_TRUE(ok);
+  ASSERT_TRUE(sink.ok);
 
   EXPECT_TRUE(memcmp(buffer,
                      "\x81\x14\x8f\xb4\x0e\x1f\xfa\x5d\x55\x7c\xe9"
@@ -109,8 +110,9 @@ TEST(Ripple, Serialize) {
         "\x6c\xa8\xaa\x5e\xaa\xb8\x39\x63\x97\xae\xf6\xd3\x8d\x25\x71\x04" // s value
         "\x41\xfa\xf7\xc7\x9d\x29\x2e\xe1\xd6\x27\xdf\x15\xad\x93\x46\xc0";
 
-  uint8_t *buf = serialized;
-  EXPECT_TRUE(ripple_serialize(&buf, buf + sizeof(serialized), &tx,
+  RippleSink sink;
+  ripple_sinkInitBuffer(&sink, serialized, sizeof(serialized));
+  EXPECT_TRUE(ripple_serialize(&sink, &tx,
                                "rNaqKtKrMSwpwZSzRckPf7S96DkimjkF4H", public_key,
                                sig, sig_len));
 
@@ -127,4 +129,24 @@ TEST(Ripple, Serialize) {
         "\x78\x08\x26";
 
   ASSERT_TRUE(memcmp(serialized, expected, sizeof(serialized)) == 0);
+
+  // One byte short
+  ripple_sinkInitBuffer(&sink, serialized, sizeof(serialized) - 1);
+  EXPECT_FALSE(ripple_serialize(&sink, &tx,
+                                "rNaqKtKrMSwpwZSzRckPf7S96DkimjkF4H",
+                                public_key, sig, sig_len));
+
+  // Hashing as the fields are produced matches hashing the buffer
+  SHA512_CTX ctx;
+  sha512_Init(&ctx);
+  ripple_sinkInitHash(&sink, &ctx);
+  EXPECT_TRUE(ripple_serialize(&sink, &tx,
+                               "rNaqKtKrMSwpwZSzRckPf7S96DkimjkF4H", public_key,
+                               sig, sig_len));
+  uint8_t streamed[SHA512_DIGEST_LENGTH];
+  sha512_Final(&ctx, streamed);
+
+  uint8_t buffered[SHA512_DIGEST_LENGTH];
+  sha512_Raw(expected, sizeof(serialized), buffered);
+  EXPECT_TRUE(memcmp(streamed, buffered, sizeof(streamed)) == 0);
 }
@@ -0,0 +1,394 @@
+extern "C" {
+#include "keepkey/board/messages.h"
+#include "keepkey/firmware/coins.h"
+#include "keepkey/firmware/signing.h"
+#include "keepkey/firmware/transaction.h"
+#include "trezor/crypto/bip32.h"
+#include "trezor/crypto/curves.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+static TxRequest request;
+static int requests;
+static FailureType failure_code;
+static int failures;
+
+static void record(MessageType msg_id, const void *msg) {
+  if (msg_id == MessageType_MessageType_TxRequest) {
+    memcpy(&request, msg, sizeof(request));
+    requests++;
+  } else if (msg_id == MessageType_MessageType_Failure) {
+    failure_code = ((const Failure *)msg)->code;
+    failures++;
+  }
+}
+
+/// A previous transaction, and the hash an input spending it refers to.
+struct PrevTx {
+  TxInputType inputs[2];
+  TxOutputBinType outputs[3];
+  size_t inputs_count;
+  size_t outputs_count;
+  uint32_t lock_time;
+  uint8_t hash[32];
+};
+
+static void makePrevTx(PrevTx *prev, uint32_t tag, size_t inputs_count,
+                       size_t outputs_count) {
+  memset(prev, 0, sizeof(*prev));
+  prev->inputs_count = inputs_count;
+  prev->outputs_count = outputs_count;
+  prev->lock_time = tag;
+
+  for (size_t i = 0; i < inputs_count; i++) {
+    TxInputType *in = &prev->inputs[i];
+    in->prev_hash.size = 32;
+    memset(in->prev_hash.bytes, (uint8_t)(tag + i), 32);
+    in->prev_index = i;
+    in->script_sig.size = 4;
+    memset(in->script_sig.bytes, 0x51, 4);
+    in->sequence = 0xffffffff;
+  }
+  for (size_t i = 0; i < outputs_count; i++) {
+    TxOutputBinType *out = &prev->outputs[i];
+    out->amount = 10000 * (i + 1);
+    out->script_pubkey.size = 25;
+    memset(out->script_pubkey.bytes, 0x76 + i, 25);
+  }
+
+  TxStruct t;
+  tx_init(&t, inputs_count, outputs_count, 1, prev->lock_time, 0, 0,
+          HASHER_SHA2D, false, 0);
+  for (size_t i = 0; i < inputs_count; i++) {
+    tx_serialize_input_hash(&t, &prev->inputs[i]);
+  }
+  for (size_t i = 0; i < outputs_count; i++) {
+    tx_serialize_output_hash(&t, &prev->outputs[i]);
+  }
+  tx_hash_final(&t, prev->hash, true);
+}
+
+static const CoinType *coin;
+static HDNode root;
+
+/// Starts signing a one input, one output Bitcoin transaction.
+static void startSigning(void) {
+  set_msg_write_hook(record);
+  requests = 0;
+  failures = 0;
+
+  coin = coinByName("Bitcoin");
+  uint8_t seed[32];
+  memset(seed, 0x42, sizeof(seed));
+  ASSERT_EQ(hdnode_from_seed(seed, sizeof(seed), SECP256K1_NAME, &root), 1);
+
+  SignTx msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.inputs_count = 1;
+  msg.outputs_count = 1;
+  msg.version = 1;
+  signing_init(&msg, coin, &root);
+  ASSERT_EQ(request.request_type, RequestType_TXINPUT);
+}
+
+static void stopSigning(void) {
+  signing_abort();
+  set_msg_write_hook(nullptr);
+}
+
+static void ackInput(const PrevTx *prev, uint32_t prev_index,
+                     uint64_t amount = 0) {
+  static TransactionType tx;
+  memset(&tx, 0, sizeof(tx));
+  tx.inputs_count = 1;
+  TxInputType *in = &tx.inputs[0];
+  in->address_n_count = 5;
+  in->address_n[0] = 0x80000000 | 44;
+  in->address_n[1] = 0x80000000 | 0;
+  in->address_n[2] = 0x80000000 | 0;
+  in->address_n[3] = 0;
+  in->address_n[4] = 0;
+  in->prev_hash.size = 32;
+  memcpy(in->prev_hash.bytes, prev->hash, 32);
+  in->prev_index = prev_index;
+  in->script_type = InputScriptType_SPENDADDRESS;
+  in->sequence = 0xffffffff;
+  in->has_amount = amount != 0;
+  in->amount = amount;
+  signing_txack(&tx);
+}
+
+static void ackMeta(const PrevTx *prev) {
+  static TransactionType tx;
+  memset(&tx, 0, sizeof(tx));
+  tx.version = 1;
+  tx.lock_time = prev->lock_time;
+  tx.inputs_cnt = prev->inputs_count;
+  tx.outputs_cnt = prev->outputs_count;
+  signing_txack(&tx);
+}
+
+/// Sends prev tx inputs [first, first + inputs) and outputs
+/// [first_out, first_out + outputs) in one TxAck.
+static void ackPrev(const PrevTx *prev, size_t first, size_t inputs,
+                    size_t first_out, size_t outputs) {
+  static TransactionType tx;
+  memset(&tx, 0, sizeof(tx));
+  tx.inputs_count = inputs;
+  for (size_t i = 0; i < inputs; i++) {
+    tx.inputs[i] = prev->inputs[first + i];
+  }
+  tx.bin_outputs_count = outputs;
+  for (size_t i = 0; i < outputs; i++) {
+    tx.bin_outputs[i] = prev->outputs[first_out + i];
+  }
+  signing_txack(&tx);
+}
+
+static void expectPrevRequest(RequestType type, uint32_t index) {
+  EXPECT_EQ(failures, 0);
+  EXPECT_EQ(request.request_type, type);
+  EXPECT_TRUE(request.details.has_tx_hash);
+  EXPECT_EQ(request.details.request_index, index);
+}
+
+/// The prev tx was verified, and the first output of the new one is next.
+static void expectPrevTxDone(void) {
+  EXPECT_EQ(failures, 0);
+  EXPECT_EQ(request.request_type, RequestType_TXOUTPUT);
+  EXPECT_FALSE(request.details.has_tx_hash);
+  EXPECT_EQ(request.details.request_index, 0u);
+}
+
+static void expectUnexpectedItems(void) {
+  EXPECT_EQ(failures, 1);
+  EXPECT_EQ(failure_code, FailureType_Failure_UnexpectedMessage);
+}
+
+TEST(Signing, PrevTxOneItemPerAck) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x10, 2, 3);
+  signing_utxoCacheClear();
+  startSigning();
+
+  ackInput(&prev, 1);
+  EXPECT_EQ(request.request_type, RequestType_TXMETA);
+  ackMeta(&prev);
+  expectPrevRequest(RequestType_TXINPUT, 0);
+  ackPrev(&prev, 0, 1, 0, 0);
+  expectPrevRequest(RequestType_TXINPUT, 1);
+  ackPrev(&prev, 1, 1, 0, 0);
+  expectPrevRequest(RequestType_TXOUTPUT, 0);
+  ackPrev(&prev, 0, 0, 0, 1);
+  expectPrevRequest(RequestType_TXOUTPUT, 1);
+  ackPrev(&prev, 0, 0, 1, 1);
+  expectPrevRequest(RequestType_TXOUTPUT, 2);
+  ackPrev(&prev, 0, 0, 2, 1);
+  expectPrevTxDone();
+
+  stopSigning();
+}
+
+TEST(Signing, PrevTxBatchedOutputs) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x20, 2, 3);
+  signing_utxoCacheClear();
+  startSigning();
+
+  ackInput(&prev, 2);
+  ackMeta(&prev);
+  ackPrev(&prev, 0, 1, 0, 0);
+  ackPrev(&prev, 1, 1, 0, 0);
+  expectPrevRequest(RequestType_TXOUTPUT, 0);
+  ackPrev(&prev, 0, 0, 0, 2);
+  expectPrevRequest(RequestType_TXOUTPUT, 2);
+  ackPrev(&prev, 0, 0, 2, 1);
+  expectPrevTxDone();
+  EXPECT_EQ(requests, 7);
+
+  stopSigning();
+}
+
+TEST(Signing, PrevTxLastInputWithOutputs) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x30, 2, 3);
+  signing_utxoCacheClear();
+  startSigning();
+
+  ackInput(&prev, 0);
+  ackMeta(&prev);
+  ackPrev(&prev, 0, 1, 0, 0);
+  expectPrevRequest(RequestType_TXINPUT, 1);
+
+  // The last input and every output in one ack
+  ackPrev(&prev, 1, 1, 0, 3);
+  expectPrevTxDone();
+  EXPECT_EQ(requests, 5);
+
+  stopSigning();
+
+  // The last input and only some outputs
+  makePrevTx(&prev, 0x31, 1, 3);
+  startSigning();
+  ackInput(&prev, 0);
+  ackMeta(&prev);
+  ackPrev(&prev, 0, 1, 0, 2);
+  expectPrevRequest(RequestType_TXOUTPUT, 2);
+  ackPrev(&prev, 0, 0, 2, 1);
+  expectPrevTxDone();
+
+  stopSigning();
+}
+
+TEST(Signing, PrevTxBatchStillHashed) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x40, 1, 3);
+  signing_utxoCacheClear();
+  startSigning();
+
+  ackInput(&prev, 0);
+  ackMeta(&prev);
+  prev.outputs[1].amount++;
+  ackPrev(&prev, 0, 1, 0, 3);
+  EXPECT_EQ(failures, 1);
+  EXPECT_EQ(failure_code, FailureType_Failure_Other);
+
+  stopSigning();
+}
+
+TEST(Signing, PrevTxUnexpectedItems) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x50, 2, 2);
+  signing_utxoCacheClear();
+
+  // Outputs before the last input
+  startSigning();
+  ackInput(&prev, 0);
+  ackMeta(&prev);
+  ackPrev(&prev, 0, 1, 0, 2);
+  expectUnexpectedItems();
+  stopSigning();
+
+  // More outputs than the prev tx has left
+  startSigning();
+  ackInput(&prev, 0);
+  ackMeta(&prev);
+  ackPrev(&prev, 0, 1, 0, 0);
+  ackPrev(&prev, 1, 1, 0, 0);
+  expectPrevRequest(RequestType_TXOUTPUT, 0);
+  ackPrev(&prev, 0, 0, 0, 3);
+  expectUnexpectedItems();
+  stopSigning();
+
+  // An input where only outputs are expected
+  startSigning();
+  ackInput(&prev, 0);
+  ackMeta(&prev);
+  ackPrev(&prev, 0, 1, 0, 0);
+  ackPrev(&prev, 1, 1, 0, 0);
+  ackPrev(&prev, 0, 0, 0, 1);
+  expectPrevRequest(RequestType_TXOUTPUT, 1);
+  ackPrev(&prev, 1, 1, 1, 1);
+  expectUnexpectedItems();
+  stopSigning();
+}
+
+/// Signs up to the point where the prev tx spent by \p prev_index is verified.
+static void verifyPrevTx(const PrevTx *prev, uint32_t prev_index) {
+  startSigning();
+  ackInput(prev, prev_index);
+  ASSERT_EQ(request.request_type, RequestType_TXMETA);
+  ackMeta(prev);
+  for (size_t i = 0; i < prev->inputs_count; i++) {
+    ackPrev(prev, i, 1, 0, 0);
+  }
+  for (size_t i = 0; i < prev->outputs_count; i++) {
+    ackPrev(prev, 0, 0, i, 1);
+  }
+  expectPrevTxDone();
+  stopSigning();
+}
+
+/// Whether the input was taken from the cache, skipping the prev tx stream.
+static bool inputIsCached(const PrevTx *prev, uint32_t prev_index,
+                          uint64_t amount = 0) {
+  startSigning();
+  ackInput(prev, prev_index, amount);
+  EXPECT_EQ(failures, 0);
+  const bool cached = request.request_type == RequestType_TXOUTPUT &&
+                      !request.details.has_tx_hash;
+  if (!cached) {
+    EXPECT_EQ(request.request_type, RequestType_TXMETA);
+  }
+  stopSigning();
+  return cached;
+}
+
+TEST(Signing, UtxoCacheHit) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x100, 1, 2);
+  signing_utxoCacheClear();
+
+  EXPECT_FALSE(inputIsCached(&prev, 1));
+  verifyPrevTx(&prev, 1);
+
+  // A later transaction spending the same output skips the prev tx
+  EXPECT_TRUE(inputIsCached(&prev, 1));
+  EXPECT_TRUE(inputIsCached(&prev, 1, prev.outputs[1].amount));
+
+  signing_utxoCacheClear();
+}
+
+TEST(Signing, UtxoCacheMismatch) {
+  PrevTx prev, other;
+  makePrevTx(&prev, 0x200, 1, 2);
+  makePrevTx(&other, 0x201, 1, 2);
+  signing_utxoCacheClear();
+  verifyPrevTx(&prev, 1);
+
+  // Another output of the same tx, or the same index of another tx
+  EXPECT_FALSE(inputIsCached(&prev, 0));
+  EXPECT_FALSE(inputIsCached(&other, 1));
+
+  // A different amount claimed by the host is checked against the prev tx
+  EXPECT_FALSE(inputIsCached(&prev, 1, prev.outputs[1].amount + 1));
+
+  EXPECT_TRUE(inputIsCached(&prev, 1));
+  signing_utxoCacheClear();
+}
+
+TEST(Signing, UtxoCacheEviction) {
+  static PrevTx prev[SIGNING_UTXO_CACHE_SIZE + 1];
+  signing_utxoCacheClear();
+  for (size_t i = 0; i < SIGNING_UTXO_CACHE_SIZE + 1; i++) {
+    makePrevTx(&prev[i], 0x300 + i, 1, 1);
+    verifyPrevTx(&prev[i], 0);
+  }
+
+  // The oldest entry made room for the last one
+  EXPECT_FALSE(inputIsCached(&prev[0], 0));
+  for (size_t i = 1; i < SIGNING_UTXO_CACHE_SIZE + 1; i++) {
+    EXPECT_TRUE(inputIsCached(&prev[i], 0)) << i;
+  }
+
+  signing_utxoCacheClear();
+}
+
+TEST(Signing, UtxoCacheCleared) {
+  PrevTx prev;
+  makePrevTx(&prev, 0x400, 1, 1);
+  signing_utxoCacheClear();
+  verifyPrevTx(&prev, 0);
+  EXPECT_TRUE(inputIsCached(&prev, 0));
+
+  // session_clear forgets every verified output
+  signing_utxoCacheClear();
+  EXPECT_FALSE(inputIsCached(&prev, 0));
+  verifyPrevTx(&prev, 0);
+  EXPECT_TRUE(inputIsCached(&prev, 0));
+
+  signing_utxoCacheClear();
+}
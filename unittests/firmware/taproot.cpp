@@ -0,0 +1,73 @@
+extern "C" {
+#include "keepkey/firmware/taproot.h"
+}
+
+#include "gtest/gtest.h"
+#include <string>
+
+static std::string to_hex(const uint8_t *buf, size_t size) {
+  static const char *ALPHABET = "0123456789abcdef";
+  std::string hex;
+  for (size_t i = 0; i < size; i++) {
+    hex.push_back(ALPHABET[buf[i] >> 4]);
+    hex.push_back(ALPHABET[buf[i] & 15]);
+  }
+  return hex;
+}
+
+static void from_hex(const std::string &hex, uint8_t *out) {
+  for (size_t i = 0; i < hex.size() / 2; i++) {
+    out[i] = std::stoi(hex.substr(2 * i, 2), nullptr, 16);
+  }
+}
+
+TEST(Taproot, SchnorrSign) {
+  // BIP340 test vector 0
+  uint8_t private_key[32] = {0}, digest[32] = {0}, aux[32] = {0}, sig[64];
+  private_key[31] = 3;
+  ASSERT_TRUE(taproot_schnorrSign(private_key, digest, aux, sig));
+  EXPECT_EQ(
+      "e907831f80848d1069a5371b402410364bdf1c5f8307b0084c55f1ce2dca8215"
+      "25f66a4a85ea8b71e482a74f382d2ce5ebeee8fdb2172f477df4900d310536c0",
+      to_hex(sig, sizeof(sig)));
+
+  uint8_t zero[32] = {0};
+  EXPECT_FALSE(taproot_schnorrSign(zero, digest, aux, sig));
+}
+
+TEST(Taproot, TweakPublicKey) {
+  // BIP86: m/86'/0'/0'/0/0 of the "abandon ... about" mnemonic
+  uint8_t public_key[33], output_key[32];
+  from_hex("02cc8a4bc64d897bddc5fbc2f670f7a8ba0b386779106cf1223c6fc5d7cd6fc115",
+           public_key);
+  ASSERT_TRUE(taproot_tweakPublicKey(public_key, output_key));
+  EXPECT_EQ("a60869f0dbcf1dc659c9cecbaf8050135ea9e8cdc487053f1dc6880949dc684c",
+            to_hex(output_key, sizeof(output_key)));
+
+  // Only the x coordinate of the internal key matters
+  public_key[0] = 0x03;
+  ASSERT_TRUE(taproot_tweakPublicKey(public_key, output_key));
+  EXPECT_EQ("a60869f0dbcf1dc659c9cecbaf8050135ea9e8cdc487053f1dc6880949dc684c",
+            to_hex(output_key, sizeof(output_key)));
+}
+
+TEST(Taproot, TweakPrivateKey) {
+  uint8_t private_key[32] = {0}, tweaked[32], digest[32] = {0}, aux[32] = {0};
+  uint8_t sig[64];
+  private_key[31] = 1;
+  ASSERT_TRUE(taproot_tweakPrivateKey(private_key, tweaked));
+  ASSERT_TRUE(taproot_schnorrSign(tweaked, digest, aux, sig));
+
+  // The nonce commits to the output key of G, i.e. da4710...4d21
+  EXPECT_EQ(
+      "77f6e95e8aa79ab1b1a20f04b0fbc3dd60c5e8d128a0a48a54a0423b2d6f7d8c"
+      "4007b87d09d923f9d09a917501f52e288045c717585ae1970c2d27d779be3d90",
+      to_hex(sig, sizeof(sig)));
+
+  uint8_t public_key[33], output_key[32];
+  from_hex("0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",
+           public_key);
+  ASSERT_TRUE(taproot_tweakPublicKey(public_key, output_key));
+  EXPECT_EQ("da4710964f7852695de2da025290e24af6d8c281de5a0b902b7135fd9fd74d21",
+            to_hex(output_key, sizeof(output_key)));
+}
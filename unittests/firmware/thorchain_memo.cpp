@@ -0,0 +1,105 @@
+extern "C" {
+#include "keepkey/firmware/thorchain_memo.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+
+static std::string view(MemoView v) { return std::string(v.ptr, v.len); }
+
+TEST(Thorchain, MemoParse) {
+  ThorchainMemo memo;
+  const char *swap = "=:ETH.USDT-0xdac17f958d2ee523a2206206994597c13d831ec7:"
+                     "0x41e5560054824ea6b0732e656e3ad64e20e94e45:420/3/0:t:15";
+  ASSERT_TRUE(thorchain_memoParse(swap, strlen(swap), &memo));
+  EXPECT_EQ(memo.action, ThorchainMemo_Swap);
+  EXPECT_EQ(view(memo.chain), "ETH");
+  EXPECT_EQ(view(memo.asset), "USDT-0xdac17f958d2ee523a2206206994597c13d831ec7");
+  EXPECT_EQ(view(memo.dest), "0x41e5560054824ea6b0732e656e3ad64e20e94e45");
+  EXPECT_EQ(view(memo.limit), "420");
+  EXPECT_EQ(view(memo.interval), "3");
+  EXPECT_EQ(view(memo.quantity), "0");
+  EXPECT_EQ(view(memo.affiliate), "t");
+  EXPECT_EQ(view(memo.fee), "15");
+
+  // Swap to self, no limit
+  const char *self = "SWAP:BTC.BTC";
+  ASSERT_TRUE(thorchain_memoParse(self, strlen(self), &memo));
+  EXPECT_EQ(memo.dest.len, 0u);
+  EXPECT_EQ(memo.limit.len, 0u);
+
+  const char *withdraw = "wd:BNB.BNB:5000";
+  ASSERT_TRUE(thorchain_memoParse(withdraw, strlen(withdraw), &memo));
+  EXPECT_EQ(memo.action, ThorchainMemo_Withdraw);
+  EXPECT_EQ(view(memo.limit), "5000");
+
+  // Withdraw needs basis points
+  EXPECT_FALSE(thorchain_memoParse("-:BNB.BNB", 9, &memo));
+  // Keywords must match exactly, not just by prefix
+  EXPECT_FALSE(thorchain_memoParse("SWAPX:BTC.BTC", 13, &memo));
+  EXPECT_FALSE(thorchain_memoParse("sell:BTC.BTC", 12, &memo));
+  // Asset needs both chain and symbol
+  EXPECT_FALSE(thorchain_memoParse("SWAP:BTC", 8, &memo));
+  EXPECT_FALSE(thorchain_memoParse("", 0, &memo));
+}
+
+TEST(Thorchain, MemoParseUnshownFields) {
+  ThorchainMemo memo;
+  // Fields past what the confirm screens show fall back to the raw memo
+  const char *swap = "=:BTC.BTC:bc1qdest:1000/1/0:t:15:extra";
+  EXPECT_FALSE(thorchain_memoParse(swap, strlen(swap), &memo));
+  const char *add = "+:BTC.BTC:thor1paired:t:15:extra";
+  EXPECT_FALSE(thorchain_memoParse(add, strlen(add), &memo));
+  const char *repay = "$-:BTC.BTC:bc1qowner:1000:extra";
+  EXPECT_FALSE(thorchain_memoParse(repay, strlen(repay), &memo));
+  const char *many = "=:BTC.BTC:bc1qdest:1000:t:15:a:b:c";
+  EXPECT_FALSE(thorchain_memoParse(many, strlen(many), &memo));
+  // A fee without an affiliate, or a fourth streaming parameter
+  const char *fee = "=:BTC.BTC:bc1qdest:1000::15";
+  EXPECT_FALSE(thorchain_memoParse(fee, strlen(fee), &memo));
+  const char *stream = "=:BTC.BTC:bc1qdest:1000/1/0/9";
+  EXPECT_FALSE(thorchain_memoParse(stream, strlen(stream), &memo));
+
+}
+
+TEST(Thorchain, MemoParseLength) {
+  ThorchainMemo memo;
+  // 256 bytes are parsed in full
+  std::string longest = "=:BTC.BTC:" + std::string(246, 'a');
+  ASSERT_EQ(longest.size(), 256u);
+  ASSERT_TRUE(thorchain_memoParse(longest.c_str(), longest.size(), &memo));
+  EXPECT_EQ(memo.dest.len, 246u);
+  // Also from a larger, NUL padded buffer
+  char buf[300] = {0};
+  memcpy(buf, longest.data(), longest.size());
+  EXPECT_TRUE(thorchain_memoParse(buf, sizeof(buf), &memo));
+
+  // 257 bytes are left for the caller to confirm raw
+  std::string too_long = longest + "a";
+  EXPECT_FALSE(thorchain_memoParse(too_long.c_str(), too_long.size(), &memo));
+  memcpy(buf, too_long.data(), too_long.size());
+  EXPECT_FALSE(thorchain_memoParse(buf, sizeof(buf), &memo));
+}
+
+TEST(Thorchain, MemoParseWithdraw) {
+  ThorchainMemo memo;
+  const char *withdraw = "WITHDRAW:BTC.BTC:10000:THOR.RUNE";
+  ASSERT_TRUE(thorchain_memoParse(withdraw, strlen(withdraw), &memo));
+  EXPECT_EQ(view(memo.limit), "10000");
+  EXPECT_EQ(view(memo.withdraw_asset), "THOR.RUNE");
+
+  const char *extra = "WITHDRAW:BTC.BTC:10000:THOR.RUNE:extra";
+  EXPECT_FALSE(thorchain_memoParse(extra, strlen(extra), &memo));
+  // More than 100%
+  const char *over = "wd:BTC.BTC:10001";
+  EXPECT_FALSE(thorchain_memoParse(over, strlen(over), &memo));
+  // Over-long and non-numeric basis points are not truncated
+  const char *overflow = "wd:BTC.BTC:4294967296";
+  EXPECT_FALSE(thorchain_memoParse(overflow, strlen(overflow), &memo));
+  const char *digits = "wd:BTC.BTC:00000000000000000000005000";
+  ASSERT_TRUE(thorchain_memoParse(digits, strlen(digits), &memo));
+  const char *suffix = "wd:BTC.BTC:5000abc";
+  EXPECT_FALSE(thorchain_memoParse(suffix, strlen(suffix), &memo));
+}
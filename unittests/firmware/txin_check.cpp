@@ -0,0 +1,73 @@
+extern "C" {
+#include "trezor/crypto/sha2.h"
+#include "keepkey/firmware/txin_check.h"
+}
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef std::pair<std::string, std::string> Output;  // amount, address
+
+// Runs the duplicate check the way signing does: the inputs are hashed, the
+// digest is finalized when the first output arrives, then every confirmed
+// output is compared and saved. Returns the number of warnings.
+static int signTx(const std::vector<std::string> &inputs,
+                  const std::vector<Output> &outputs) {
+  for (const std::string &prev_hash : inputs) {
+    txin_dgst_addto((const uint8_t *)prev_hash.data(), prev_hash.size());
+  }
+  txin_dgst_final();
+
+  int warnings = 0;
+  for (const Output &output : outputs) {
+    char amount[AMT_STR_LEN] = {0}, address[ADDR_STR_LEN] = {0};
+    strncpy(amount, output.first.c_str(), sizeof(amount) - 1);
+    strncpy(address, output.second.c_str(), sizeof(address) - 1);
+    if (txin_dgst_compare(amount, address)) {
+      warnings++;
+    }
+    txin_dgst_save_and_reset(amount, address);
+  }
+  return warnings;
+}
+
+static const Output out_a = {"0.1 BTC", "1BoatSLRHtKNngkdXEeobR76b53LETtpyT"};
+static const Output out_b = {"0.2 BTC", "1KKKK6N21XKo48zWKuQKXdvSsCf95ibHFa"};
+static const Output out_c = {"0.3 BTC", "1LdRcdxfbSnmCYYNdeYpUnztiYzVfBEQeC"};
+
+TEST(TxinCheck, SingleOutput) {
+  txin_dgst_initialize();
+  EXPECT_EQ(signTx({"input 1"}, {out_a}), 0);
+  // Same output, other inputs
+  EXPECT_EQ(signTx({"input 2"}, {out_a}), 1);
+  // The same tx again
+  txin_dgst_initialize();
+  EXPECT_EQ(signTx({"input 1"}, {out_a}), 0);
+  EXPECT_EQ(signTx({"input 1"}, {out_a}), 0);
+}
+
+TEST(TxinCheck, MultiOutputFires) {
+  txin_dgst_initialize();
+  EXPECT_EQ(signTx({"input 1", "input 2"}, {out_a, out_b}), 0);
+  // Last output repeated with other inputs, behind a different first output
+  EXPECT_EQ(signTx({"input 3"}, {out_c, out_b}), 1);
+
+  txin_dgst_initialize();
+  EXPECT_EQ(signTx({"input 1", "input 2"}, {out_a, out_b}), 0);
+  // One input swapped
+  EXPECT_EQ(signTx({"input 1", "input 3"}, {out_b}), 1);
+}
+
+TEST(TxinCheck, MultiOutputNoFalseWarning) {
+  txin_dgst_initialize();
+  // An output repeated within one tx is not a duplicate tx
+  EXPECT_EQ(signTx({"input 1"}, {out_a, out_a, out_b}), 0);
+  // Re-signing the same multi-output tx
+  EXPECT_EQ(signTx({"input 1"}, {out_a, out_a, out_b}), 0);
+  // Unrelated outputs
+  EXPECT_EQ(signTx({"input 2"}, {out_c, out_a}), 0);
+}
@@ -1,7 +1,9 @@
 extern "C" {
 #include "keepkey/board/messages.h"
 #include "keepkey/board/usb.h"
+#include "keepkey/board/util.h"
 #include "keepkey/firmware/fsm.h"
+#include "pb_encode.h"
 }
 
 #include "gtest/gtest.h"
@@ -16,6 +18,7 @@ static std::string message;
 
 static void setup() {
   failure_count = 0;
+  usb_rx_reset();
 
   set_msg_failure_handler(+[](FailureType code, const char *text) {
     failure_count++;
@@ -94,3 +97,78 @@ TEST(USBRX, ErrorHandling) {
   ASSERT_EQ(failure_count, 4);
   ASSERT_EQ(message, "Unknown message");
 }
+
+static void send_frames(const uint8_t *data, size_t len, uint16_t msg_id) {
+  uint8_t msg[64];
+  memset(msg, 0, sizeof(msg));
+  msg[0] = '?';
+  msg[1] = '#';
+  msg[2] = '#';
+  msg[3] = msg_id >> 8;
+  msg[4] = msg_id & 0xff;
+  msg[5] = len >> 24;
+  msg[6] = len >> 16;
+  msg[7] = len >> 8;
+  msg[8] = len & 0xff;
+
+  size_t pos = MIN(len, sizeof(msg) - 9);
+  memcpy(&msg[9], data, pos);
+  usb_rx_helper(&msg, sizeof(msg), NORMAL_MSG);
+
+  while (pos < len) {
+    size_t chunk = MIN(len - pos, sizeof(msg) - 1);
+    memset(msg, 0, sizeof(msg));
+    msg[0] = '?';
+    memcpy(&msg[1], &data[pos], chunk);
+    usb_rx_helper(&msg, sizeof(msg), NORMAL_MSG);
+    pos += chunk;
+  }
+}
+
+TEST(USBRX, MultiItemTxAck) {
+  fsm_init();
+  setup();
+
+  static TxAck ack;
+  memset(&ack, 0, sizeof(ack));
+  ack.has_tx = true;
+  ack.tx.bin_outputs_count =
+      sizeof(ack.tx.bin_outputs) / sizeof(ack.tx.bin_outputs[0]);
+  ASSERT_GT(ack.tx.bin_outputs_count, 1u);
+  for (size_t i = 0; i < ack.tx.bin_outputs_count; i++) {
+    TxOutputBinType *out = &ack.tx.bin_outputs[i];
+    out->amount = 1000 * (i + 1);
+    out->script_pubkey.size = 25;
+    memset(out->script_pubkey.bytes, 0x76 + i, 25);
+  }
+
+  // Encode the transaction on its own, so that more outputs than the struct
+  // can hold may be appended to it.
+  static uint8_t tx[4096];
+  pb_ostream_t tx_os = pb_ostream_from_buffer(tx, sizeof(tx));
+  ASSERT_TRUE(pb_encode(&tx_os, TransactionType_fields, &ack.tx));
+  const size_t tx_len = tx_os.bytes_written;
+
+  static uint8_t buf[4096];
+  pb_ostream_t os = pb_ostream_from_buffer(buf, sizeof(buf));
+  ASSERT_TRUE(pb_encode_tag(&os, PB_WT_STRING, TxAck_tx_tag));
+  ASSERT_TRUE(pb_encode_string(&os, tx, tx_len));
+
+  // Every prev tx output in the ack decodes. There is no signing in
+  // progress, so the ack itself is then turned away by the signer.
+  send_frames(buf, os.bytes_written, MessageType_MessageType_TxAck);
+  EXPECT_EQ(failure_count, 0);
+
+  // One output more than the decode limit is rejected by the transport.
+  ASSERT_TRUE(pb_encode_tag(&tx_os, PB_WT_STRING, TransactionType_bin_outputs_tag));
+  ASSERT_TRUE(pb_encode_submessage(&tx_os, TxOutputBinType_fields,
+                                   &ack.tx.bin_outputs[0]));
+
+  os = pb_ostream_from_buffer(buf, sizeof(buf));
+  ASSERT_TRUE(pb_encode_tag(&os, PB_WT_STRING, TxAck_tx_tag));
+  ASSERT_TRUE(pb_encode_string(&os, tx, tx_os.bytes_written));
+
+  send_frames(buf, os.bytes_written, MessageType_MessageType_TxAck);
+  EXPECT_EQ(failure_count, 1);
+  EXPECT_EQ(message, "Could not parse protocol buffer message");
+}
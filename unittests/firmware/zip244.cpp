@@ -0,0 +1,116 @@
+extern "C" {
+#include "keepkey/firmware/zip244.h"
+}
+
+#include "gtest/gtest.h"
+#include <string>
+
+static std::string to_hex(const uint8_t *buf, size_t size) {
+  static const char *ALPHABET = "0123456789abcdef";
+  std::string hex;
+  for (size_t i = 0; i < size; i++) {
+    hex.push_back(ALPHABET[buf[i] >> 4]);
+    hex.push_back(ALPHABET[buf[i] & 15]);
+  }
+  return hex;
+}
+
+static std::string from_hex(const std::string &hex) {
+  std::string out;
+  for (size_t i = 0; i < hex.size() / 2; i++) {
+    out.push_back((char)std::stoi(hex.substr(2 * i, 2), nullptr, 16));
+  }
+  return out;
+}
+
+static std::string le(uint64_t value, size_t size) {
+  std::string out;
+  for (size_t i = 0; i < size; i++) out.push_back((char)(value >> (8 * i)));
+  return out;
+}
+
+static void blake2b(const char *personal, const std::string &data,
+                    uint8_t hash[32]) {
+  Hasher hasher;
+  hasher_InitParam(&hasher, HASHER_BLAKE2B_PERSONAL, personal, 16);
+  hasher_Update(&hasher, (const uint8_t *)data.data(), data.size());
+  hasher_Final(&hasher, hash);
+}
+
+struct Input {
+  std::string prev_hash;  // serialized byte order
+  uint32_t prev_index;
+  uint64_t amount;
+  std::string script_pubkey;  // with its length prefix
+  uint32_t sequence;
+};
+
+TEST(Zip244, TransparentSigHashAll) {
+  // NU5 transaction with two transparent inputs (P2PKH, P2SH) and two
+  // outputs, and no shielded parts. The expected digests were computed
+  // independently from the ZIP-244 specification with Python's
+  // hashlib.blake2b.
+  std::string p2pkh = from_hex("1976a914000102030405060708090a0b0c0d0e0f1011"
+                               "121388ac");
+  std::string p2sh = from_hex("17a914141516171819"
+                              "1a1b1c1d1e1f202122232425262787");
+  const Input inputs[] = {
+      {from_hex("8f5e3d2c1b0a99887766554433221100"
+                "ffeeddccbbaa99887766554433221101"),
+       1, 150000000, p2pkh, 0xffffffff},
+      {from_hex("00112233445566778899aabbccddeeff"
+                "00112233445566778899aabbccddeeff"),
+       0, 25000000, p2sh, 0xfffffffe},
+  };
+  std::string outputs =
+      le(100000000, 8) +
+      from_hex("1976a91428292a2b2c2d2e2f303132333435363738393a3b88ac") +
+      le(74990000, 8) +
+      from_hex("17a9143c3d3e3f404142434445464748494a4b4c4d4e4f87");
+
+  std::string prevouts, amounts, scripts, sequences;
+  for (const Input &input : inputs) {
+    prevouts += input.prev_hash + le(input.prev_index, 4);
+    amounts += le(input.amount, 8);
+    scripts += input.script_pubkey;
+    sequences += le(input.sequence, 4);
+  }
+
+  uint8_t hash_prevouts[32], hash_amounts[32], hash_scripts[32],
+      hash_sequences[32], hash_outputs[32];
+  blake2b("ZTxIdPrevoutHash", prevouts, hash_prevouts);
+  blake2b("ZTxTrAmountsHash", amounts, hash_amounts);
+  blake2b("ZTxTrScriptsHash", scripts, hash_scripts);
+  blake2b("ZTxIdSequencHash", sequences, hash_sequences);
+  blake2b("ZTxIdOutputsHash", outputs, hash_outputs);
+  EXPECT_EQ("ee843f672be3915b58441331f21b55628a84e584dd9ac29133f06aced792b70f",
+            to_hex(hash_prevouts, 32));
+
+  Zip244 zip244;
+  zip244_init(&zip244, 5, 0x26A7270A, 0xC2D6D0B4, 0, 2000000);
+  zip244_transparent(&zip244, 1 /* SIGHASH_ALL */, hash_prevouts,
+                     hash_amounts, hash_scripts, hash_sequences,
+                     hash_outputs);
+
+  const char *expected_txin[] = {
+      "8e34b0cfb4ea7b20404adb7642759d83f0744f5ad7da028621c98008c2ee4108",
+      "3e02198ee52eb2ade0a6d85ce4288461e977f4c07562395b8f099a20db410481",
+  };
+  const char *expected_sighash[] = {
+      "aec3f7baf38fc36c3d50f3393d444504713130ded1cf2b08d653413c68ea8d91",
+      "2478545e7eee75e5c5b30a5271c54cf4fdef54141e6c053a450bf65769030dd8",
+  };
+
+  for (size_t i = 0; i < 2; i++) {
+    const Input &input = inputs[i];
+    uint8_t txin[32], sighash[32];
+    zip244_txin((const uint8_t *)input.prev_hash.data(), input.prev_index,
+                input.amount, (const uint8_t *)input.script_pubkey.data(),
+                input.script_pubkey.size(), input.sequence, txin);
+    EXPECT_EQ(expected_txin[i], to_hex(txin, 32));
+
+    // The midstates are shared, so signing one input leaves them intact.
+    zip244_sigDigest(&zip244, txin, sighash);
+    EXPECT_EQ(expected_sighash[i], to_hex(sighash, 32));
+  }
+}